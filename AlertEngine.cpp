@@ -0,0 +1,682 @@
+#include "AlertEngine.h"
+#include "MeterRegistry.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+
+namespace {
+
+// '*' matches any run of characters
+bool matchPattern(std::string_view pattern, std::string_view name) {
+    size_t p = 0;
+    size_t n = 0;
+    size_t star = std::string_view::npos;
+    size_t resume = 0;
+    while (n < name.size()) {
+        if (p < pattern.size() && pattern[p] == '*') {
+            star = p++;
+            resume = n;
+        } else if (p < pattern.size() && pattern[p] == name[n]) {
+            ++p;
+            ++n;
+        } else if (star != std::string_view::npos) {
+            p = star + 1;
+            n = ++resume;
+        } else {
+            return false;
+        }
+    }
+    while (p < pattern.size() && pattern[p] == '*') {
+        ++p;
+    }
+    return p == pattern.size();
+}
+
+// The meter and collector a series belongs to, from its leading word
+// ("cpu3.user" -> cpu, "load.5" -> system info)
+void classifySeries(std::string_view name, uint32_t& meters, uint32_t& subsystems) {
+    size_t length = 0;
+    while (length < name.size() && std::isalpha(static_cast<unsigned char>(name[length]))) {
+        ++length;
+    }
+    const std::string_view prefix = name.substr(0, length);
+    if (const MeterInfo* info = findMeter(prefix)) {
+        meters |= 1u << static_cast<uint32_t>(info->kind);
+        subsystems |= info->subsystems;
+    } else if (prefix == "load" || prefix == "proc") {
+        subsystems |= SUBSYSTEM_SYSTEM_INFO;
+    }
+}
+
+bool truthy(double value) {
+    return value != 0.0 && !std::isnan(value);
+}
+
+} // namespace
+
+class AlertEngine::Parser {
+public:
+    // Nodes go to nodes, numbered from base (the engine's node count)
+    Parser(std::vector<Node>& nodes, size_t base, std::string_view text)
+        : nodes_(nodes), base_(base), text_(text) {}
+
+    // Rule body after "name:"; returns false with error_ set
+    bool parseRule(Rule& rule) {
+        rule.condition = parseOr();
+        if (rule.condition < 0) {
+            return false;
+        }
+        if (acceptWord("for")) {
+            if (!parseDuration(rule.durationMs)) {
+                return false;
+            }
+        }
+        if (acceptWord("clear")) {
+            rule.clear = parseOr();
+            if (rule.clear < 0) {
+                return false;
+            }
+        }
+        skipSpace();
+        if (pos_ < text_.size()) {
+            return fail("unexpected '" + std::string(text_.substr(pos_)) + "'");
+        }
+        rule.meters = meters_;
+        return true;
+    }
+
+    const std::string& error() const { return error_; }
+    uint32_t subsystems() const { return subsystems_; }
+
+private:
+    std::vector<Node>& nodes_;
+    size_t base_;
+    std::string_view text_;
+    size_t pos_ = 0;
+    std::string error_;
+    uint32_t meters_ = 0;
+    uint32_t subsystems_ = 0;
+
+    bool fail(const std::string& message) {
+        if (error_.empty()) {
+            error_ = message;
+        }
+        return false;
+    }
+
+    void skipSpace() {
+        while (pos_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[pos_]))) {
+            ++pos_;
+        }
+    }
+
+    // '*' is multiplication except inside an aggregate's pattern
+    static bool isNameChar(char c, bool pattern) {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '.' || (pattern && c == '*');
+    }
+
+    std::string_view peekWord(bool pattern = false) {
+        skipSpace();
+        size_t end = pos_;
+        while (end < text_.size() && isNameChar(text_[end], pattern)) {
+            ++end;
+        }
+        return text_.substr(pos_, end - pos_);
+    }
+
+    bool acceptWord(std::string_view word) {
+        if (peekWord() != word) {
+            return false;
+        }
+        pos_ += word.size();
+        return true;
+    }
+
+    bool accept(std::string_view symbol) {
+        skipSpace();
+        if (text_.substr(pos_, symbol.size()) != symbol) {
+            return false;
+        }
+        pos_ += symbol.size();
+        return true;
+    }
+
+    int add(NodeType type, int left = -1, int right = -1) {
+        Node node;
+        node.type = type;
+        node.left = left;
+        node.right = right;
+        nodes_.push_back(std::move(node));
+        return static_cast<int>(base_ + nodes_.size() - 1);
+    }
+
+    Node& nodeAt(int index) { return nodes_[static_cast<size_t>(index) - base_]; }
+
+    int parseOr() {
+        int left = parseAnd();
+        while (left >= 0 && (acceptWord("or") || accept("||"))) {
+            const int right = parseAnd();
+            left = right < 0 ? -1 : add(NodeType::Or, left, right);
+        }
+        return left;
+    }
+
+    int parseAnd() {
+        int left = parseNot();
+        while (left >= 0 && (acceptWord("and") || accept("&&"))) {
+            const int right = parseNot();
+            left = right < 0 ? -1 : add(NodeType::And, left, right);
+        }
+        return left;
+    }
+
+    int parseNot() {
+        skipSpace();
+        if (acceptWord("not") || (text_.substr(pos_, 2) != "!=" && accept("!"))) {
+            const int operand = parseNot();
+            return operand < 0 ? -1 : add(NodeType::Not, operand);
+        }
+        return parseComparison();
+    }
+
+    int parseComparison() {
+        const int left = parseSum();
+        if (left < 0) {
+            return -1;
+        }
+        static const std::pair<const char*, NodeType> operators[] = {
+            {">=", NodeType::GreaterEqual}, {"<=", NodeType::LessEqual}, {"==", NodeType::Equal},
+            {"!=", NodeType::NotEqual}, {">", NodeType::Greater}, {"<", NodeType::Less},
+        };
+        for (const auto& [symbol, type] : operators) {
+            if (accept(symbol)) {
+                const int right = parseSum();
+                return right < 0 ? -1 : add(type, left, right);
+            }
+        }
+        return left;
+    }
+
+    int parseSum() {
+        int left = parseProduct();
+        while (left >= 0) {
+            NodeType type;
+            if (accept("+")) {
+                type = NodeType::Add;
+            } else if (accept("-")) {
+                type = NodeType::Subtract;
+            } else {
+                break;
+            }
+            const int right = parseProduct();
+            left = right < 0 ? -1 : add(type, left, right);
+        }
+        return left;
+    }
+
+    int parseProduct() {
+        int left = parseUnary();
+        while (left >= 0) {
+            NodeType type;
+            if (accept("*")) {
+                type = NodeType::Multiply;
+            } else if (accept("/")) {
+                type = NodeType::Divide;
+            } else {
+                break;
+            }
+            const int right = parseUnary();
+            left = right < 0 ? -1 : add(type, left, right);
+        }
+        return left;
+    }
+
+    int parseUnary() {
+        if (accept("-")) {
+            const int operand = parseUnary();
+            return operand < 0 ? -1 : add(NodeType::Negate, operand);
+        }
+        return parseAtom();
+    }
+
+    int seriesNode(NodeType type, std::string_view name) {
+        const int node = add(type);
+        nodeAt(node).name = std::string(name);
+        classifySeries(name, meters_, subsystems_);
+        return node;
+    }
+
+    int parseAtom() {
+        skipSpace();
+        if (accept("(")) {
+            const int inner = parseOr();
+            if (inner >= 0 && !accept(")")) {
+                fail("expected ')'");
+                return -1;
+            }
+            return inner;
+        }
+
+        if (pos_ < text_.size() && (std::isdigit(static_cast<unsigned char>(text_[pos_])) || text_[pos_] == '.')) {
+            const std::string number(text_.substr(pos_, 64));
+            char* end = nullptr;
+            const double value = std::strtod(number.c_str(), &end);
+            if (end == number.c_str()) {
+                fail("bad number");
+                return -1;
+            }
+            pos_ += static_cast<size_t>(end - number.c_str());
+            accept("%");
+            const int node = add(NodeType::Number);
+            nodeAt(node).number = value;
+            return node;
+        }
+
+        const std::string_view word = peekWord();
+        if (word.empty()) {
+            fail(pos_ < text_.size() ? "unexpected '" + std::string(1, text_[pos_]) + "'" : "expression expected");
+            return -1;
+        }
+        if (word == "and" || word == "or" || word == "not" || word == "for" || word == "clear") {
+            fail("'" + std::string(word) + "' where a value was expected");
+            return -1;
+        }
+        pos_ += word.size();
+
+        if (!accept("(")) {
+            return seriesNode(NodeType::Series, word);
+        }
+
+        static const std::pair<const char*, NodeType> functions[] = {
+            {"rate", NodeType::Rate}, {"delta", NodeType::Delta}, {"max", NodeType::Max},
+            {"min", NodeType::Min}, {"avg", NodeType::Avg}, {"sum", NodeType::Sum},
+        };
+        for (const auto& [function, type] : functions) {
+            if (word != function) {
+                continue;
+            }
+            const bool aggregate = type != NodeType::Rate && type != NodeType::Delta;
+            const std::string_view argument = peekWord(aggregate);
+            pos_ += argument.size();
+            if (argument.empty() || !accept(")")) {
+                fail(std::string(function) + "() takes one series name");
+                return -1;
+            }
+            return seriesNode(type, argument);
+        }
+        fail("unknown function '" + std::string(word) + "'");
+        return -1;
+    }
+
+    bool parseDuration(int64_t& durationMs) {
+        skipSpace();
+        const std::string number(text_.substr(pos_, 32));
+        char* end = nullptr;
+        const double value = std::strtod(number.c_str(), &end);
+        if (end == number.c_str() || value < 0) {
+            return fail("bad duration");
+        }
+        pos_ += static_cast<size_t>(end - number.c_str());
+
+        double scale = 1000.0;
+        if (accept("ms")) {
+            scale = 1.0;
+        } else if (accept("s")) {
+            scale = 1000.0;
+        } else if (accept("m")) {
+            scale = 60000.0;
+        } else if (accept("h")) {
+            scale = 3600000.0;
+        }
+        durationMs = static_cast<int64_t>(value * scale);
+        return true;
+    }
+};
+
+bool AlertEngine::parse(std::string_view text, std::string& error) {
+    // Kept aside until the whole text parses, so a bad line adds nothing
+    std::vector<Node> nodes;
+    std::vector<Rule> rules;
+    uint32_t subsystems = 0;
+    int lineNumber = 0;
+    while (!text.empty()) {
+        const size_t newline = text.find('\n');
+        std::string_view line = text.substr(0, newline);
+        text = newline == std::string_view::npos ? std::string_view() : text.substr(newline + 1);
+        ++lineNumber;
+
+        const size_t comment = line.find('#');
+        if (comment != std::string_view::npos) {
+            line = line.substr(0, comment);
+        }
+        while (!line.empty() && std::isspace(static_cast<unsigned char>(line.back()))) {
+            line.remove_suffix(1);
+        }
+        while (!line.empty() && std::isspace(static_cast<unsigned char>(line.front()))) {
+            line.remove_prefix(1);
+        }
+        if (line.empty()) {
+            continue;
+        }
+
+        const size_t colon = line.find(':');
+        if (colon == std::string_view::npos || colon == 0) {
+            error = "line " + std::to_string(lineNumber) + ": expected 'name: condition'";
+            return false;
+        }
+
+        Rule rule;
+        rule.name = std::string(line.substr(0, colon));
+        while (!rule.name.empty() && std::isspace(static_cast<unsigned char>(rule.name.back()))) {
+            rule.name.pop_back();
+        }
+        std::string_view body = line.substr(colon + 1);
+        while (!body.empty() && std::isspace(static_cast<unsigned char>(body.front()))) {
+            body.remove_prefix(1);
+        }
+        rule.text = std::string(body);
+
+        Parser parser(nodes, nodes_.size(), body);
+        if (!parser.parseRule(rule)) {
+            error = "line " + std::to_string(lineNumber) + " (" + rule.name + "): " + parser.error();
+            return false;
+        }
+        subsystems |= parser.subsystems();
+        rules.push_back(std::move(rule));
+    }
+
+    nodes_.insert(nodes_.end(), std::make_move_iterator(nodes.begin()), std::make_move_iterator(nodes.end()));
+    rules_.insert(rules_.end(), std::make_move_iterator(rules.begin()), std::make_move_iterator(rules.end()));
+    subsystems_ |= subsystems;
+    return true;
+}
+
+bool AlertEngine::loadFile(const std::string& path, std::string& error) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        error = "cannot open " + path;
+        return false;
+    }
+    std::string text;
+    char buffer[4096];
+    size_t n;
+    while ((n = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        text.append(buffer, n);
+    }
+    std::fclose(file);
+    return parse(text, error);
+}
+
+void AlertEngine::bind(const std::vector<SeriesInfo>& series, std::vector<std::string>& warnings) {
+    series_ = series;
+    code_.clear();
+    constants_.clear();
+    ranges_.clear();
+    previous_.assign(series.size(), NAN);
+    previousTimestampMs_ = -1;
+
+    states_.assign(rules_.size(), RuleState());
+    for (size_t i = 0; i < rules_.size(); ++i) {
+        const Rule& rule = rules_[i];
+        RuleState& state = states_[i];
+        std::vector<std::string> missing;
+        int depth = 0;
+        int clearDepth = 0;
+
+        state.durationMs = rule.durationMs;
+        state.conditionStart = static_cast<uint32_t>(code_.size());
+        bool ok = compile(rule.condition, missing, depth);
+        state.conditionLength = static_cast<uint32_t>(code_.size()) - state.conditionStart;
+        state.clearStart = static_cast<uint32_t>(code_.size());
+        if (ok && rule.clear >= 0) {
+            ok = compile(rule.clear, missing, clearDepth);
+        }
+        state.clearLength = static_cast<uint32_t>(code_.size()) - state.clearStart;
+
+        state.enabled = ok && missing.empty() && std::max(depth, clearDepth) <= MAX_STACK;
+        if (!missing.empty()) {
+            warnings.push_back(rule.name + ": no series " + missing.front());
+        } else if (!state.enabled) {
+            warnings.push_back(rule.name + ": expression too deep");
+        }
+        if (!state.enabled) {
+            code_.resize(state.conditionStart);
+            state.conditionLength = 0;
+            state.clearLength = 0;
+        }
+    }
+}
+
+// Emits node in postfix order; depth receives the stack slots it needs
+bool AlertEngine::compile(int node, std::vector<std::string>& missing, int& depth) {
+    const Node& n = nodes_[static_cast<size_t>(node)];
+    auto findSeries = [&](const std::string& name) -> int {
+        for (size_t i = 0; i < series_.size(); ++i) {
+            if (series_[i].name == name) {
+                return static_cast<int>(i);
+            }
+        }
+        missing.push_back(name);
+        return -1;
+    };
+
+    switch (n.type) {
+        case NodeType::Number:
+            constants_.push_back(n.number);
+            code_.push_back({OP_CONST, false, static_cast<uint32_t>(constants_.size() - 1)});
+            depth = 1;
+            return true;
+
+        case NodeType::Series:
+        case NodeType::Rate:
+        case NodeType::Delta: {
+            const int index = findSeries(n.name);
+            if (index < 0) {
+                return false;
+            }
+            const Op op = n.type == NodeType::Series ? OP_LOAD : n.type == NodeType::Rate ? OP_RATE : OP_DELTA;
+            code_.push_back({op, false, static_cast<uint32_t>(index)});
+            depth = 1;
+            return true;
+        }
+
+        case NodeType::Max:
+        case NodeType::Min:
+        case NodeType::Avg:
+        case NodeType::Sum: {
+            // A pattern matching nothing evaluates to NaN rather than
+            // disabling the rule: fan* on a fanless machine is not an error
+            const uint32_t slot = static_cast<uint32_t>(ranges_.size());
+            ranges_.push_back(0);
+            for (size_t i = 0; i < series_.size(); ++i) {
+                if (matchPattern(n.name, series_[i].name)) {
+                    ranges_.push_back(static_cast<uint32_t>(i));
+                    ranges_[slot]++;
+                }
+            }
+            static const Op ops[] = {OP_MAX, OP_MIN, OP_AVG, OP_SUM};
+            code_.push_back({ops[static_cast<int>(n.type) - static_cast<int>(NodeType::Max)], false, slot});
+            depth = 1;
+            return true;
+        }
+
+        case NodeType::Negate:
+        case NodeType::Not:
+            if (!compile(n.left, missing, depth)) {
+                return false;
+            }
+            code_.push_back({n.type == NodeType::Negate ? OP_NEG : OP_NOT, false, 0});
+            return true;
+
+        default: {
+            const int offset = static_cast<int>(n.type) - static_cast<int>(NodeType::Add);
+            const Op op = static_cast<Op>(OP_ADD + offset);
+            int leftDepth = 0;
+            if (!compile(n.left, missing, leftDepth)) {
+                return false;
+            }
+            // Most rules compare against a literal; fold it into the operator
+            // instead of pushing it
+            const Node& right = nodes_[static_cast<size_t>(n.right)];
+            if (right.type == NodeType::Number) {
+                constants_.push_back(right.number);
+                code_.push_back({op, true, static_cast<uint32_t>(constants_.size() - 1)});
+                depth = leftDepth;
+                return true;
+            }
+            int rightDepth = 0;
+            if (!compile(n.right, missing, rightDepth)) {
+                return false;
+            }
+            depth = std::max(leftDepth, rightDepth + 1);
+            code_.push_back({op, false, 0});
+            return true;
+        }
+    }
+}
+
+double AlertEngine::run(uint32_t start, uint32_t length) const {
+    double stack[MAX_STACK];
+    int top = -1;
+    const Instruction* code = code_.data() + start;
+    const Instruction* end = code + length;
+
+    for (; code < end; ++code) {
+        const uint32_t arg = code->arg;
+        switch (code->op) {
+            case OP_CONST:
+                stack[++top] = constants_[arg];
+                break;
+            case OP_LOAD:
+                stack[++top] = arg < valueCount_ ? values_[arg] : NAN;
+                break;
+            case OP_RATE:
+            case OP_DELTA: {
+                const double change = arg < valueCount_ ? values_[arg] - previous_[arg] : NAN;
+                stack[++top] = code->op == OP_DELTA ? change
+                             : elapsedSeconds_ > 0.0 ? change / elapsedSeconds_ : NAN;
+                break;
+            }
+            case OP_MAX:
+            case OP_MIN:
+            case OP_AVG:
+            case OP_SUM: {
+                const uint32_t count = ranges_[arg];
+                const uint32_t* index = ranges_.data() + arg + 1;
+                double result = NAN;
+                double total = 0.0;
+                uint32_t present = 0;
+                for (uint32_t i = 0; i < count; ++i) {
+                    const double value = index[i] < valueCount_ ? values_[index[i]] : NAN;
+                    if (std::isnan(value)) {
+                        continue;
+                    }
+                    if (present++ == 0) {
+                        result = value;
+                    } else if (code->op == OP_MAX) {
+                        result = std::max(result, value);
+                    } else if (code->op == OP_MIN) {
+                        result = std::min(result, value);
+                    }
+                    total += value;
+                }
+                if (present > 0 && code->op == OP_SUM) {
+                    result = total;
+                } else if (present > 0 && code->op == OP_AVG) {
+                    result = total / present;
+                }
+                stack[++top] = result;
+                break;
+            }
+            case OP_NEG:
+                stack[top] = -stack[top];
+                break;
+            case OP_NOT:
+                stack[top] = truthy(stack[top]) ? 0.0 : 1.0;
+                break;
+            default: {
+                // Comparisons involving NaN (missing data) are false
+                const double b = code->constantOperand ? constants_[arg] : stack[top--];
+                const double a = stack[top];
+                double result = 0.0;
+                switch (code->op) {
+                    case OP_ADD: result = a + b; break;
+                    case OP_SUB: result = a - b; break;
+                    case OP_MUL: result = a * b; break;
+                    case OP_DIV: result = b != 0.0 ? a / b : NAN; break;
+                    case OP_LT: result = a < b; break;
+                    case OP_LE: result = a <= b; break;
+                    case OP_GT: result = a > b; break;
+                    case OP_GE: result = a >= b; break;
+                    case OP_EQ: result = a == b; break;
+                    case OP_NE: result = !std::isnan(a) && !std::isnan(b) && a != b; break;
+                    case OP_AND: result = truthy(a) && truthy(b); break;
+                    case OP_OR: result = truthy(a) || truthy(b); break;
+                    default: break;
+                }
+                stack[top] = result;
+                break;
+            }
+        }
+    }
+    return top == 0 ? stack[0] : NAN;
+}
+
+void AlertEngine::evaluate(int64_t timestampMs, const std::vector<double>& values) {
+    events_.clear();
+    values_ = values.data();
+    valueCount_ = std::min(values.size(), previous_.size());
+    elapsedSeconds_ = previousTimestampMs_ >= 0 ? (timestampMs - previousTimestampMs_) / 1000.0 : 0.0;
+
+    for (size_t i = 0; i < states_.size(); ++i) {
+        RuleState& state = states_[i];
+        if (!state.enabled) {
+            continue;
+        }
+        const bool condition = truthy(run(state.conditionStart, state.conditionLength));
+
+        if (!state.active) {
+            if (!condition) {
+                state.pendingSinceMs = -1;
+                continue;
+            }
+            if (state.pendingSinceMs < 0) {
+                state.pendingSinceMs = timestampMs;
+            }
+            if (timestampMs - state.pendingSinceMs >= state.durationMs) {
+                state.active = true;
+                events_.push_back({i, true, timestampMs});
+            }
+        } else {
+            // Hysteresis: an explicit clear condition, or the condition lapsing
+            const bool cleared = state.clearLength > 0 ? truthy(run(state.clearStart, state.clearLength)) : !condition;
+            if (cleared) {
+                state.active = false;
+                state.pendingSinceMs = -1;
+                events_.push_back({i, false, timestampMs});
+            }
+        }
+    }
+
+    std::copy(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(valueCount_), previous_.begin());
+    previousTimestampMs_ = timestampMs;
+    values_ = nullptr;
+}
+
+size_t AlertEngine::activeCount() const {
+    return static_cast<size_t>(std::count_if(states_.begin(), states_.end(),
+                                             [](const RuleState& state) { return state.active; }));
+}
+
+uint32_t AlertEngine::activeMeters() const {
+    uint32_t meters = 0;
+    for (size_t i = 0; i < states_.size(); ++i) {
+        if (states_[i].active) {
+            meters |= rules_[i].meters;
+        }
+    }
+    return meters;
+}
@@ -0,0 +1,137 @@
+#ifndef OSXVIEW_ALERTENGINE_H
+#define OSXVIEW_ALERTENGINE_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "RecordingFormat.h"
+
+// Threshold rules evaluated against every sample. One rule per line:
+//
+//   name: <condition> [for <duration>] [clear <condition>]
+//
+// Conditions combine series values (the names --record uses, e.g.
+// cpu0.user, mem.used, fan1.rpm) with + - * /, comparisons, and/or/not and
+// parentheses. rate(series) and delta(series) give the per-second and
+// per-sample change; max/min/avg/sum(pattern) aggregate every series
+// matching a '*' pattern. "90%" is read as 90. A rule fires once its
+// condition has held for the duration and stays active until the clear
+// condition holds (by default, until the condition is false):
+//
+//   cpu-hot: cpu0.user + cpu0.system > 90 for 30s clear cpu0.user + cpu0.system < 75
+//   swap-rising: rate(swap.used) > 0 for 2m
+//   core-pegged: max(cpu*.system) > 95% for 10s
+//
+// Rules are parsed once and compiled into a flat stack bytecode bound to
+// series indices, so evaluation touches no strings or maps.
+
+struct AlertEvent {
+    size_t rule;
+    bool fired;     // false when the alert cleared
+    int64_t timestampMs;
+};
+
+class AlertEngine {
+public:
+    // Appends the rules in text, or none of them if any line fails; line
+    // numbers in errors start at 1
+    bool parse(std::string_view text, std::string& error);
+    bool loadFile(const std::string& path, std::string& error);
+
+    // Resolves series names against a layout. Rules naming a series the
+    // layout lacks are disabled and listed in warnings.
+    void bind(const std::vector<SeriesInfo>& series, std::vector<std::string>& warnings);
+    void evaluate(int64_t timestampMs, const std::vector<double>& values);
+
+    // Transitions produced by the last evaluate()
+    const std::vector<AlertEvent>& events() const { return events_; }
+
+    size_t ruleCount() const { return rules_.size(); }
+    const std::string& ruleName(size_t rule) const { return rules_[rule].name; }
+    const std::string& ruleText(size_t rule) const { return rules_[rule].text; }
+    bool ruleActive(size_t rule) const { return states_[rule].active; }
+    size_t activeCount() const;
+
+    // Bit (1 << MeterKind) for every meter showing a series of an active rule
+    uint32_t activeMeters() const;
+    // MetricSubsystem bits the rules read
+    uint32_t requiredSubsystems() const { return subsystems_; }
+
+private:
+    enum class NodeType : uint8_t {
+        Number, Series, Rate, Delta, Max, Min, Avg, Sum,
+        Negate, Not, Add, Subtract, Multiply, Divide,
+        Less, LessEqual, Greater, GreaterEqual, Equal, NotEqual, And, Or
+    };
+
+    struct Node {
+        NodeType type;
+        double number = 0.0;
+        std::string name;       // series name or pattern
+        int left = -1;
+        int right = -1;
+    };
+
+    enum Op : uint8_t {
+        OP_CONST, OP_LOAD, OP_RATE, OP_DELTA, OP_MAX, OP_MIN, OP_AVG, OP_SUM,
+        OP_NEG, OP_NOT, OP_ADD, OP_SUB, OP_MUL, OP_DIV,
+        OP_LT, OP_LE, OP_GT, OP_GE, OP_EQ, OP_NE, OP_AND, OP_OR
+    };
+
+    struct Instruction {
+        Op op;
+        bool constantOperand = false;   // binary op whose right side is constants_[arg]
+        uint32_t arg = 0;               // constant, series or index-range slot
+    };
+
+    struct Rule {
+        std::string name;
+        std::string text;
+        int condition = -1;     // root node
+        int clear = -1;
+        int64_t durationMs = 0;
+        uint32_t meters = 0;
+    };
+
+    // Compiled form and hysteresis state, kept apart from the rule text so
+    // evaluation walks one dense array
+    struct RuleState {
+        uint32_t conditionStart = 0;    // offsets into code_
+        uint32_t conditionLength = 0;
+        uint32_t clearStart = 0;
+        uint32_t clearLength = 0;
+        int64_t durationMs = 0;
+        int64_t pendingSinceMs = -1;
+        bool enabled = false;
+        bool active = false;
+    };
+
+    static const int MAX_STACK = 32;
+
+    class Parser;
+
+    bool compile(int node, std::vector<std::string>& missing, int& depth);
+    double run(uint32_t start, uint32_t length) const;
+
+    std::vector<Node> nodes_;
+    std::vector<Rule> rules_;
+    std::vector<RuleState> states_;
+    uint32_t subsystems_ = 0;
+
+    std::vector<Instruction> code_;
+    std::vector<double> constants_;
+    std::vector<uint32_t> ranges_;      // per aggregate: count, then indices
+    std::vector<SeriesInfo> series_;
+
+    // Current and previous sample, for rate() and delta()
+    const double* values_ = nullptr;
+    size_t valueCount_ = 0;
+    std::vector<double> previous_;
+    double elapsedSeconds_ = 0.0;
+    int64_t previousTimestampMs_ = -1;
+
+    std::vector<AlertEvent> events_;
+};
+
+#endif //OSXVIEW_ALERTENGINE_H
@@ -0,0 +1,418 @@
+#include "CgroupCollector.h"
+
+#ifdef __linux__
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <functional>
+#include <sys/inotify.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char* const kFileNames[] = {
+    "cpu.stat", "cpu.max", "memory.current", "memory.max",
+    "io.stat", "cpu.pressure", "memory.pressure", "io.pressure",
+};
+
+const uint32_t kWatchMask = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR;
+
+// Value of "key N" at the start of a line
+uint64_t keyedValue(const char* text, const char* key) {
+    const size_t length = std::strlen(key);
+    for (const char* line = text; line && *line; line = std::strchr(line, '\n')) {
+        if (*line == '\n') {
+            ++line;
+        }
+        if (std::strncmp(line, key, length) == 0 && line[length] == ' ') {
+            return std::strtoull(line + length + 1, nullptr, 10);
+        }
+    }
+    return 0;
+}
+
+// Sum of every "key=N" token (io.stat has one line per device)
+uint64_t sumTokens(const char* text, const char* key) {
+    const size_t length = std::strlen(key);
+    uint64_t total = 0;
+    for (const char* token = std::strstr(text, key); token; token = std::strstr(token + length, key)) {
+        if (token == text || token[-1] == ' ') {
+            total += std::strtoull(token + length, nullptr, 10);
+        }
+    }
+    return total;
+}
+
+// "some avg10=1.23 ..." is the first line of a pressure file
+double pressureAvg10(const char* text) {
+    const char* value = std::strstr(text, "avg10=");
+    return value ? std::strtod(value + 6, nullptr) : 0.0;
+}
+
+std::string parentOf(const std::string& path) {
+    const size_t slash = path.rfind('/');
+    return slash == std::string::npos ? std::string() : path.substr(0, slash);
+}
+
+} // namespace
+
+CgroupCollector::~CgroupCollector() {
+    close();
+}
+
+bool CgroupCollector::open(const std::string& root) {
+    close();
+
+    // cgroup2 mounts expose cgroup.controllers at the root
+    struct stat info{};
+    if (stat((root + "/cgroup.controllers").c_str(), &info) != 0) {
+        return false;
+    }
+    inotifyFd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd_ < 0) {
+        return false;
+    }
+
+    // Eight descriptors per group; the default soft limit of 1024 covers
+    // only a hundred or so
+    rlimit limit{};
+    const rlim_t wanted = MAX_CGROUPS * FILE_COUNT + 256;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < wanted) {
+        limit.rlim_cur = std::min(limit.rlim_max, wanted);
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    root_ = root;
+    buffer_.resize(64 * 1024);
+    events_.resize(64 * 1024);
+    scan("");
+    return true;
+}
+
+void CgroupCollector::close() {
+    for (Cgroup& cgroup : cgroups_) {
+        for (int fd : cgroup.fds) {
+            if (cgroup.used && fd >= 0) {
+                ::close(fd);
+            }
+        }
+    }
+    cgroups_.clear();
+    freeSlots_.clear();
+    paths_.clear();
+    watches_.clear();
+    if (inotifyFd_ >= 0) {
+        ::close(inotifyFd_);
+        inotifyFd_ = -1;
+    }
+    haveSample_ = false;
+}
+
+// Adds path and every group below it. The watch is placed before listing,
+// so a child created in between is seen by one or the other (add() ignores
+// the duplicate).
+void CgroupCollector::scan(const std::string& path) {
+    if (add(path) == SIZE_MAX) {
+        return;
+    }
+    DIR* dir = opendir((root_ + path).c_str());
+    if (!dir) {
+        return;
+    }
+    while (dirent* entry = readdir(dir)) {
+        if (entry->d_type != DT_DIR || entry->d_name[0] == '.') {
+            continue;
+        }
+        scan(path + "/" + entry->d_name);
+    }
+    closedir(dir);
+}
+
+size_t CgroupCollector::add(const std::string& path) {
+    if (paths_.count(path) || paths_.size() >= MAX_CGROUPS) {
+        return SIZE_MAX;
+    }
+    const int watch = inotify_add_watch(inotifyFd_, (root_ + path).c_str(), kWatchMask);
+    if (watch < 0) {
+        return SIZE_MAX;
+    }
+
+    size_t index;
+    if (!freeSlots_.empty()) {
+        index = freeSlots_.back();
+        freeSlots_.pop_back();
+    } else {
+        index = cgroups_.size();
+        cgroups_.emplace_back();
+    }
+    Cgroup& cgroup = cgroups_[index];
+    cgroup = Cgroup();
+    cgroup.path = path;
+    cgroup.watch = watch;
+    cgroup.used = true;
+    std::fill(std::begin(cgroup.fds), std::end(cgroup.fds), FD_CLOSED);
+
+    paths_[path] = index;
+    watches_[watch] = index;
+    if (!path.empty()) {
+        auto parent = paths_.find(parentOf(path));
+        if (parent != paths_.end()) {
+            cgroups_[parent->second].children++;
+        }
+    }
+    return index;
+}
+
+void CgroupCollector::remove(const std::string& path) {
+    auto it = paths_.find(path);
+    if (it == paths_.end()) {
+        return;
+    }
+    const size_t index = it->second;
+    Cgroup& cgroup = cgroups_[index];
+
+    // The kernel only removes empty groups, but a missed event could leave
+    // stale children behind
+    if (cgroup.children > 0) {
+        std::vector<std::string> children;
+        for (const auto& [childPath, childIndex] : paths_) {
+            if (childPath.size() > path.size() && childPath.compare(0, path.size(), path) == 0 &&
+                childPath[path.size()] == '/') {
+                children.push_back(childPath);
+            }
+        }
+        std::sort(children.begin(), children.end(), std::greater<>());
+        for (const std::string& child : children) {
+            remove(child);
+        }
+    }
+
+    for (int& fd : cgroup.fds) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        fd = FD_CLOSED;
+    }
+    // The watch on a removed directory is dropped by the kernel
+    inotify_rm_watch(inotifyFd_, cgroup.watch);
+    watches_.erase(cgroup.watch);
+    auto parent = paths_.find(parentOf(path));
+    if (parent != paths_.end() && !path.empty()) {
+        cgroups_[parent->second].children--;
+    }
+    cgroup.used = false;
+    cgroup.path.clear();
+    paths_.erase(it);
+    freeSlots_.push_back(index);
+}
+
+void CgroupCollector::rescan() {
+    const std::string root = root_;
+    open(root);
+}
+
+void CgroupCollector::drainEvents() {
+    for (;;) {
+        const ssize_t length = read(inotifyFd_, events_.data(), events_.size());
+        if (length <= 0) {
+            return;
+        }
+        for (ssize_t offset = 0; offset < length;) {
+            const auto* event = reinterpret_cast<const inotify_event*>(events_.data() + offset);
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                // Events were lost; start over from a fresh scan
+                rescan();
+                return;
+            }
+            auto watch = watches_.find(event->wd);
+            if (watch == watches_.end()) {
+                continue;
+            }
+            if (event->mask & IN_IGNORED) {
+                // The directory itself is gone
+                remove(cgroups_[watch->second].path);
+                continue;
+            }
+            if (!(event->mask & IN_ISDIR) || event->len == 0) {
+                continue;
+            }
+            const std::string path = cgroups_[watch->second].path + "/" + event->name;
+            if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+                scan(path);
+            } else if (event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+                remove(path);
+            }
+        }
+    }
+}
+
+// Reads one stat file into buffer_ (NUL terminated)
+bool CgroupCollector::readFile(Cgroup& cgroup, File file, size_t& length) {
+    int& fd = cgroup.fds[file];
+    bool transient = false;
+    if (fd == FD_CLOSED) {
+        const std::string path = root_ + cgroup.path + "/" + kFileNames[file];
+        fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            // Out of descriptors: read this one and try caching it next time
+            transient = errno == EMFILE || errno == ENFILE;
+            fd = transient ? FD_CLOSED : FD_MISSING;
+            if (!transient) {
+                return false;
+            }
+            const int once = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (once < 0) {
+                return false;
+            }
+            const ssize_t n = pread(once, buffer_.data(), buffer_.size() - 1, 0);
+            ::close(once);
+            length = n > 0 ? static_cast<size_t>(n) : 0;
+            buffer_[length] = '\0';
+            return n > 0;
+        }
+    }
+    if (fd < 0) {
+        return false;
+    }
+
+    // cgroupfs regenerates the contents on every read from offset 0
+    const ssize_t n = pread(fd, buffer_.data(), buffer_.size() - 1, 0);
+    if (n < 0) {
+        ::close(fd);
+        fd = FD_MISSING;
+        return false;
+    }
+    length = static_cast<size_t>(n);
+    buffer_[length] = '\0';
+    return true;
+}
+
+void CgroupCollector::sample(Cgroup& cgroup, double elapsedSeconds, bool readLimits, CgroupMetrics& out) {
+    if (cgroup.path.empty()) {
+        out.name = "/";
+    } else {
+        out.name.assign(cgroup.path, 1, std::string::npos);
+    }
+    out.leaf = cgroup.children == 0;
+    const char* text = buffer_.data();
+    size_t length = 0;
+
+    uint64_t usageUsec = cgroup.usageUsec;
+    uint64_t throttledUsec = cgroup.throttledUsec;
+    if (readFile(cgroup, CPU_STAT, length)) {
+        usageUsec = keyedValue(text, "usage_usec");
+        throttledUsec = keyedValue(text, "throttled_usec");
+    }
+
+    if (readLimits || !cgroup.primed) {
+        cgroup.cpuLimit = 0.0;
+        if (readFile(cgroup, CPU_MAX, length) && std::strncmp(text, "max", 3) != 0) {
+            char* end = nullptr;
+            const double quota = std::strtod(text, &end);
+            const double period = std::strtod(end, nullptr);
+            cgroup.cpuLimit = period > 0.0 ? quota / period : 0.0;
+        }
+        cgroup.memoryMax = readFile(cgroup, MEMORY_MAX, length) && std::strncmp(text, "max", 3) != 0
+                         ? std::strtoull(text, nullptr, 10) : 0;
+    }
+    out.cpuLimit = cgroup.cpuLimit;
+    out.memoryMax = cgroup.memoryMax;
+    out.memoryCurrent = readFile(cgroup, MEMORY_CURRENT, length) ? std::strtoull(text, nullptr, 10) : 0;
+
+    uint64_t readBytes = cgroup.readBytes;
+    uint64_t writeBytes = cgroup.writeBytes;
+    if (readFile(cgroup, IO_STAT, length)) {
+        readBytes = sumTokens(text, "rbytes=");
+        writeBytes = sumTokens(text, "wbytes=");
+    }
+
+    out.cpuPressure = readFile(cgroup, CPU_PRESSURE, length) ? pressureAvg10(text) : 0.0;
+    out.memoryPressure = readFile(cgroup, MEMORY_PRESSURE, length) ? pressureAvg10(text) : 0.0;
+    out.ioPressure = readFile(cgroup, IO_PRESSURE, length) ? pressureAvg10(text) : 0.0;
+
+    // Counters can only be turned into rates from the second sample of a group
+    if (cgroup.primed && elapsedSeconds > 0.0) {
+        auto rate = [&](uint64_t now, uint64_t before) {
+            return now >= before ? static_cast<double>(now - before) / elapsedSeconds : 0.0;
+        };
+        out.cpuPercent = rate(usageUsec, cgroup.usageUsec) / 1e6 * 100.0;
+        out.throttledPercent = std::min(100.0, rate(throttledUsec, cgroup.throttledUsec) / 1e6 * 100.0);
+        out.ioReadBytes = static_cast<uint64_t>(rate(readBytes, cgroup.readBytes));
+        out.ioWriteBytes = static_cast<uint64_t>(rate(writeBytes, cgroup.writeBytes));
+    } else {
+        out.cpuPercent = 0.0;
+        out.throttledPercent = 0.0;
+        out.ioReadBytes = 0;
+        out.ioWriteBytes = 0;
+    }
+    cgroup.usageUsec = usageUsec;
+    cgroup.throttledUsec = throttledUsec;
+    cgroup.readBytes = readBytes;
+    cgroup.writeBytes = writeBytes;
+    cgroup.primed = true;
+}
+
+void CgroupCollector::update(std::vector<CgroupMetrics>& out) {
+    if (inotifyFd_ < 0) {
+        out.clear();
+        return;
+    }
+    drainEvents();
+
+    if (--retryCountdown_ <= 0) {
+        retryCountdown_ = MISSING_RETRY;
+        for (Cgroup& cgroup : cgroups_) {
+            for (int& fd : cgroup.fds) {
+                if (fd == FD_MISSING) {
+                    fd = FD_CLOSED;
+                }
+            }
+        }
+    }
+
+    const bool readLimits = --limitCountdown_ <= 0;
+    if (readLimits) {
+        limitCountdown_ = LIMIT_REFRESH;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    const double elapsedSeconds = haveSample_ ? std::chrono::duration<double>(now - lastSample_).count() : 0.0;
+    lastSample_ = now;
+    haveSample_ = true;
+
+    // Entries are overwritten in place so their name strings keep their
+    // storage from one sample to the next
+    out.resize(paths_.size());
+    size_t count = 0;
+    for (Cgroup& cgroup : cgroups_) {
+        if (cgroup.used && count < out.size()) {
+            sample(cgroup, elapsedSeconds, readLimits, out[count++]);
+        }
+    }
+    out.resize(count);
+}
+
+#else
+
+CgroupCollector::~CgroupCollector() = default;
+
+bool CgroupCollector::open(const std::string& /* root */) {
+    return false;
+}
+
+void CgroupCollector::close() {
+}
+
+void CgroupCollector::update(std::vector<CgroupMetrics>& out) {
+    out.clear();
+}
+
+#endif
@@ -0,0 +1,109 @@
+#ifndef OSXVIEW_CGROUPCOLLECTOR_H
+#define OSXVIEW_CGROUPCOLLECTOR_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Resource usage of one cgroup v2 group
+struct CgroupMetrics {
+    std::string name;               // path below the cgroup root
+    double cpuPercent = 0.0;        // of one CPU
+    double cpuLimit = 0.0;          // CPUs allowed by cpu.max, 0 when unlimited
+    double throttledPercent = 0.0;  // share of the interval spent throttled
+    uint64_t memoryCurrent = 0;
+    uint64_t memoryMax = 0;         // 0 when unlimited
+    uint64_t ioReadBytes = 0;       // per second
+    uint64_t ioWriteBytes = 0;
+    double cpuPressure = 0.0;       // PSI "some" avg10, percent
+    double memoryPressure = 0.0;
+    double ioPressure = 0.0;
+    bool leaf = false;              // no child groups: a container or service
+};
+
+// Linux cgroup v2 accounting. The hierarchy is scanned once; after that
+// groups are added and removed from inotify events on every directory, and
+// each group's stat files stay open and are re-read with pread. On other
+// platforms (and without cgroup v2) open() fails and update() reports
+// nothing.
+class CgroupCollector {
+public:
+    CgroupCollector() = default;
+    ~CgroupCollector();
+
+    CgroupCollector(const CgroupCollector&) = delete;
+    CgroupCollector& operator=(const CgroupCollector&) = delete;
+
+    bool open(const std::string& root = "/sys/fs/cgroup");
+    void close();
+    bool available() const { return inotifyFd_ >= 0; }
+
+    // Applies pending hierarchy changes and reads every group
+    void update(std::vector<CgroupMetrics>& out);
+    size_t cgroupCount() const { return paths_.size(); }
+
+private:
+    static const size_t MAX_CGROUPS = 8192;
+    // Files of controllers that are not enabled are looked for again this
+    // often (in updates), since enabling one does not raise inotify events
+    static const int MISSING_RETRY = 30;
+    // cpu.max and memory.max are set once per container in practice
+    static const int LIMIT_REFRESH = 10;
+
+    enum File {
+        CPU_STAT,
+        CPU_MAX,
+        MEMORY_CURRENT,
+        MEMORY_MAX,
+        IO_STAT,
+        CPU_PRESSURE,
+        MEMORY_PRESSURE,
+        IO_PRESSURE,
+        FILE_COUNT
+    };
+
+    // fds[] holds an open descriptor, FD_MISSING or FD_CLOSED (not opened
+    // yet, or the descriptor limit was hit: opened per read instead)
+    static const int FD_MISSING = -1;
+    static const int FD_CLOSED = -2;
+
+    struct Cgroup {
+        std::string path;
+        int watch = -1;
+        int fds[FILE_COUNT];
+        int children = 0;
+        bool used = false;
+        bool primed = false;
+        uint64_t usageUsec = 0;
+        uint64_t throttledUsec = 0;
+        uint64_t readBytes = 0;
+        uint64_t writeBytes = 0;
+        double cpuLimit = 0.0;
+        uint64_t memoryMax = 0;
+    };
+
+    void scan(const std::string& path);
+    size_t add(const std::string& path);
+    void remove(const std::string& path);
+    void drainEvents();
+    void rescan();
+    bool readFile(Cgroup& cgroup, File file, size_t& length);
+    void sample(Cgroup& cgroup, double elapsedSeconds, bool readLimits, CgroupMetrics& out);
+
+    std::string root_;
+    int inotifyFd_ = -1;
+    std::vector<Cgroup> cgroups_;
+    std::vector<size_t> freeSlots_;
+    std::unordered_map<std::string, size_t> paths_;
+    std::unordered_map<int, size_t> watches_;
+    std::vector<char> buffer_;
+    std::vector<char> events_;
+    std::chrono::steady_clock::time_point lastSample_;
+    bool haveSample_ = false;
+    int retryCountdown_ = MISSING_RETRY;
+    int limitCountdown_ = 0;
+};
+
+#endif //OSXVIEW_CGROUPCOLLECTOR_H
@@ -0,0 +1,163 @@
+#include "ClusterAgent.h"
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+ClusterAgent::ClusterAgent(std::string host, uint16_t port, ClusterTransport transport)
+    : host_(std::move(host)), port_(port), transport_(transport) {
+}
+
+ClusterAgent::~ClusterAgent() {
+    disconnect();
+}
+
+void ClusterAgent::disconnect() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    connected_ = false;
+    pending_.clear();
+}
+
+bool ClusterAgent::ensureSocket() {
+    if (fd_ >= 0) {
+        return true;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    if (now < retryAt_) {
+        return false;
+    }
+
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = transport_ == ClusterTransport::TCP ? SOCK_STREAM : SOCK_DGRAM;
+    addrinfo* result = nullptr;
+    const std::string service = std::to_string(port_);
+    if (getaddrinfo(host_.c_str(), service.c_str(), &hints, &result) != 0 || !result) {
+        retryAt_ = now + backoff_;
+        backoff_ = std::min(backoff_ * 2, std::chrono::milliseconds(10000));
+        return false;
+    }
+
+    fd_ = socket(result->ai_family, result->ai_socktype, result->ai_protocol);
+    if (fd_ >= 0) {
+        const int flags = fcntl(fd_, F_GETFL, 0);
+        fcntl(fd_, F_SETFL, flags | O_NONBLOCK);
+#ifdef SO_NOSIGPIPE
+        const int on = 1;
+        setsockopt(fd_, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+        if (transport_ == ClusterTransport::TCP) {
+            const int noDelay = 1;
+            setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        }
+        // UDP sockets are "connected" too, so send() needs no address
+        if (connect(fd_, result->ai_addr, result->ai_addrlen) == 0) {
+            connected_ = true;
+        } else if (errno != EINPROGRESS) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+    freeaddrinfo(result);
+
+    if (fd_ < 0) {
+        retryAt_ = now + backoff_;
+        backoff_ = std::min(backoff_ * 2, std::chrono::milliseconds(10000));
+        return false;
+    }
+    return true;
+}
+
+bool ClusterAgent::finishConnect() {
+    if (connected_) {
+        return true;
+    }
+    pollfd pfd{fd_, POLLOUT, 0};
+    if (::poll(&pfd, 1, 0) <= 0) {
+        return false;
+    }
+    int error = 0;
+    socklen_t length = sizeof(error);
+    if (getsockopt(fd_, SOL_SOCKET, SO_ERROR, &error, &length) != 0 || error != 0) {
+        disconnect();
+        retryAt_ = std::chrono::steady_clock::now() + backoff_;
+        backoff_ = std::min(backoff_ * 2, std::chrono::milliseconds(10000));
+        return false;
+    }
+    connected_ = true;
+    backoff_ = std::chrono::milliseconds(250);
+    return true;
+}
+
+bool ClusterAgent::flushPending() {
+    while (!pending_.empty()) {
+        const ssize_t written = ::send(fd_, pending_.data(), pending_.size(), MSG_NOSIGNAL);
+        if (written < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+                return false;
+            }
+            disconnect();
+            return false;
+        }
+        pending_.erase(pending_.begin(), pending_.begin() + written);
+    }
+    return true;
+}
+
+bool ClusterAgent::send(HostSnapshot snapshot) {
+    snapshot.sequence = sequence_++;
+    if (!ensureSocket() || !finishConnect()) {
+        dropped_++;
+        return false;
+    }
+
+    uint8_t frame[2 + kMaxHostSnapshotSize];
+    const size_t size = encodeHostSnapshot(snapshot, frame + 2, sizeof(frame) - 2);
+    if (size == 0) {
+        dropped_++;
+        return false;
+    }
+
+    if (transport_ == ClusterTransport::UDP) {
+        if (::send(fd_, frame + 2, size, 0) < 0) {
+            // ECONNREFUSED just means nobody is listening yet
+            dropped_++;
+            return false;
+        }
+        sent_++;
+        return true;
+    }
+
+    // A partially written frame must finish before the next one starts
+    if (!flushPending()) {
+        dropped_++;
+        return false;
+    }
+    frame[0] = static_cast<uint8_t>(size);
+    frame[1] = static_cast<uint8_t>(size >> 8);
+    const ssize_t written = ::send(fd_, frame, size + 2, MSG_NOSIGNAL);
+    if (written < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            disconnect();
+        }
+        dropped_++;
+        return false;
+    }
+    if (static_cast<size_t>(written) < size + 2) {
+        pending_.assign(frame + written, frame + size + 2);
+    }
+    sent_++;
+    return true;
+}
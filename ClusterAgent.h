@@ -0,0 +1,52 @@
+#ifndef OSXVIEW_CLUSTERAGENT_H
+#define OSXVIEW_CLUSTERAGENT_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "ClusterProtocol.h"
+
+enum class ClusterTransport {
+    TCP,
+    UDP
+};
+
+// Sends host snapshots to a cluster receiver. send() never blocks: a TCP
+// connection is (re)established in the background with backoff, and a
+// snapshot that does not fit in the socket buffer is dropped rather than
+// queued, since the next one supersedes it anyway.
+class ClusterAgent {
+public:
+    ClusterAgent(std::string host, uint16_t port, ClusterTransport transport);
+    ~ClusterAgent();
+
+    ClusterAgent(const ClusterAgent&) = delete;
+    ClusterAgent& operator=(const ClusterAgent&) = delete;
+
+    bool send(HostSnapshot snapshot);
+
+    bool connected() const { return connected_; }
+    uint64_t sent() const { return sent_; }
+    uint64_t dropped() const { return dropped_; }
+
+private:
+    bool ensureSocket();
+    bool finishConnect();
+    void disconnect();
+    bool flushPending();
+
+    std::string host_;
+    uint16_t port_;
+    ClusterTransport transport_;
+    int fd_ = -1;
+    bool connected_ = false;
+    uint32_t sequence_ = 0;
+    std::chrono::steady_clock::time_point retryAt_;
+    std::chrono::milliseconds backoff_{250};
+    std::vector<uint8_t> pending_;
+    uint64_t sent_ = 0;
+    uint64_t dropped_ = 0;
+};
+
+#endif //OSXVIEW_CLUSTERAGENT_H
@@ -0,0 +1,98 @@
+#include "ClusterProtocol.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+constexpr uint32_t kMagic = 0x4856584Fu;   // "OXVH"
+constexpr uint8_t kVersion = 1;
+
+void put16(uint8_t* out, uint16_t value) {
+    out[0] = static_cast<uint8_t>(value);
+    out[1] = static_cast<uint8_t>(value >> 8);
+}
+
+void put32(uint8_t* out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+uint16_t get16(const uint8_t* in) {
+    return static_cast<uint16_t>(in[0] | (in[1] << 8));
+}
+
+uint32_t get32(const uint8_t* in) {
+    return static_cast<uint32_t>(in[0]) | (static_cast<uint32_t>(in[1]) << 8) |
+           (static_cast<uint32_t>(in[2]) << 16) | (static_cast<uint32_t>(in[3]) << 24);
+}
+
+uint16_t encodePercent(double value) {
+    if (!(value > 0.0)) {
+        return 0;
+    }
+    return static_cast<uint16_t>(std::lround(std::min(value, 100.0) * 100.0));
+}
+
+void putFloat(uint8_t* out, double value) {
+    const float f = std::isfinite(value) ? static_cast<float>(std::max(0.0, value)) : 0.0f;
+    uint32_t bits;
+    std::memcpy(&bits, &f, sizeof(bits));
+    put32(out, bits);
+}
+
+double getFloat(const uint8_t* in) {
+    const uint32_t bits = get32(in);
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+} // namespace
+
+size_t encodeHostSnapshot(const HostSnapshot& snapshot, uint8_t* out, size_t capacity) {
+    const size_t nameLength = std::min(snapshot.name.size(), kMaxHostNameLength);
+    const size_t size = kHostSnapshotHeaderSize + nameLength;
+    if (capacity < size) {
+        return 0;
+    }
+
+    put32(out, kMagic);
+    out[4] = kVersion;
+    out[5] = static_cast<uint8_t>(nameLength);
+    put16(out + 6, 0);
+    put32(out + 8, snapshot.sequence);
+    put16(out + 12, encodePercent(snapshot.cpuUser));
+    put16(out + 14, encodePercent(snapshot.cpuSystem));
+    put16(out + 16, encodePercent(snapshot.memUsed));
+    put16(out + 18, encodePercent(snapshot.swapUsed));
+    putFloat(out + 20, snapshot.netIn);
+    putFloat(out + 24, snapshot.netOut);
+    putFloat(out + 28, snapshot.diskRead);
+    putFloat(out + 32, snapshot.diskWrite);
+    std::memcpy(out + kHostSnapshotHeaderSize, snapshot.name.data(), nameLength);
+    return size;
+}
+
+bool decodeHostSnapshot(const uint8_t* data, size_t size, HostSnapshot& snapshot) {
+    if (size < kHostSnapshotHeaderSize || get32(data) != kMagic || data[4] != kVersion) {
+        return false;
+    }
+    const size_t nameLength = data[5];
+    if (nameLength == 0 || nameLength > kMaxHostNameLength || size != kHostSnapshotHeaderSize + nameLength) {
+        return false;
+    }
+
+    snapshot.name.assign(reinterpret_cast<const char*>(data + kHostSnapshotHeaderSize), nameLength);
+    snapshot.sequence = get32(data + 8);
+    snapshot.cpuUser = get16(data + 12) / 100.0;
+    snapshot.cpuSystem = get16(data + 14) / 100.0;
+    snapshot.memUsed = get16(data + 16) / 100.0;
+    snapshot.swapUsed = get16(data + 18) / 100.0;
+    snapshot.netIn = getFloat(data + 20);
+    snapshot.netOut = getFloat(data + 24);
+    snapshot.diskRead = getFloat(data + 28);
+    snapshot.diskWrite = getFloat(data + 32);
+    return true;
+}
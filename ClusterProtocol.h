@@ -0,0 +1,40 @@
+#ifndef OSXVIEW_CLUSTERPROTOCOL_H
+#define OSXVIEW_CLUSTERPROTOCOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Compact per-host snapshot exchanged between agents and a cluster receiver.
+//
+// Wire layout (little-endian, 36 bytes + name):
+//   u32 magic 'OXVH', u8 version, u8 name length, u16 reserved, u32 sequence,
+//   u16 cpu user, u16 cpu system, u16 mem used, u16 swap used   (1/100 %)
+//   f32 net in, f32 net out, f32 disk read, f32 disk write       (bytes per sample)
+//   name bytes (not terminated)
+//
+// Over UDP each datagram carries one snapshot; over TCP every snapshot is
+// preceded by its u16 length.
+
+struct HostSnapshot {
+    std::string name;
+    uint32_t sequence = 0;
+    double cpuUser = 0.0;       // percent
+    double cpuSystem = 0.0;
+    double memUsed = 0.0;
+    double swapUsed = 0.0;
+    double netIn = 0.0;         // bytes, as SystemMetrics reports them
+    double netOut = 0.0;
+    double diskRead = 0.0;
+    double diskWrite = 0.0;
+};
+
+constexpr size_t kHostSnapshotHeaderSize = 36;
+constexpr size_t kMaxHostNameLength = 63;
+constexpr size_t kMaxHostSnapshotSize = kHostSnapshotHeaderSize + kMaxHostNameLength;
+
+// Returns the encoded size, or 0 if out is too small
+size_t encodeHostSnapshot(const HostSnapshot& snapshot, uint8_t* out, size_t capacity);
+bool decodeHostSnapshot(const uint8_t* data, size_t size, HostSnapshot& snapshot);
+
+#endif //OSXVIEW_CLUSTERPROTOCOL_H
@@ -0,0 +1,221 @@
+#include "ClusterReceiver.h"
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+bool setNonBlocking(int fd) {
+    const int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+int openSocket(int type, uint16_t port) {
+    const int fd = socket(AF_INET6, type, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    const int off = 0;
+    const int on = 1;
+    setsockopt(fd, IPPROTO_IPV6, IPV6_V6ONLY, &off, sizeof(off));
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+    sockaddr_in6 address{};
+    address.sin6_family = AF_INET6;
+    address.sin6_addr = in6addr_any;
+    address.sin6_port = htons(port);
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || !setNonBlocking(fd)) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+} // namespace
+
+ClusterReceiver::~ClusterReceiver() {
+    close();
+}
+
+bool ClusterReceiver::listen(uint16_t port) {
+    close();
+
+    // One descriptor per TCP agent; the default soft limit (256 on macOS)
+    // is too low for a rack's worth of hosts
+    rlimit limit{};
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < MAX_CONNECTIONS + 64) {
+        limit.rlim_cur = std::min<rlim_t>(limit.rlim_max, MAX_CONNECTIONS + 64);
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    tcpFd_ = openSocket(SOCK_STREAM, port);
+    if (tcpFd_ < 0 || ::listen(tcpFd_, 512) != 0) {
+        close();
+        return false;
+    }
+
+    // With port 0 the UDP socket follows whatever port TCP was given
+    sockaddr_in6 bound{};
+    socklen_t length = sizeof(bound);
+    if (getsockname(tcpFd_, reinterpret_cast<sockaddr*>(&bound), &length) != 0) {
+        close();
+        return false;
+    }
+    port_ = ntohs(bound.sin6_port);
+
+    udpFd_ = openSocket(SOCK_DGRAM, port_);
+    if (udpFd_ < 0) {
+        close();
+        return false;
+    }
+    // A few hundred hosts reporting at once must fit between two polls
+    const int receiveBuffer = 4 * 1024 * 1024;
+    setsockopt(udpFd_, SOL_SOCKET, SO_RCVBUF, &receiveBuffer, sizeof(receiveBuffer));
+    return true;
+}
+
+void ClusterReceiver::close() {
+    for (Connection& connection : connections_) {
+        ::close(connection.fd);
+    }
+    connections_.clear();
+    if (tcpFd_ >= 0) {
+        ::close(tcpFd_);
+        tcpFd_ = -1;
+    }
+    if (udpFd_ >= 0) {
+        ::close(udpFd_);
+        udpFd_ = -1;
+    }
+    port_ = 0;
+}
+
+void ClusterReceiver::poll(int timeoutMs) {
+    if (tcpFd_ < 0) {
+        return;
+    }
+
+    std::vector<pollfd> fds;
+    fds.reserve(connections_.size() + 2);
+    fds.push_back({tcpFd_, POLLIN, 0});
+    fds.push_back({udpFd_, POLLIN, 0});
+    for (const Connection& connection : connections_) {
+        fds.push_back({connection.fd, POLLIN, 0});
+    }
+
+    if (::poll(fds.data(), static_cast<nfds_t>(fds.size()), timeoutMs) <= 0) {
+        return;
+    }
+
+    // Connections first: accepting appends to connections_, which would
+    // shift the indices matched against fds
+    size_t keep = 0;
+    for (size_t i = 0; i < connections_.size(); ++i) {
+        const short events = fds[i + 2].revents;
+        bool open = true;
+        if (events & (POLLIN | POLLHUP | POLLERR)) {
+            open = readConnection(connections_[i]);
+        }
+        if (open) {
+            if (keep != i) {
+                connections_[keep] = std::move(connections_[i]);
+            }
+            keep++;
+        } else {
+            ::close(connections_[i].fd);
+        }
+    }
+    connections_.resize(keep);
+
+    if (fds[1].revents & POLLIN) {
+        drainDatagrams();
+    }
+    if (fds[0].revents & POLLIN) {
+        acceptConnections();
+    }
+}
+
+void ClusterReceiver::acceptConnections() {
+    for (;;) {
+        const int fd = ::accept(tcpFd_, nullptr, nullptr);
+        if (fd < 0) {
+            return;
+        }
+        if (connections_.size() >= MAX_CONNECTIONS || !setNonBlocking(fd)) {
+            ::close(fd);
+            continue;
+        }
+        Connection connection;
+        connection.fd = fd;
+        connections_.push_back(std::move(connection));
+    }
+}
+
+void ClusterReceiver::drainDatagrams() {
+    uint8_t datagram[kMaxHostSnapshotSize + 1];
+    for (;;) {
+        const ssize_t received = recv(udpFd_, datagram, sizeof(datagram), 0);
+        if (received < 0) {
+            return;
+        }
+        store(datagram, static_cast<size_t>(received));
+    }
+}
+
+bool ClusterReceiver::readConnection(Connection& connection) {
+    uint8_t chunk[16384];
+    for (;;) {
+        const ssize_t received = recv(connection.fd, chunk, sizeof(chunk), 0);
+        if (received == 0) {
+            return false;
+        }
+        if (received < 0) {
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        }
+        connection.buffer.insert(connection.buffer.end(), chunk, chunk + received);
+
+        // Frames are a u16 length followed by one snapshot
+        size_t offset = 0;
+        while (connection.buffer.size() - offset >= 2) {
+            const size_t frameSize = connection.buffer[offset] | (connection.buffer[offset + 1] << 8);
+            if (frameSize > kMaxHostSnapshotSize) {
+                messagesRejected_++;
+                return false;
+            }
+            if (connection.buffer.size() - offset - 2 < frameSize) {
+                break;
+            }
+            store(connection.buffer.data() + offset + 2, frameSize);
+            offset += 2 + frameSize;
+        }
+        connection.buffer.erase(connection.buffer.begin(), connection.buffer.begin() + offset);
+    }
+}
+
+void ClusterReceiver::store(const uint8_t* data, size_t size) {
+    if (!decodeHostSnapshot(data, size, scratch_)) {
+        messagesRejected_++;
+        return;
+    }
+    messagesReceived_++;
+
+    auto found = hostIndex_.find(scratch_.name);
+    if (found == hostIndex_.end()) {
+        if (hosts_.size() >= MAX_HOSTS) {
+            messagesRejected_++;
+            return;
+        }
+        found = hostIndex_.emplace(scratch_.name, static_cast<uint32_t>(hosts_.size())).first;
+        hosts_.emplace_back();
+    }
+
+    HostState& host = hosts_[found->second];
+    host.snapshot = scratch_;
+    host.lastSeen = std::chrono::steady_clock::now();
+    host.messages++;
+}
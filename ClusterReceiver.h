@@ -0,0 +1,65 @@
+#ifndef OSXVIEW_CLUSTERRECEIVER_H
+#define OSXVIEW_CLUSTERRECEIVER_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "ClusterProtocol.h"
+
+// Latest snapshot of one host, stored in a flat array in arrival order
+struct HostState {
+    HostSnapshot snapshot;
+    std::chrono::steady_clock::time_point lastSeen;
+    uint64_t messages = 0;
+};
+
+// Accepts host snapshots on one port over both TCP and UDP. Everything runs
+// on the caller's thread: poll() waits up to timeoutMs for readiness, then
+// drains every readable socket without blocking.
+class ClusterReceiver {
+public:
+    ClusterReceiver() = default;
+    ~ClusterReceiver();
+
+    ClusterReceiver(const ClusterReceiver&) = delete;
+    ClusterReceiver& operator=(const ClusterReceiver&) = delete;
+
+    // Port 0 picks a free port (see port())
+    bool listen(uint16_t port);
+    void close();
+    void poll(int timeoutMs);
+
+    uint16_t port() const { return port_; }
+    const std::vector<HostState>& hosts() const { return hosts_; }
+    size_t connectionCount() const { return connections_.size(); }
+    uint64_t messagesReceived() const { return messagesReceived_; }
+    uint64_t messagesRejected() const { return messagesRejected_; }
+
+private:
+    static const size_t MAX_HOSTS = 4096;
+    static const size_t MAX_CONNECTIONS = 4096;
+
+    struct Connection {
+        int fd = -1;
+        std::vector<uint8_t> buffer;
+    };
+
+    void acceptConnections();
+    void drainDatagrams();
+    bool readConnection(Connection& connection);
+    void store(const uint8_t* data, size_t size);
+
+    int tcpFd_ = -1;
+    int udpFd_ = -1;
+    uint16_t port_ = 0;
+    std::vector<Connection> connections_;
+    std::vector<HostState> hosts_;
+    std::unordered_map<std::string, uint32_t> hostIndex_;
+    HostSnapshot scratch_;
+    uint64_t messagesReceived_ = 0;
+    uint64_t messagesRejected_ = 0;
+};
+
+#endif //OSXVIEW_CLUSTERRECEIVER_H
@@ -0,0 +1,180 @@
+#include "CpuFreqCollector.h"
+
+#ifdef __linux__
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+bool readNumber(int fd, uint64_t& value) {
+    char buffer[32];
+    const ssize_t length = pread(fd, buffer, sizeof(buffer), 0);
+    if (length <= 0 || buffer[0] < '0' || buffer[0] > '9') {
+        return false;
+    }
+    value = 0;
+    for (ssize_t i = 0; i < length && buffer[i] >= '0' && buffer[i] <= '9'; ++i) {
+        value = value * 10 + static_cast<uint64_t>(buffer[i] - '0');
+    }
+    return true;
+}
+
+} // namespace
+
+CpuFreqCollector::~CpuFreqCollector() {
+    close();
+}
+
+bool CpuFreqCollector::open(const std::string& root) {
+    close();
+    DIR* dir = opendir(root.c_str());
+    if (!dir) {
+        return false;
+    }
+    std::vector<int> ids;
+    while (dirent* entry = readdir(dir)) {
+        const char* name = entry->d_name;
+        if (std::strncmp(name, "cpu", 3) == 0 && name[3] >= '0' && name[3] <= '9') {
+            ids.push_back(std::atoi(name + 3));
+        }
+    }
+    closedir(dir);
+    std::sort(ids.begin(), ids.end());
+
+    cores_.resize(ids.size());
+    std::vector<File> counters;
+    for (size_t core = 0; core < ids.size(); ++core) {
+        const std::string path = root + "/cpu" + std::to_string(ids[core]);
+        auto openFile = [&](const char* file) {
+            return ::open((path + file).c_str(), O_RDONLY | O_CLOEXEC);
+        };
+
+        // The ceiling only changes with hotplug or a driver reload
+        const int maxFd = openFile("/cpufreq/cpuinfo_max_freq");
+        uint64_t maxKhz = 0;
+        if (maxFd >= 0) {
+            readNumber(maxFd, maxKhz);
+            ::close(maxFd);
+        }
+        cores_[core].maxMhz = static_cast<double>(maxKhz) / 1000.0;
+
+        const uint32_t index = static_cast<uint32_t>(core);
+        const int freqFd = openFile("/cpufreq/scaling_cur_freq");
+        if (freqFd >= 0) {
+            files_.push_back({freqFd, index, CUR_FREQ});
+        }
+        const int coreFd = openFile("/thermal_throttle/core_throttle_count");
+        if (coreFd >= 0) {
+            counters.push_back({coreFd, index, CORE_THROTTLES});
+        }
+        const int packageFd = openFile("/thermal_throttle/package_throttle_count");
+        if (packageFd >= 0) {
+            counters.push_back({packageFd, index, PACKAGE_THROTTLES});
+        }
+    }
+    files_.insert(files_.end(), counters.begin(), counters.end());
+
+    // Read everything once so throttling is reported from the first update
+    // on, not as the whole count since boot
+    for (const File& file : files_) {
+        uint64_t value = 0;
+        if (file.kind == CORE_THROTTLES && readNumber(file.fd, value)) {
+            cores_[file.core].coreThrottles = value;
+        } else if (file.kind == PACKAGE_THROTTLES && readNumber(file.fd, value)) {
+            cores_[file.core].packageThrottles = value;
+        }
+    }
+    if (files_.empty()) {
+        cores_.clear();
+        return false;
+    }
+    return true;
+}
+
+void CpuFreqCollector::close() {
+    for (const File& file : files_) {
+        ::close(file.fd);
+    }
+    files_.clear();
+    cores_.clear();
+    cursor_ = 0;
+}
+
+void CpuFreqCollector::update(CpuFreqMetrics& out) {
+    out.valid = false;
+    out.filesOpen = files_.size();
+    out.filesRead = 0;
+    if (files_.empty()) {
+        out.cores.clear();
+        return;
+    }
+
+    for (CpuFreqCoreMetrics& core : cores_) {
+        core.throttling = false;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    size_t read = 0;
+    while (read < files_.size()) {
+        const File& file = files_[cursor_];
+        cursor_ = cursor_ + 1 == files_.size() ? 0 : cursor_ + 1;
+        ++read;
+
+        uint64_t value = 0;
+        if (readNumber(file.fd, value)) {
+            CpuFreqCoreMetrics& core = cores_[file.core];
+            switch (file.kind) {
+                case CUR_FREQ:
+                    core.mhz = static_cast<double>(value) / 1000.0;
+                    break;
+                case CORE_THROTTLES:
+                    core.throttling |= value > core.coreThrottles;
+                    core.coreThrottles = value;
+                    break;
+                case PACKAGE_THROTTLES:
+                    core.throttling |= value > core.packageThrottles;
+                    core.packageThrottles = value;
+                    break;
+            }
+        }
+        if (read % BUDGET_CHECK_INTERVAL == 0 && std::chrono::steady_clock::now() - start >= budget_) {
+            break;
+        }
+    }
+    out.updateMicros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    out.filesRead = read;
+
+    out.cores = cores_;
+    double sum = 0.0;
+    out.maxMhz = 0.0;
+    out.throttlingCores = 0;
+    for (const CpuFreqCoreMetrics& core : cores_) {
+        sum += core.mhz;
+        out.maxMhz = std::max(out.maxMhz, core.maxMhz);
+        out.throttlingCores += core.throttling ? 1 : 0;
+    }
+    out.averageMhz = sum / static_cast<double>(cores_.size());
+    out.valid = true;
+}
+
+#else
+
+CpuFreqCollector::~CpuFreqCollector() = default;
+
+bool CpuFreqCollector::open(const std::string& /* root */) {
+    return false;
+}
+
+void CpuFreqCollector::close() {
+}
+
+void CpuFreqCollector::update(CpuFreqMetrics& out) {
+    out.cores.clear();
+    out.valid = false;
+}
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef OSXVIEW_CPUFREQCOLLECTOR_H
+#define OSXVIEW_CPUFREQCOLLECTOR_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct CpuFreqCoreMetrics {
+    double mhz = 0.0;               // scaling_cur_freq
+    double maxMhz = 0.0;            // cpuinfo_max_freq, turbo included
+    uint64_t coreThrottles = 0;     // thermal_throttle counts since boot
+    uint64_t packageThrottles = 0;
+    bool throttling = false;        // a count rose since the previous read
+};
+
+struct CpuFreqMetrics {
+    std::vector<CpuFreqCoreMetrics> cores;
+    double averageMhz = 0.0;
+    double maxMhz = 0.0;            // highest cpuinfo_max_freq
+    int throttlingCores = 0;
+    // Cost of the last update: files read out of all open ones, and time
+    size_t filesRead = 0;
+    size_t filesOpen = 0;
+    double updateMicros = 0.0;
+    bool valid = false;
+};
+
+// Per-core clock and thermal throttling from Linux sysfs
+// (/sys/devices/system/cpu/cpuN/cpufreq and thermal_throttle). Every file
+// stays open. On x86 a scaling_cur_freq read can cost an IPI to the core,
+// so an update reads files round-robin until the time budget is spent and
+// keeps the previous values for the rest; with many cores a full sweep
+// takes a few ticks instead of one slow one. On other platforms open()
+// fails.
+class CpuFreqCollector {
+public:
+    CpuFreqCollector() = default;
+    ~CpuFreqCollector();
+
+    CpuFreqCollector(const CpuFreqCollector&) = delete;
+    CpuFreqCollector& operator=(const CpuFreqCollector&) = delete;
+
+    bool open(const std::string& root = "/sys/devices/system/cpu");
+    void close();
+    bool available() const { return !files_.empty(); }
+
+    void setBudget(std::chrono::microseconds budget) { budget_ = budget; }
+    void update(CpuFreqMetrics& out);
+
+private:
+    static constexpr std::chrono::microseconds DEFAULT_BUDGET{1000};
+    // The clock is checked once per this many files
+    static const size_t BUDGET_CHECK_INTERVAL = 16;
+
+    enum Kind : uint8_t {
+        CUR_FREQ,
+        CORE_THROTTLES,
+        PACKAGE_THROTTLES
+    };
+
+    struct File {
+        int fd;
+        uint32_t core;
+        Kind kind;
+    };
+
+    std::vector<File> files_;           // frequencies first, then counters
+    std::vector<CpuFreqCoreMetrics> cores_;
+    size_t cursor_ = 0;
+    std::chrono::microseconds budget_ = DEFAULT_BUDGET;
+};
+
+#endif //OSXVIEW_CPUFREQCOLLECTOR_H
@@ -0,0 +1,111 @@
+#include "CpuGovernor.h"
+
+namespace {
+
+const double WINDOW_SECONDS = 5.0;
+const double RESTORE_FRACTION = 0.8;
+const int RESTORE_WINDOWS = 2;
+const int MAX_SLOWDOWN = 8;
+// Sched is the CPU source on Linux
+const uint32_t PROTECTED_SUBSYSTEMS = SUBSYSTEM_CPU | SUBSYSTEM_SCHED | SUBSYSTEM_MEMORY | SUBSYSTEM_SELF;
+
+// Indexed by bit position
+const char* const kSubsystemNames[SUBSYSTEM_COUNT] = {
+    "cpu", "mem", "swap", "gpu", "net", "disk", "sysinfo", "battery", "fans",
+    "cgroups", "sched", "tcp", "numa", "cpufreq", "temp", "perf", "self",
+};
+
+} // namespace
+
+CpuGovernor::CpuGovernor(double budgetPercent)
+    : budget_(budgetPercent) {
+}
+
+void CpuGovernor::observe(const SystemMetrics& metrics, uint32_t subsystems, std::chrono::milliseconds interval) {
+    const auto now = std::chrono::steady_clock::now();
+    const SelfMetrics& self = metrics.getSelfMetrics();
+    const bool first = lastObserved_ == std::chrono::steady_clock::time_point();
+    const double seconds = std::chrono::duration<double>(now - lastObserved_).count();
+    lastObserved_ = now;
+    if (first || !self.valid) {
+        return;
+    }
+    windowCpu_ += self.cpuPercent * seconds;
+    windowSeconds_ += seconds;
+    if (windowSeconds_ < WINDOW_SECONDS) {
+        return;
+    }
+    usage_ = windowCpu_ / windowSeconds_;
+    windowCpu_ = 0.0;
+    windowSeconds_ = 0.0;
+
+    if (usage_ > budget_) {
+        calmWindows_ = 0;
+        escalate(metrics, subsystems, interval);
+        return;
+    }
+    if (steps_.empty()) {
+        return;
+    }
+
+    // Halving the rate roughly halved the usage; a collector's share was
+    // measured when it was switched off
+    const Step& last = steps_.back();
+    const double predicted = last.subsystem != 0 ? usage_ + last.savedPercent : usage_ * 2.0;
+    if (predicted >= budget_ * RESTORE_FRACTION) {
+        calmWindows_ = 0;
+        return;
+    }
+    if (++calmWindows_ < RESTORE_WINDOWS) {
+        return;
+    }
+    if (last.subsystem != 0) {
+        disabled_ &= ~last.subsystem;
+    } else {
+        slowdown_ /= 2;
+    }
+    steps_.pop_back();
+    calmWindows_ = 0;
+}
+
+void CpuGovernor::escalate(const SystemMetrics& metrics, uint32_t subsystems, std::chrono::milliseconds interval) {
+    // The costliest collector still running, as a share of one core at the
+    // current sample rate
+    const double intervalMicros = static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(interval).count());
+    uint32_t candidate = 0;
+    double candidateShare = 0.0;
+    const uint32_t optional = subsystems & ~disabled_ & ~PROTECTED_SUBSYSTEMS;
+    for (int bit = 0; bit < SUBSYSTEM_COUNT; ++bit) {
+        const uint32_t subsystem = 1u << bit;
+        if (!(optional & subsystem) || intervalMicros <= 0.0) {
+            continue;
+        }
+        const double share = metrics.updateCostMicros(subsystem) / intervalMicros * 100.0;
+        if (share > candidateShare) {
+            candidate = subsystem;
+            candidateShare = share;
+        }
+    }
+
+    if (candidate != 0 && (candidateShare >= usage_ / 3.0 || slowdown_ >= MAX_SLOWDOWN)) {
+        disabled_ |= candidate;
+        steps_.push_back({candidate, candidateShare});
+    } else if (slowdown_ < MAX_SLOWDOWN) {
+        slowdown_ *= 2;
+        steps_.push_back({0, usage_ / 2.0});
+    }
+}
+
+std::string CpuGovernor::status() const {
+    std::string text;
+    if (slowdown_ > 1) {
+        text = "x" + std::to_string(slowdown_);
+    }
+    for (int bit = 0; bit < SUBSYSTEM_COUNT; ++bit) {
+        if (disabled_ & (1u << bit)) {
+            text += text.empty() ? "-" : " -";
+            text += kSubsystemNames[bit];
+        }
+    }
+    return text;
+}
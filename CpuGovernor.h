@@ -0,0 +1,53 @@
+#ifndef OSXVIEW_CPUGOVERNOR_H
+#define OSXVIEW_CPUGOVERNOR_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "SystemMetrics.h"
+
+// Keeps OSXview's own CPU use (SelfMetrics, percent of one core) under a
+// budget. Usage is averaged over 5 s windows; each window over budget adds
+// one step: switching off the costliest optional collector when it is at
+// least a third of the sampling cost, otherwise halving the sample rate
+// (down to 1/8). Steps are undone newest first once the usage predicted
+// with the step undone stays under 80% of the budget for two windows, so
+// the governor does not flap between two levels. CPU, memory and the self
+// meter itself are never switched off.
+class CpuGovernor {
+public:
+    explicit CpuGovernor(double budgetPercent);
+
+    // After every sample; subsystems is what was asked of SystemMetrics
+    void observe(const SystemMetrics& metrics, uint32_t subsystems, std::chrono::milliseconds interval);
+
+    std::chrono::milliseconds interval(std::chrono::milliseconds base) const { return base * slowdown_; }
+    uint32_t filter(uint32_t subsystems) const { return subsystems & ~disabled_; }
+
+    double budget() const { return budget_; }
+    double usage() const { return usage_; }
+    bool throttled() const { return !steps_.empty(); }
+    // "x2 -tcp -cgroups", empty when not throttled
+    std::string status() const;
+
+private:
+    struct Step {
+        uint32_t subsystem;     // 0: the sample rate was halved
+        double savedPercent;    // usage the step took away, as estimated then
+    };
+
+    void escalate(const SystemMetrics& metrics, uint32_t subsystems, std::chrono::milliseconds interval);
+
+    double budget_;
+    double usage_ = 0.0;
+    double windowCpu_ = 0.0;    // percent-seconds
+    double windowSeconds_ = 0.0;
+    int calmWindows_ = 0;
+    int slowdown_ = 1;
+    uint32_t disabled_ = 0;
+    std::vector<Step> steps_;
+    std::chrono::steady_clock::time_point lastObserved_;
+};
+
+#endif //OSXVIEW_CPUGOVERNOR_H
@@ -1,81 +1,26 @@
 #include "Display.h"
+#include "Snapshot.h"
+#include "StartupCache.h"
+#include "Trace.h"
 #include <algorithm>
-#include <iomanip>
-#include <sstream>
+#include <cstdio>
+#include <cstring>
 #include <cmath>
-#include <unordered_map>
 #include <chrono>
+#include <functional>
+#include <sys/stat.h>
 
 namespace {
 
-struct CachedTextEntry {
-    SDL_Texture* texture = nullptr;
-    int width = 0;
-    int height = 0;
-};
-
-std::unordered_map<std::string, CachedTextEntry> gTextCache;
-int gActiveFontSize = 0;
-
-void clearTextCache() {
-    for (auto& entry : gTextCache) {
-        if (entry.second.texture) {
-            SDL_DestroyTexture(entry.second.texture);
-        }
-    }
-    gTextCache.clear();
-}
-
-void setActiveFontSize(int fontSize) {
-    if (fontSize != gActiveFontSize) {
-        clearTextCache();
-        gActiveFontSize = fontSize;
+// Names the font file's contents and the rasterizer, for the glyph cache
+std::string fontCacheKey(const std::string& path) {
+    struct stat info;
+    if (path.empty() || stat(path.c_str(), &info) != 0) {
+        return std::string();
     }
-}
-
-std::string makeCacheKey(const std::string& text, const SDL_Color& color) {
-    std::ostringstream oss;
-    oss << gActiveFontSize << '|'
-        << static_cast<int>(color.r) << ','
-        << static_cast<int>(color.g) << ','
-        << static_cast<int>(color.b) << ','
-        << static_cast<int>(color.a) << '|'
-        << text;
-    return oss.str();
-}
-
-CachedTextEntry* ensureCachedText(SDL_Renderer* renderer,
-                                  TTF_Font* font,
-                                  const std::string& text,
-                                  const SDL_Color& color) {
-    if (!renderer || !font) {
-        return nullptr;
-    }
-    
-    const std::string key = makeCacheKey(text, color);
-    auto it = gTextCache.find(key);
-    if (it == gTextCache.end()) {
-        SDL_Surface* surface = TTF_RenderText_Solid(font, text.c_str(), color);
-        if (!surface) {
-            return nullptr;
-        }
-        
-        SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-        if (!texture) {
-            SDL_FreeSurface(surface);
-            return nullptr;
-        }
-        
-        CachedTextEntry entry;
-        entry.texture = texture;
-        entry.width = surface->w;
-        entry.height = surface->h;
-        SDL_FreeSurface(surface);
-        
-        it = gTextCache.emplace(key, entry).first;
-    }
-    
-    return &it->second;
+    const SDL_version* ttf = TTF_Linked_Version();
+    return path + "|" + std::to_string(info.st_size) + "|" + std::to_string(info.st_mtime) + "|ttf" +
+           std::to_string(ttf->major) + "." + std::to_string(ttf->minor) + "." + std::to_string(ttf->patch);
 }
 
 } // namespace
@@ -107,7 +52,8 @@ Display::Display(int width, int height)
       batteryReserveColor_{203, 203, 69, 255},
       batteryACColor_{127, 219, 255, 255},
       irqColor_{255, 0, 0, 255},          // Red for IRQs
-      irqIdleColor_{0, 0, 0, 255} {       // Black for idle
+      irqIdleColor_{0, 0, 0, 255},        // Black for idle
+      alertColor_{255, 64, 64, 255} {     // Red outline for alerts
     updateLayout();
 }
 
@@ -135,6 +81,10 @@ bool Display::initialize() {
     }
     
     renderer_ = SDL_CreateRenderer(window_, -1, SDL_RENDERER_ACCELERATED);
+    if (!renderer_) {
+        // No GPU (e.g. X11 over ssh): SDL's software renderer draws into the window surface
+        renderer_ = SDL_CreateRenderer(window_, -1, SDL_RENDERER_SOFTWARE);
+    }
     if (!renderer_) {
         SDL_DestroyWindow(window_);
         TTF_Quit();
@@ -142,6 +92,13 @@ bool Display::initialize() {
         return false;
     }
     
+    // The software renderer keeps the window surface between frames, so only
+    // the meters that changed need repainting and presenting
+    SDL_RendererInfo rendererInfo;
+    if (SDL_GetRendererInfo(renderer_, &rendererInfo) == 0) {
+        damageTracking_ = (rendererInfo.flags & SDL_RENDERER_SOFTWARE) != 0;
+    }
+    
     // Get actual window size (might differ from requested due to DPI)
     SDL_GetWindowSize(window_, &width_, &height_);
     
@@ -155,42 +112,146 @@ bool Display::initialize() {
         height_ = drawableHeight;
     }
     
-    // Update layout with actual window dimensions
-    handleResize(width_, height_);
-    // updateLayout();
+    // Update layout with actual window dimensions; this also makes the
+    // glyph atlas for its font size current
+    loadFont();
+    updateLayout();
+    return true;
+}
+
+bool Display::initializeOffscreen() {
+    // No video subsystem: the software renderer draws straight into a CPU
+    // surface, so this works on machines without a display
+    if (TTF_Init() < 0) {
+        return false;
+    }
+    
+    surface_ = SDL_CreateRGBSurfaceWithFormat(0, width_, height_, 32, SDL_PIXELFORMAT_ARGB8888);
+    if (!surface_) {
+        TTF_Quit();
+        return false;
+    }
+    
+    renderer_ = SDL_CreateSoftwareRenderer(surface_);
+    if (!renderer_) {
+        SDL_FreeSurface(surface_);
+        surface_ = nullptr;
+        TTF_Quit();
+        return false;
+    }
+    
+    loadFont();
+    updateLayout();
+    return true;
+}
+
+bool Display::saveSnapshot(const std::string& path) {
+    if (!renderer_) {
+        return false;
+    }
+    
+    int outputWidth = 0;
+    int outputHeight = 0;
+    if (SDL_GetRendererOutputSize(renderer_, &outputWidth, &outputHeight) != 0) {
+        return false;
+    }
     
-    // Load macOS system font - try common monospace fonts
+    const int pitch = outputWidth * 3;
+    std::vector<uint8_t> pixels(static_cast<size_t>(pitch) * outputHeight);
+    if (SDL_RenderReadPixels(renderer_, nullptr, SDL_PIXELFORMAT_RGB24, pixels.data(), pitch) != 0) {
+        return false;
+    }
+    return writeSnapshot(path, pixels.data(), outputWidth, outputHeight, pitch);
+}
+
+TTF_Font* Display::openDefaultFont(int fontSize, std::string* path) {
+    // macOS system monospace fonts first, then the common Linux ones
     const char* fontPaths[] = {
         "/System/Library/Fonts/Monaco.ttc",
         "/System/Library/Fonts/Menlo.ttc",
         "/System/Library/Fonts/Courier New.ttf",
         "/Library/Fonts/Courier New.ttf",
+        "/usr/share/fonts/truetype/dejavu/DejaVuSansMono.ttf",
+        "/usr/share/fonts/dejavu-sans-mono-fonts/DejaVuSansMono.ttf",
+        "/usr/share/fonts/TTF/DejaVuSansMono.ttf",
+        "/usr/share/fonts/truetype/liberation/LiberationMono-Regular.ttf",
         nullptr
     };
     
-    // Calculate initial font size
-    int initialFontSize = std::max(19, height_ / 20);
-    
     for (int i = 0; fontPaths[i]; i++) {
-        font_ = TTF_OpenFont(fontPaths[i], initialFontSize);
-        if (font_) {
-            break;
+        if (TTF_Font* font = TTF_OpenFont(fontPaths[i], fontSize)) {
+            if (path) {
+                *path = fontPaths[i];
+            }
+            return font;
         }
     }
     
+    // Fallback to default-font
+    const char* fallback = "/System/Library/Fonts/Helvetica.ttc";
+    TTF_Font* font = TTF_OpenFont(fallback, fontSize);
+    if (font && path) {
+        *path = fallback;
+    }
+    return font;
+}
+
+void Display::loadFont() {
+    TRACE_SCOPE("display.font");
+    // Take last run's font on trust. With its atlas for the window's size in
+    // the startup cache the font is not even opened until another size has
+    // to be rasterized; a font that has gone away is probed for again then.
+    const std::string directory = startupCacheDirectory();
+    std::string cached;
+    if (!directory.empty() && readCacheFile(directory + "/font", cached)) {
+        fontPath_ = cached;
+    }
+    glyphAtlas_.setDiskCache(directory, fontCacheKey(fontPath_));
+}
+
+bool Display::openFont(int fontSize) {
+    if (font_) {
+        return TTF_SetFontSize(font_, fontSize) == 0;
+    }
+    font_ = fontPath_.empty() ? nullptr : TTF_OpenFont(fontPath_.c_str(), fontSize);
+    if (font_) {
+        return true;
+    }
+    font_ = openDefaultFont(fontSize, &fontPath_);
     if (!font_) {
-        // Fallback to default-font
-        font_ = TTF_OpenFont("/System/Library/Fonts/Helvetica.ttc", initialFontSize);
+        return false;
     }
-    
-    setActiveFontSize(initialFontSize);
-    
+    const std::string directory = startupCacheDirectory();
+    if (!directory.empty()) {
+        writeCacheFile(directory + "/font", fontPath_);
+    }
+    glyphAtlas_.setDiskCache(directory, fontCacheKey(fontPath_));
     return true;
 }
 
+void Display::selectFontSize(int fontSize) {
+    if (!renderer_ || (glyphAtlas_.isReady() && fontSize == glyphAtlas_.fontSize())) {
+        return;
+    }
+    if (glyphAtlas_.loadCached(renderer_, fontSize)) {
+        return;
+    }
+    if (openFont(fontSize)) {
+        glyphAtlas_.build(renderer_, font_, fontSize);
+    }
+}
+
 void Display::cleanup() {
-    clearTextCache();
-    clearDynamicTextCache();
+    glyphAtlas_.release();
+    for (StripChart* chart : {&cpuChart_, &gpuChart_, &memChart_, &diskChart_, &netChart_, &batteryChart_, &swapChart_, &schedChart_, &tcpChart_, &ipcChart_, &selfChart_}) {
+        chart->release();
+    }
+    chartDraws_.clear();
+    if (chromeTexture_) {
+        SDL_DestroyTexture(chromeTexture_);
+        chromeTexture_ = nullptr;
+    }
+    chromeValid_ = false;
     
     if (font_) {
         TTF_CloseFont(font_);
@@ -204,39 +265,124 @@ void Display::cleanup() {
         SDL_DestroyWindow(window_);
         window_ = nullptr;
     }
+    if (surface_) {
+        SDL_FreeSurface(surface_);
+        surface_ = nullptr;
+    }
     TTF_Quit();
     SDL_Quit();
 }
 
 void Display::beginFrame() {
-    SDL_SetRenderDrawColor(renderer_, backgroundColor_.r, backgroundColor_.g, 
-                          backgroundColor_.b, backgroundColor_.a);
-    SDL_RenderClear(renderer_);
+    TRACE_SCOPE("display.beginFrame");
+    damage_.clear();
+    chartDraws_.clear();
+    if (!usePartialUpdates() || fullRepaint_) {
+        SDL_SetRenderDrawColor(renderer_, backgroundColor_.r, backgroundColor_.g, 
+                              backgroundColor_.b, backgroundColor_.a);
+        SDL_RenderClear(renderer_);
+    }
+    drawList_.begin(renderer_);
 }
 
 void Display::endFrame() {
-    SDL_RenderPresent(renderer_);
+    TRACE_SCOPE("display.endFrame");
+    if (!usePartialUpdates()) {
+        // Meter geometry first, then all text on top: two draw calls per frame
+        drawCharts();
+        drawList_.submit();
+        glyphAtlas_.flush(renderer_);
+        SDL_RenderPresent(renderer_);
+        return;
+    }
+    
+    if (fullRepaint_) {
+        drawCharts();
+        drawList_.submit();
+        glyphAtlas_.flush(renderer_);
+        SDL_RenderFlush(renderer_);
+        SDL_UpdateWindowSurface(window_);
+        fullRepaint_ = false;
+        return;
+    }
+    
+    if (damage_.empty()) {
+        // Nothing changed: no repaint and no present
+        return;
+    }
+    
+    // Restore the chrome under each damaged meter, redraw it and push only
+    // those rectangles to the screen
+    for (const SDL_Rect& rect : damage_) {
+        SDL_RenderCopy(renderer_, chromeTexture_, &rect, &rect);
+    }
+    drawCharts();
+    drawList_.submit();
+    glyphAtlas_.flush(renderer_);
+    SDL_RenderFlush(renderer_);
+    SDL_UpdateWindowSurfaceRects(window_, damage_.data(), static_cast<int>(damage_.size()));
+}
+
+void Display::invalidate() {
+    fullRepaint_ = true;
+}
+
+void Display::setGraphMode(bool enabled) {
+    if (graphMode_ != enabled) {
+        graphMode_ = enabled;
+        fullRepaint_ = true;
+    }
+}
+
+void Display::drawCharts() {
+    TRACE_SCOPE("display.charts");
+    for (const ChartDraw& draw : chartDraws_) {
+        draw.chart->draw(renderer_, draw.x, draw.y);
+    }
+}
+
+bool Display::usePartialUpdates() const {
+    return damageTracking_ && chromeTexture_ != nullptr && drawList_.mode() == DrawList::Mode::Batched;
+}
+
+SDL_Rect Display::meterDamageRect(int y) const {
+    // Whole row: value text on the left and both bars of the meter
+    const int textTop = y + meterHeight_/2 - charHeight_/2;
+    const int textBottom = textTop + std::max(charHeight_, glyphAtlas_.lineHeight());
+    const int top = std::max(0, std::min(y, textTop));
+    const int bottom = std::min(height_, std::max(y + meterHeight_, textBottom));
+    return SDL_Rect{0, top, width_, std::max(0, bottom - top)};
 }
 
 void Display::handleResize(int /* newWidth */, int /* newHeight */) {
     // Don't use the event size - get the actual drawable size
     // This ensures we use the correct size on high DPI displays
     int drawableWidth, drawableHeight;
-    SDL_GL_GetDrawableSize(window_, &drawableWidth, &drawableHeight);
+    if (!renderer_ || SDL_GetRendererOutputSize(renderer_, &drawableWidth, &drawableHeight) != 0) {
+        SDL_GL_GetDrawableSize(window_, &drawableWidth, &drawableHeight);
+    }
     
+    // RESIZED and SIZE_CHANGED arrive in pairs; only a real change needs a layout pass
+    if (drawableWidth == width_ && drawableHeight == height_) {
+        return;
+    }
     width_ = drawableWidth;
     height_ = drawableHeight;
     updateLayout();
 }
 
 void Display::updateLayout() {
+    TRACE_SCOPE("display.layout");
     // SDL_GetWindowSize(window_, &width_, &height_);
-    // Debug output
-    printf("Window size: %dx%d\n", width_, height_);
     
     // Exact calculations - no magic numbers
-    // Divide window height evenly for 5 meters with spacing
-    meterHeight_ = (height_ - (NUM_METERS + 1) * METER_SPACING) / NUM_METERS;
+    // Divide window height between the meters by weight, with spacing
+    int totalWeight = 0;
+    for (const MeterSpec& spec : meters_) {
+        totalWeight += spec.weight;
+    }
+    const int meterCount = static_cast<int>(meters_.size());
+    meterHeight_ = (height_ - (meterCount + 1) * METER_SPACING) / std::max(1, totalWeight);
     meterYStart_ = METER_SPACING;  // Add extra spacing at top
     
     // Calculate exact positions
@@ -246,56 +392,371 @@ void Display::updateLayout() {
     meterWidth_ = width_ - labelWidth_ - 40;  // Use remaining space for meters
     legendX_ = meterX_ + meterWidth_ + METER_SPACING;
     
-    printf("Meter width: %d (from x=%d to x=%d)\n", meterWidth_, meterX_, meterX_ + meterWidth_);
-    
     // Font size proportional to window
     int fontSize = std::max(19, height_ / 20);
-    if (font_) {
-        if (TTF_SetFontSize(font_, fontSize) == 0) {
-            setActiveFontSize(fontSize);
-            clearDynamicTextCache();
-        }
-    }
+    selectFontSize(fontSize);
     charWidth_ = fontSize * 0.6;   // Approximate character width
     charHeight_ = fontSize;
     
-    printf("Font size: %d (height=%d)\n", fontSize, height_);
-    
     // Ensure minimum sizes
     charWidth_ = std::max(8, charWidth_);
     charHeight_ = std::max(10, charHeight_);
     meterHeight_ = std::max(20, meterHeight_);
+    
+    slots_.clear();
+    int y = meterYStart_;
+    for (const MeterSpec& spec : meters_) {
+        const int height = meterHeight_ * spec.weight;
+        slots_.push_back({spec.kind, y, height});
+        y += height + METER_SPACING;
+    }
+    meterHashes_.assign(slots_.size(), 0);
+    
+    chromeValid_ = false;
+    fullRepaint_ = true;
 }
 
 void Display::draw(const SystemMetrics& metrics) {
-    // Draw each meter with calculated Y position
-    int y = meterYStart_;
-    
-    drawCPUMeter(metrics.getCPUMetrics(), y);
-    y += meterHeight_ + METER_SPACING;
+    TRACE_SCOPE("display.draw");
+    // Charts scroll once per collected sample, not once per repaint
+    newChartSample_ = metrics.sampleCount() != lastChartSample_;
+    lastChartSample_ = metrics.sampleCount();
+    
+    const ChromeState chromeState = chromeStateFor(metrics);
+    if (!chromeValid_ || chromeState != chromeState_) {
+        renderChrome(chromeState);
+        fullRepaint_ = true;
+    }
+    const bool partial = usePartialUpdates() && !fullRepaint_;
+    if (!partial) {
+        if (chromeTexture_) {
+            SDL_RenderCopy(renderer_, chromeTexture_, nullptr, nullptr);
+        } else {
+            // No render-target support: draw the chrome into the frame directly
+            drawChrome(chromeState);
+        }
+    }
     
-    drawGPUMeter(metrics.getGPUMetrics(), y);
-    y += meterHeight_ + METER_SPACING;
+    // Draw each meter with calculated Y position. With partial updates a
+    // meter whose emitted geometry and text hash to the same value as last
+    // frame is rolled back and its rectangle stays untouched.
+    for (size_t meterIndex = 0; meterIndex < slots_.size(); ++meterIndex) {
+        const MeterSlot& slot = slots_[meterIndex];
+        const int y = slot.y;
+        meterHeight_ = slot.height;
+        
+        const size_t rectMark = drawList_.mark();
+        const size_t textMark = glyphAtlas_.mark();
+        const size_t chartMark = chartDraws_.size();
+        drawMeter(slot.kind, metrics, y);
+        if (alertedMeters_ & (1u << static_cast<uint32_t>(slot.kind))) {
+            const SDL_Rect row = meterDamageRect(y);
+            drawList_.strokeRect(SDL_Rect{1, row.y, width_ - 2, row.h}, alertColor_);
+        }
+        
+        if (damageTracking_) {
+            uint64_t hash = drawList_.hashSince(rectMark) * 31 + glyphAtlas_.hashSince(textMark);
+            for (size_t i = chartMark; i < chartDraws_.size(); ++i) {
+                hash = hash * 31 + chartDraws_[i].chart->samples();
+            }
+            if (partial && meterHashes_[meterIndex] == hash) {
+                drawList_.rewind(rectMark);
+                glyphAtlas_.rewind(textMark);
+                chartDraws_.resize(chartMark);
+            } else {
+                meterHashes_[meterIndex] = hash;
+                damage_.push_back(meterDamageRect(y));
+            }
+        }
+    }
+}
+
+void Display::drawCluster(const std::vector<HostState>& hosts) {
+    TRACE_SCOPE("display.drawCluster");
+    // The whole grid changes every tick; no chrome or per-meter damage. The
+    // frame may not have been cleared if the software renderer was tracking
+    // damage, so paint the background as part of the batch.
+    fullRepaint_ = true;
+    drawList_.fillRect(SDL_Rect{0, 0, width_, height_}, backgroundColor_);
+    if (hosts.empty()) {
+        drawText(LABEL_PADDING_X, height_/2 - charHeight_/2, "Waiting for agents...", labelColor_);
+        return;
+    }
     
-    drawMemoryMeter(metrics.getMemoryMetrics(), y);
-    y += meterHeight_ + METER_SPACING;
+    // Pick the column count that makes cells closest to 2:1
+    const int count = static_cast<int>(hosts.size());
+    int columns = std::max(1, static_cast<int>(std::lround(std::sqrt(count * width_ / (2.0 * height_)))));
+    columns = std::min(columns, count);
+    const int rows = (count + columns - 1) / columns;
+    const int cellWidth = width_ / columns;
+    const int cellHeight = height_ / rows;
+    
+    // Four bars, plus the host name when there is room for it
+    const int lineHeight = std::max(charHeight_, glyphAtlas_.lineHeight());
+    const bool showNames = cellHeight >= lineHeight + 4 * 8;
+    const int barsTop = showNames ? lineHeight : 1;
+    const int barHeight = (cellHeight - barsTop - 2) / 4;
+    if (barHeight < 5 || cellWidth < 12) {
+        drawText(LABEL_PADDING_X, height_/2 - charHeight_/2, "Window too small", labelColor_);
+        return;
+    }
     
-    drawDiskMeter(metrics.getDiskMetrics(), y);
-    y += meterHeight_ + METER_SPACING;
+    const auto now = std::chrono::steady_clock::now();
+    const SDL_Color cellColor{32, 32, 48, 255};
+    const SDL_Color staleColor{96, 32, 32, 255};
+    const std::vector<SDL_Color> cpuColors = {cpuUserColor_, cpuSystemColor_, cpuIdleColor_};
+    const std::vector<SDL_Color> memColors = {memUsedColor_, memFreeColor_};
+    const std::vector<SDL_Color> netColors = {netInColor_, netOutColor_, netIdleColor_};
+    const std::vector<SDL_Color> diskColors = {diskReadColor_, diskWriteColor_, diskIdleColor_};
+    std::vector<double> values;
+    
+    // Same log scales as the single-host NET and DSK meters
+    auto split = [&values](double first, double second, double maxBytes) {
+        const double total = first + second;
+        const double pct = total > 0.0 ? std::min(100.0, std::log10(1.0 + total) / std::log10(1.0 + maxBytes) * 100.0) : 0.0;
+        values.assign({total > 0.0 ? pct * first / total : 0.0, total > 0.0 ? pct * second / total : 0.0, 100.0 - pct});
+    };
     
-    drawNetworkMeter(metrics.getNetworkMetrics(), y);
-    y += meterHeight_ + METER_SPACING;
+    for (int i = 0; i < count; ++i) {
+        const HostState& host = hosts[static_cast<size_t>(i)];
+        const HostSnapshot& snapshot = host.snapshot;
+        const int cellX = (i % columns) * cellWidth;
+        const int cellY = (i / columns) * cellHeight;
+        const bool stale = now - host.lastSeen > std::chrono::seconds(5);
+        drawList_.fillRect(SDL_Rect{cellX + 1, cellY + 1, cellWidth - 2, cellHeight - 2}, stale ? staleColor : cellColor);
+        
+        if (showNames) {
+            std::string_view name = snapshot.name;
+            while (!name.empty() && glyphAtlas_.measure(name) > cellWidth - 6) {
+                name.remove_suffix(1);
+            }
+            drawText(cellX + 3, cellY + 1, name, stale ? labelColor_ : valueColor_);
+        }
+        
+        int barY = cellY + barsTop;
+        const double cpuIdle = std::max(0.0, 100.0 - snapshot.cpuUser - snapshot.cpuSystem);
+        values.assign({snapshot.cpuUser, snapshot.cpuSystem, cpuIdle});
+        drawHorizontalMeter(cellX, barY, cellWidth, barHeight, values, cpuColors);
+        barY += barHeight;
+        
+        values.assign({snapshot.memUsed, std::max(0.0, 100.0 - snapshot.memUsed)});
+        drawHorizontalMeter(cellX, barY, cellWidth, barHeight, values, memColors);
+        barY += barHeight;
+        
+        split(snapshot.netIn, snapshot.netOut, 2.0 * 1024.0 * 1024.0 * 1024.0);
+        drawHorizontalMeter(cellX, barY, cellWidth, barHeight, values, netColors);
+        barY += barHeight;
+        
+        split(snapshot.diskRead, snapshot.diskWrite, 500.0 * 1024.0 * 1024.0);
+        drawHorizontalMeter(cellX, barY, cellWidth, barHeight, values, diskColors);
+    }
+}
 
-    drawFanMeter(metrics.getFanMetrics(), y);
-    y += meterHeight_ + METER_SPACING;
+void Display::drawMeter(MeterKind kind, const SystemMetrics& metrics, int y) {
+    switch (kind) {
+        case MeterKind::CPU:
+            drawCPUMeter(metrics.getCPUMetrics(), metrics.getCpuFreqMetrics(), y);
+            break;
+        case MeterKind::GPU:
+            drawGPUMeter(metrics.getGPUMetrics(), y);
+            break;
+        case MeterKind::Memory:
+            drawMemoryMeter(metrics.getMemoryMetrics(), y);
+            break;
+        case MeterKind::Swap:
+            drawSwapMeter(metrics.getSwapMetrics(), y);
+            break;
+        case MeterKind::Disk:
+            drawDiskMeter(metrics.getDiskMetrics(), y);
+            break;
+        case MeterKind::Network:
+            drawNetworkMeter(metrics.getNetworkMetrics(), y);
+            break;
+        case MeterKind::Fan:
+            drawFanMeter(metrics.getFanMetrics(), y);
+            break;
+        case MeterKind::Battery:
+            drawBatteryMeter(metrics.getBatteryMetrics(), y);
+            break;
+        case MeterKind::IRQ:
+            drawIRQMeter(metrics.getIRQCount(), y);
+            break;
+        case MeterKind::Cgroups:
+            drawCgroupMeter(metrics, y);
+            break;
+        case MeterKind::Sched:
+            drawSchedMeter(metrics.getSchedMetrics(), y);
+            break;
+        case MeterKind::Tcp:
+            drawTcpMeter(metrics.getTcpMetrics(), y);
+            break;
+        case MeterKind::Numa:
+            drawNumaMeter(metrics.getNumaMetrics(), y);
+            break;
+        case MeterKind::Temperature:
+            drawTemperatureMeter(metrics.getTemperatureMetrics(), y);
+            break;
+        case MeterKind::Ipc:
+            drawIpcMeter(metrics.getPerfMetrics(), y);
+            break;
+        case MeterKind::Self:
+            drawSelfMeter(metrics.getSelfMetrics(), y);
+            break;
+    }
+}
+
+void Display::setMeters(const std::vector<MeterSpec>& meters) {
+    if (meters.empty()) {
+        return;
+    }
+    meters_ = meters;
+    updateLayout();
+}
+
+Display::ChromeState Display::chromeStateFor(const SystemMetrics& metrics) const {
+    ChromeState state;
+    const BatteryMetrics battery = metrics.getBatteryMetrics();
+    if (battery.isPresent) {
+        if (battery.onACPower) {
+            state.batteryLabel = "PWR";
+        } else if (battery.isCharging) {
+            state.batteryLabel = "CHG";
+        } else {
+            state.batteryLabel = "BAT";
+        }
+    }
+    state.batteryOnAC = battery.onACPower;
+    state.fanLegendCount = std::min<size_t>(metrics.getFanMetrics().size(), 2);
+    return state;
+}
+
+void Display::renderChrome(const ChromeState& state) {
+    TRACE_SCOPE("display.chrome");
+    chromeState_ = state;
+    chromeValid_ = true;
+    if (!renderer_) {
+        return;
+    }
+    
+    if (chromeTexture_ && (chromeWidth_ != width_ || chromeHeight_ != height_)) {
+        SDL_DestroyTexture(chromeTexture_);
+        chromeTexture_ = nullptr;
+    }
+    if (!chromeTexture_) {
+        chromeTexture_ = SDL_CreateTexture(renderer_, SDL_PIXELFORMAT_ARGB8888,
+                                           SDL_TEXTUREACCESS_TARGET, width_, height_);
+        chromeWidth_ = width_;
+        chromeHeight_ = height_;
+    }
+    if (!chromeTexture_ || SDL_SetRenderTarget(renderer_, chromeTexture_) != 0) {
+        if (chromeTexture_) {
+            SDL_DestroyTexture(chromeTexture_);
+            chromeTexture_ = nullptr;
+        }
+        return;
+    }
     
-    drawBatteryMeter(metrics.getBatteryMetrics(), y);
+    SDL_SetRenderDrawColor(renderer_, backgroundColor_.r, backgroundColor_.g,
+                          backgroundColor_.b, backgroundColor_.a);
+    SDL_RenderClear(renderer_);
+    drawList_.begin(renderer_);
+    drawChrome(state);
+    drawList_.submit();
+    glyphAtlas_.flush(renderer_);
+    SDL_SetRenderTarget(renderer_, nullptr);
+    drawList_.begin(renderer_);
 }
 
-void Display::drawCPUMeter(const std::vector<CPUMetrics>& metrics, int y) {
-    // Draw label and value at calculated positions
-    drawText(LABEL_PADDING_X, y + meterHeight_/2 - charHeight_/2, "CPU", labelColor_);
+void Display::drawChrome(const ChromeState& state) {
+    // Labels, legends and meter borders only change with the layout (and the
+    // few states captured in ChromeState), so they are drawn once into the
+    // chrome texture instead of every frame.
+    const int meterX = labelWidth_ + LABEL_TO_METER_SPACING;
+    const int legendYOffset = -charHeight_ - 5;
     
+    for (const MeterSlot& slot : slots_) {
+        const int y = slot.y;
+        meterHeight_ = slot.height;
+        
+        auto meterChrome = [&](std::string_view label,
+                               const std::vector<std::string>& legendLabels,
+                               const std::vector<SDL_Color>& legendColors) {
+            drawText(LABEL_PADDING_X, y + meterHeight_/2 - charHeight_/2, label, labelColor_);
+            if (!legendLabels.empty()) {
+                drawLegend(meterX, y + legendYOffset, legendLabels, legendColors);
+            }
+            drawMeterBorder(meterX, y, meterWidth_, meterHeight_);
+        };
+        
+        switch (slot.kind) {
+            case MeterKind::CPU:
+                meterChrome("CPU", {"USR", "SYS", "IDLE"}, {cpuUserColor_, cpuSystemColor_, cpuIdleColor_});
+                break;
+            case MeterKind::GPU:
+                meterChrome("GPU", {"DEV", "REND", "TILER", "IDLE"},
+                            {gpuDeviceColor_, gpuRendererColor_, gpuTilerColor_, gpuIdleColor_});
+                break;
+            case MeterKind::Memory:
+                meterChrome("MEM", {"USED", "BUFF", "SLAB", "FREE"},
+                            {memUsedColor_, memBufferColor_, memSlabColor_, memFreeColor_});
+                break;
+            case MeterKind::Swap:
+                meterChrome("SWP", {"USED", "FREE"}, {memUsedColor_, memFreeColor_});
+                break;
+            case MeterKind::Disk:
+                meterChrome("DSK", {"READ", "WRITE", "IDLE"}, {netInColor_, diskWriteColor_, cpuIdleColor_});
+                break;
+            case MeterKind::Network:
+                meterChrome("NET", {"IN", "OUT", "IDLE"}, {netInColor_, netOutColor_, cpuIdleColor_});
+                break;
+            case MeterKind::Fan: {
+                std::vector<std::string> fanLabels;
+                std::vector<SDL_Color> fanColors;
+                if (state.fanLegendCount > 0) {
+                    fanLabels.push_back("F0");
+                    fanColors.push_back(cpuUserColor_);
+                }
+                if (state.fanLegendCount > 1) {
+                    fanLabels.push_back("F1");
+                    fanColors.push_back(cpuSystemColor_);
+                }
+                meterChrome("FAN", fanLabels, fanColors);
+                break;
+            }
+            case MeterKind::Battery:
+                meterChrome(state.batteryLabel, {"CHG", "RES"},
+                            {state.batteryOnAC ? batteryACColor_ : batteryChargeColor_, batteryReserveColor_});
+                break;
+            case MeterKind::IRQ:
+                meterChrome("IRQS", {"IRQs per sec", "IDLE"}, {irqColor_, cpuIdleColor_});
+                break;
+            case MeterKind::Cgroups:
+                meterChrome("CGRP", {"CPU", "MEM"}, {cpuSystemColor_, memUsedColor_});
+                break;
+            case MeterKind::Sched:
+                meterChrome("SCHD", {"RUN", "WAIT", "IDLE"}, {cpuUserColor_, irqColor_, cpuIdleColor_});
+                break;
+            case MeterKind::Tcp:
+                meterChrome("TCP", {"EST", "TW", "OTH"}, {netInColor_, netOutColor_, irqColor_});
+                break;
+            case MeterKind::Numa:
+                meterChrome("NUMA", {"MEM", "RMT"}, {memUsedColor_, irqColor_});
+                break;
+            case MeterKind::Temperature:
+                meterChrome("TEMP", {"HEAT"}, {cpuSystemColor_});
+                break;
+            case MeterKind::Ipc:
+                meterChrome("IPC", {"IPC"}, {cpuUserColor_});
+                break;
+            case MeterKind::Self:
+                meterChrome("SELF", {"USR", "SYS"}, {cpuUserColor_, cpuSystemColor_});
+                break;
+        }
+    }
+}
+
+void Display::drawCPUMeter(const std::vector<CPUMetrics>& metrics, const CpuFreqMetrics& freq, int y) {
+    TRACE_SCOPE("draw.cpu");
     double user = 0, system = 0, idle = 100;
     if (!metrics.empty()) {
         user = metrics[0].user;
@@ -304,35 +765,52 @@ void Display::drawCPUMeter(const std::vector<CPUMetrics>& metrics, int y) {
     }
     
     // drawRightAlignedText(labelWidth_ + valueWidth_, y + meterHeight_/2 - charHeight_/2, formatValue(user + system, "%"), valueColor_);
-    drawRightAlignedDynamicText("cpu_total",
-                                labelWidth_ + 12,
-                                y + meterHeight_/2 - charHeight_/2,
-                                formatValue(user + system, "%"),
-                                valueColor_);
-
-    // Draw legend above the bar
-    std::vector<std::string> labels = {"USR", "SYS", "IDLE"};
-    std::vector<SDL_Color> colors = {cpuUserColor_, cpuSystemColor_, cpuIdleColor_};
-    drawLegend(labelWidth_ + LABEL_TO_METER_SPACING, y - charHeight_ - 5, labels, colors);
+    drawRightAlignedText(labelWidth_ + 12,
+                         y + meterHeight_/2 - charHeight_/2,
+                         formatValue(user + system, "%"),
+                         valueColor_);
     
     // Draw horizontal meter
     std::vector<double> values = {user, system, idle};
     updateHistory(cpuHistory_, values);
     std::vector<double> avgValues = computeHistoryAverage(cpuHistory_, values.size());
     std::vector<SDL_Color> meterColors = {cpuUserColor_, cpuSystemColor_, cpuIdleColor_};
-    drawHorizontalMeter(labelWidth_ + LABEL_TO_METER_SPACING, y, meterWidth_, meterHeight_, values, meterColors, &avgValues);
+    drawHorizontalMeter(labelWidth_ + LABEL_TO_METER_SPACING, y, meterWidth_, meterHeight_, values, meterColors, &avgValues, &cpuChart_);
+    
+    // Clock overlay along the bottom of the live bar: one cell per core
+    // filled to its share of the turbo ceiling, or the average when cores
+    // are too many to tell apart. Throttling cores are drawn in red.
+    if (!freq.valid || freq.maxMhz <= 0.0) {
+        return;
+    }
+    const int innerLeft = labelWidth_ + LABEL_TO_METER_SPACING + 2;
+    const int innerWidth = meterWidth_ - 6;
+    const int overlayHeight = std::min(3, std::max(1, (meterHeight_ - 4) / 6));
+    const int overlayY = y + 2 + (meterHeight_ - 4) / 2 - overlayHeight;
+    const int cores = static_cast<int>(freq.cores.size());
+    if (cores > 0 && innerWidth / cores >= 3) {
+        const int cellWidth = innerWidth / cores;
+        for (int i = 0; i < cores; ++i) {
+            const CpuFreqCoreMetrics& core = freq.cores[static_cast<size_t>(i)];
+            const double ceiling = core.maxMhz > 0.0 ? core.maxMhz : freq.maxMhz;
+            const int width = static_cast<int>((cellWidth - 1) * std::clamp(core.mhz / ceiling, 0.0, 1.0));
+            drawList_.fillRect(SDL_Rect{innerLeft + i * cellWidth, overlayY, std::max(1, width), overlayHeight},
+                               core.throttling ? alertColor_ : valueColor_);
+        }
+    } else {
+        const int width = static_cast<int>(innerWidth * std::clamp(freq.averageMhz / freq.maxMhz, 0.0, 1.0));
+        drawList_.fillRect(SDL_Rect{innerLeft, overlayY, width, overlayHeight},
+                           freq.throttlingCores > 0 ? alertColor_ : valueColor_);
+    }
 }
 
 void Display::drawFanMeter(const std::vector<FanMetrics>& metrics, int y) {
-    drawText(LABEL_PADDING_X, y + meterHeight_/2 - charHeight_/2, "FAN", labelColor_);
-
+    TRACE_SCOPE("draw.fan");
     if (metrics.empty()) {
-        drawRightAlignedDynamicText("fan_total",
-                                    labelWidth_ + 12,
-                                    y + meterHeight_/2 - charHeight_/2,
-                                    "N/A",
-                                    valueColor_);
-        drawMeterBorder(labelWidth_ + LABEL_TO_METER_SPACING, y, meterWidth_, meterHeight_);
+        drawRightAlignedText(labelWidth_ + 12,
+                             y + meterHeight_/2 - charHeight_/2,
+                             "N/A",
+                             valueColor_);
         return;
     }
 
@@ -367,31 +845,16 @@ void Display::drawFanMeter(const std::vector<FanMetrics>& metrics, int y) {
     }
 
     const double rpmDisplay = rpmCount > 0 ? (rpmSum / static_cast<double>(rpmCount)) : 0.0;
-    drawRightAlignedDynamicText("fan_total",
-                                labelWidth_ + 12,
-                                y + meterHeight_/2 - charHeight_/2,
-                                rpmCount > 0 ? formatValue(rpmDisplay, "") : "N/A",
-                                valueColor_);
-
-    std::vector<std::string> labels;
-    std::vector<SDL_Color> colors;
-    labels.push_back("F0");
-    colors.push_back(cpuUserColor_);
-    if (metrics.size() > 1) {
-        labels.push_back("F1");
-        colors.push_back(cpuSystemColor_);
-    }
-
-    drawLegend(meterX, y - charHeight_ - 5, labels, colors);
-    drawMeterBorder(meterX, y, meterWidth_, meterHeight_);
+    drawRightAlignedText(labelWidth_ + 12,
+                         y + meterHeight_/2 - charHeight_/2,
+                         rpmCount > 0 ? formatValue(rpmDisplay, "") : "N/A",
+                         valueColor_);
 
     if (innerWidth <= 0 || innerHeight <= 0) {
         return;
     }
 
-    SDL_SetRenderDrawColor(renderer_, 0, 0, 0, 255);
-    SDL_Rect backgroundRect{innerLeft, innerTop, innerWidth, innerHeight};
-    SDL_RenderFillRect(renderer_, &backgroundRect);
+    drawList_.fillRect(SDL_Rect{innerLeft, innerTop, innerWidth, innerHeight}, SDL_Color{0, 0, 0, 255});
 
     const double pct0 = fanPercent(0);
     const double pct1 = fanPercent(1);
@@ -399,61 +862,31 @@ void Display::drawFanMeter(const std::vector<FanMetrics>& metrics, int y) {
     if (topHeight > 0) {
         int fillWidth = static_cast<int>(pct0 / 100.0 * innerWidth);
         if (fillWidth > 0) {
-            SDL_Color color = cpuUserColor_;
-            SDL_SetRenderDrawColor(renderer_, color.r, color.g, color.b, color.a);
-            SDL_Rect fillRect{innerLeft, innerTop, fillWidth, topHeight};
-            SDL_RenderFillRect(renderer_, &fillRect);
+            drawList_.fillRect(SDL_Rect{innerLeft, innerTop, fillWidth, topHeight}, cpuUserColor_);
         }
     }
 
     if (bottomHeight > 0 && metrics.size() > 1) {
         int fillWidth = static_cast<int>(pct1 / 100.0 * innerWidth);
         if (fillWidth > 0) {
-            SDL_Color color = cpuSystemColor_;
-            SDL_SetRenderDrawColor(renderer_, color.r, color.g, color.b, color.a);
-            SDL_Rect fillRect{innerLeft, innerTop + topHeight, fillWidth, bottomHeight};
-            SDL_RenderFillRect(renderer_, &fillRect);
+            drawList_.fillRect(SDL_Rect{innerLeft, innerTop + topHeight, fillWidth, bottomHeight}, cpuSystemColor_);
         }
     }
 }
 
 void Display::drawBatteryMeter(const BatteryMetrics& metrics, int y) {
-    std::ostringstream LABEL;
-    if (!metrics.isPresent) {
-        LABEL << "N/A";
-    } else {
-        if (metrics.onACPower) {
-            LABEL << "PWR";
-        } else if (metrics.isCharging) {
-            LABEL << "CHG";
-        } else {
-            LABEL << "BAT";
-        }
-    }
-
-    drawText(LABEL_PADDING_X, y + meterHeight_/2 - charHeight_/2, LABEL.str(), labelColor_);
-
-    std::string valStr;
-    if (!metrics.isPresent) {
-        valStr = "N/A";
-    } else {
-        std::ostringstream oss;
-        oss << std::fixed << std::setprecision(0) << metrics.chargePercent << "%";
-        valStr = oss.str();
-    }
+    TRACE_SCOPE("draw.battery");
+    std::string valStr = metrics.isPresent ? formatValue(metrics.chargePercent, "%") : "N/A";
 
-    drawRightAlignedDynamicText("battery_level",
-                                labelWidth_ + 12,
-                                y + meterHeight_/2 - charHeight_/2,
-                                valStr,
-                                valueColor_);
+    drawRightAlignedText(labelWidth_ + 12,
+                         y + meterHeight_/2 - charHeight_/2,
+                         valStr,
+                         valueColor_);
 
-    std::vector<std::string> labels = {"CHG", "RES"};
     std::vector<SDL_Color> colors = {
         metrics.onACPower ? batteryACColor_ : batteryChargeColor_,
         batteryReserveColor_
     };
-    drawLegend(labelWidth_ + LABEL_TO_METER_SPACING, y - charHeight_ - 5, labels, colors);
 
     double charge = metrics.isPresent ? std::clamp(metrics.chargePercent, 0.0, 100.0) : 0.0;
     double reserve = std::max(0.0, 100.0 - charge);
@@ -467,12 +900,12 @@ void Display::drawBatteryMeter(const BatteryMetrics& metrics, int y) {
                         meterHeight_,
                         values,
                         colors,
-                        metrics.isPresent ? &avgValues : nullptr);
+                        metrics.isPresent ? &avgValues : nullptr,
+                        metrics.isPresent ? &batteryChart_ : nullptr);
 }
 
 void Display::drawGPUMeter(const GPUMetrics& metrics, int y) {
-    drawText(LABEL_PADDING_X, y + meterHeight_/2 - charHeight_/2, "GPU", labelColor_);
-    
+    TRACE_SCOPE("draw.gpu");
     const bool valid = metrics.valid;
     double device = valid ? std::clamp(metrics.deviceUtilization, 0.0, 100.0) : 0.0;
     double renderer = valid ? std::clamp(metrics.rendererUtilization, 0.0, 100.0) : 0.0;
@@ -480,20 +913,17 @@ void Display::drawGPUMeter(const GPUMetrics& metrics, int y) {
     double idle = valid ? std::max(0.0, 100.0 - std::min(100.0, device + renderer + tiler))
                         : 100.0;
     
-    drawRightAlignedDynamicText("gpu_total",
-                                labelWidth_ + 12,
-                                y + meterHeight_/2 - charHeight_/2,
-                                valid ? formatValue(device, "%") : "N/A",
-                                valueColor_);
+    drawRightAlignedText(labelWidth_ + 12,
+                         y + meterHeight_/2 - charHeight_/2,
+                         valid ? formatValue(device, "%") : "N/A",
+                         valueColor_);
     
-    std::vector<std::string> labels = {"DEV", "REND", "TILER", "IDLE"};
     std::vector<SDL_Color> colors = {
         gpuDeviceColor_,
         gpuRendererColor_,
         gpuTilerColor_,
         gpuIdleColor_
     };
-    drawLegend(labelWidth_ + LABEL_TO_METER_SPACING, y - charHeight_ - 5, labels, colors);
     
     std::vector<double> values = {device, renderer, tiler, idle};
     updateHistory(gpuHistory_, values);
@@ -504,24 +934,18 @@ void Display::drawGPUMeter(const GPUMetrics& metrics, int y) {
                         meterHeight_,
                         values,
                         colors,
-                        valid ? &avgValues : nullptr);
+                        valid ? &avgValues : nullptr,
+                        valid ? &gpuChart_ : nullptr);
 }
 
 void Display::drawMemoryMeter(const MemoryMetrics& metrics, int y) {
-    // Draw label and value
-    drawText(LABEL_PADDING_X, y + meterHeight_/2 - charHeight_/2, "MEM", labelColor_);
-    
+    TRACE_SCOPE("draw.memory");
+    // Draw value
     double usedGB = metrics.used / (1024.0 * 1024.0 * 1024.0);
-    drawRightAlignedDynamicText("mem_used",
-                                labelWidth_ + 12,
-                                y + meterHeight_/2 - charHeight_/2,
-                                formatValue(usedGB, "G"),
-                                valueColor_);
-    
-    // Draw legend above the bar
-    std::vector<std::string> labels = {"USED", "BUFF", "SLAB", "FREE"};
-    std::vector<SDL_Color> colors = {memUsedColor_, memBufferColor_, memSlabColor_, memFreeColor_};
-    drawLegend(labelWidth_ + LABEL_TO_METER_SPACING, y - charHeight_ - 5, labels, colors);
+    drawRightAlignedText(labelWidth_ + 12,
+                         y + meterHeight_/2 - charHeight_/2,
+                         formatValue(usedGB, "G"),
+                         valueColor_);
     
     // Calculate memory components
     double used = metrics.total > 0 ? (double)metrics.used / metrics.total * 100.0 : 0.0;
@@ -544,24 +968,62 @@ void Display::drawMemoryMeter(const MemoryMetrics& metrics, int y) {
     updateHistory(memHistory_, values);
     std::vector<double> avgValues = computeHistoryAverage(memHistory_, values.size());
     std::vector<SDL_Color> meterColors = {memUsedColor_, memBufferColor_, memSlabColor_, memFreeColor_};
-    drawHorizontalMeter(labelWidth_ + LABEL_TO_METER_SPACING, y, meterWidth_, meterHeight_, values, meterColors, &avgValues);
+    drawHorizontalMeter(labelWidth_ + LABEL_TO_METER_SPACING, y, meterWidth_, meterHeight_, values, meterColors, &avgValues, &memChart_);
+}
+
+void Display::drawSwapMeter(const MemoryMetrics& metrics, int y) {
+    TRACE_SCOPE("draw.swap");
+    double usedGB = metrics.used / (1024.0 * 1024.0 * 1024.0);
+    drawRightAlignedText(labelWidth_ + 12,
+                         y + meterHeight_/2 - charHeight_/2,
+                         metrics.total > 0 ? formatValue(usedGB, "G") : "N/A",
+                         valueColor_);
+    
+    double used = metrics.total > 0 ? std::min(100.0, (double)metrics.used / metrics.total * 100.0) : 0.0;
+    std::vector<double> values = {used, 100.0 - used};
+    updateHistory(swapHistory_, values);
+    std::vector<double> avgValues = computeHistoryAverage(swapHistory_, values.size());
+    std::vector<SDL_Color> meterColors = {memUsedColor_, memFreeColor_};
+    drawHorizontalMeter(labelWidth_ + LABEL_TO_METER_SPACING, y, meterWidth_, meterHeight_, values, meterColors, &avgValues, &swapChart_);
+}
+
+void Display::drawSchedMeter(const SchedMetrics& metrics, int y) {
+    TRACE_SCOPE("draw.sched");
+    // Mean time a task waited on a run queue before getting a CPU
+    std::string latency = "N/A";
+    if (metrics.valid) {
+        char buffer[32];
+        if (metrics.latencyUs < 1000.0) {
+            std::snprintf(buffer, sizeof(buffer), "%.0fus", metrics.latencyUs);
+        } else {
+            std::snprintf(buffer, sizeof(buffer), "%.1fms", metrics.latencyUs / 1000.0);
+        }
+        latency = buffer;
+    }
+    drawRightAlignedText(labelWidth_ + 12,
+                         y + meterHeight_/2 - charHeight_/2,
+                         latency,
+                         valueColor_);
+    
+    // Waiting can add up to more than a CPU's worth of time; the bar shows
+    // as much of it as fits beside the running time
+    const double run = metrics.valid ? std::clamp(metrics.busyPercent, 0.0, 100.0) : 0.0;
+    const double wait = metrics.valid ? std::clamp(metrics.waitPercent, 0.0, 100.0 - run) : 0.0;
+    std::vector<double> values = {run, wait, 100.0 - run - wait};
+    updateHistory(schedHistory_, values);
+    std::vector<double> avgValues = computeHistoryAverage(schedHistory_, values.size());
+    std::vector<SDL_Color> meterColors = {cpuUserColor_, irqColor_, cpuIdleColor_};
+    drawHorizontalMeter(labelWidth_ + LABEL_TO_METER_SPACING, y, meterWidth_, meterHeight_, values, meterColors, &avgValues, &schedChart_);
 }
 
 void Display::drawDiskMeter(const DiskMetrics& metrics, int y) {
-    // Draw label and value
-    drawText(LABEL_PADDING_X, y + meterHeight_/2 - charHeight_/2, "DSK", labelColor_);
-    
+    TRACE_SCOPE("draw.disk");
+    // Draw value
     std::string valStr = formatBytes(metrics.readBytes + metrics.writeBytes);
-    drawRightAlignedDynamicText("disk_total",
-                                labelWidth_ + 12,
-                                y + meterHeight_/2 - charHeight_/2,
-                                valStr,
-                                valueColor_);
-    
-    // Draw legend above the bar
-    std::vector<std::string> labels = {"READ", "WRITE", "IDLE"};
-    std::vector<SDL_Color> colors = {netInColor_, diskWriteColor_, cpuIdleColor_};
-    drawLegend(labelWidth_ + LABEL_TO_METER_SPACING, y - charHeight_ - 5, labels, colors);
+    drawRightAlignedText(labelWidth_ + 12,
+                         y + meterHeight_/2 - charHeight_/2,
+                         valStr,
+                         valueColor_);
     
     // Calculate disk usage using a logarithmic scale to avoid instant saturation
     double maxBytes = 500.0 * 1024.0 * 1024.0; // 500MB/s as ~100%
@@ -590,24 +1052,17 @@ void Display::drawDiskMeter(const DiskMetrics& metrics, int y) {
     updateHistory(diskHistory_, values);
     std::vector<double> avgValues = computeHistoryAverage(diskHistory_, values.size());
     std::vector<SDL_Color> meterColors = {diskReadColor_, diskWriteColor_, diskIdleColor_};
-    drawHorizontalMeter(labelWidth_ + LABEL_TO_METER_SPACING, y, meterWidth_, meterHeight_, values, meterColors, &avgValues);
+    drawHorizontalMeter(labelWidth_ + LABEL_TO_METER_SPACING, y, meterWidth_, meterHeight_, values, meterColors, &avgValues, &diskChart_);
 }
 
 void Display::drawNetworkMeter(const NetworkMetrics& metrics, int y) {
-    // Draw label and value
-    drawText(LABEL_PADDING_X, y + meterHeight_/2 - charHeight_/2, "NET", labelColor_);
-    
+    TRACE_SCOPE("draw.network");
+    // Draw value
     std::string valStr = formatBytes(metrics.bytesIn + metrics.bytesOut);
-    drawRightAlignedDynamicText("net_total",
-                                labelWidth_ + 12,
-                                y + meterHeight_/2 - charHeight_/2,
-                                valStr,
-                                valueColor_);
-    
-    // Draw legend above the bar
-    std::vector<std::string> labels = {"IN", "OUT", "IDLE"};
-    std::vector<SDL_Color> colors = {netInColor_, netOutColor_, cpuIdleColor_};
-    drawLegend(labelWidth_ + LABEL_TO_METER_SPACING, y - charHeight_ - 5, labels, colors);
+    drawRightAlignedText(labelWidth_ + 12,
+                         y + meterHeight_/2 - charHeight_/2,
+                         valStr,
+                         valueColor_);
     
     // Calculate network usage using a logarithmic scale similar to disk
     double maxBytes = 2.0 * 1024.0 * 1024.0 * 1024.0; // 2GB/s ~= 100%
@@ -636,22 +1091,276 @@ void Display::drawNetworkMeter(const NetworkMetrics& metrics, int y) {
     updateHistory(netHistory_, values);
     std::vector<double> avgValues = computeHistoryAverage(netHistory_, values.size());
     std::vector<SDL_Color> meterColors = {netInColor_, netOutColor_, netIdleColor_};
-    drawHorizontalMeter(labelWidth_ + LABEL_TO_METER_SPACING, y, meterWidth_, meterHeight_, values, meterColors, &avgValues);
+    drawHorizontalMeter(labelWidth_ + LABEL_TO_METER_SPACING, y, meterWidth_, meterHeight_, values, meterColors, &avgValues, &netChart_);
+}
+
+void Display::drawTcpMeter(const TcpMetrics& metrics, int y) {
+    TRACE_SCOPE("draw.tcp");
+    // Value is the share of sent segments that were retransmits; it turns
+    // red on a retransmit storm or when a listen queue overflows
+    std::string valStr = "N/A";
+    SDL_Color color = valueColor_;
+    if (metrics.countersValid) {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.1f%%", metrics.retransPercent);
+        valStr = buffer;
+        if (metrics.retransPercent >= 1.0 || metrics.listenOverflows > 0.0 || metrics.listenDrops > 0.0) {
+            color = alertColor_;
+        }
+    }
+    drawRightAlignedText(labelWidth_ + 12,
+                         y + meterHeight_/2 - charHeight_/2,
+                         valStr,
+                         color);
+    
+    // Socket count on a log scale (100k ~= 100%), split by state so a
+    // pile-up of TIME_WAIT or CLOSE_WAIT sockets stands out
+    double est = 0.0;
+    double timeWait = 0.0;
+    double other = 0.0;
+    if (metrics.socketsValid && metrics.total > 0) {
+        const double total = static_cast<double>(metrics.total);
+        const double totalPct = std::min(100.0, std::log10(1.0 + total) / 5.0 * 100.0);
+        est = totalPct * metrics.established / total;
+        timeWait = totalPct * metrics.timeWait / total;
+        other = std::max(0.0, totalPct - est - timeWait);
+    }
+    double idle = std::max(0.0, 100.0 - est - timeWait - other);
+    
+    std::vector<double> values = {est, timeWait, other, idle};
+    updateHistory(tcpHistory_, values);
+    std::vector<double> avgValues = computeHistoryAverage(tcpHistory_, values.size());
+    std::vector<SDL_Color> meterColors = {netInColor_, netOutColor_, irqColor_, netIdleColor_};
+    drawHorizontalMeter(labelWidth_ + LABEL_TO_METER_SPACING, y, meterWidth_, meterHeight_, values, meterColors, &avgValues, &tcpChart_);
+}
+
+void Display::drawNumaMeter(const NumaMetrics& metrics, int y) {
+    TRACE_SCOPE("draw.numa");
+    // Value is the share of page allocations that landed off their
+    // preferred node
+    drawRightAlignedText(labelWidth_ + 12,
+                         y + meterHeight_/2 - charHeight_/2,
+                         metrics.ratesValid ? formatValue(metrics.remotePercent, "%") : "N/A",
+                         valueColor_);
+    if (metrics.nodes.empty()) {
+        return;
+    }
+    
+    // One row per node: memory fill, then the remote-allocation share.
+    // Rows shrink to thin bars without labels when the nodes don't fit.
+    const int meterX = labelWidth_ + LABEL_TO_METER_SPACING;
+    const int innerLeft = meterX + 2;
+    const int innerTop = y + 2;
+    const int innerWidth = meterWidth_ - 6;
+    const int innerHeight = meterHeight_ - 4;
+    const int textHeight = std::max(charHeight_, glyphAtlas_.lineHeight()) + 2;
+    const int nodes = static_cast<int>(metrics.nodes.size());
+    const int rowHeight = std::clamp(innerHeight / nodes, 1, textHeight);
+    const bool labels = rowHeight >= textHeight;
+    const int rows = std::min(nodes, std::max(1, innerHeight / rowHeight));
+    
+    const int nameWidth = labels ? charWidth_ * 4 : 0;
+    const int memWidth = (innerWidth - nameWidth) * 3 / 4 - 2;
+    const int remoteWidth = innerWidth - nameWidth - memWidth - 4;
+    for (int row = 0; row < rows; ++row) {
+        const NumaNodeMetrics& node = metrics.nodes[static_cast<size_t>(row)];
+        const int rowY = innerTop + row * rowHeight;
+        const int barHeight = std::max(1, rowHeight - (rowHeight > 3 ? 2 : 0));
+        
+        if (labels) {
+            drawText(innerLeft, rowY, "N" + std::to_string(node.node), labelColor_);
+        }
+        const int memX = innerLeft + nameWidth;
+        const int remoteX = memX + memWidth + 4;
+        const double fill = node.total > 0 ? std::clamp(static_cast<double>(node.used) / node.total, 0.0, 1.0) : 0.0;
+        const double remote = metrics.ratesValid ? std::clamp(node.remotePercent / 100.0, 0.0, 1.0) : 0.0;
+        drawList_.fillRect(SDL_Rect{memX, rowY, memWidth, barHeight}, memFreeColor_);
+        drawList_.fillRect(SDL_Rect{memX, rowY, static_cast<int>(memWidth * fill), barHeight}, memUsedColor_);
+        drawList_.fillRect(SDL_Rect{remoteX, rowY, remoteWidth, barHeight}, irqIdleColor_);
+        drawList_.fillRect(SDL_Rect{remoteX, rowY, static_cast<int>(remoteWidth * remote), barHeight}, irqColor_);
+        if (labels) {
+            drawText(memX + 2, rowY, formatBytes(node.used) + "/" + formatBytes(node.total), valueColor_);
+        }
+    }
+}
+
+void Display::drawTemperatureMeter(const std::vector<TemperatureMetrics>& metrics, int y) {
+    TRACE_SCOPE("draw.temperature");
+    // Sensors without a threshold are measured against 100C
+    auto heat = [](const TemperatureMetrics& sensor) {
+        const double limit = sensor.maxCelsius > 0.0 ? sensor.maxCelsius : 100.0;
+        return sensor.celsius / limit;
+    };
+    temperatureRanking_.clear();
+    for (size_t i = 0; i < metrics.size(); ++i) {
+        if (metrics[i].valid) {
+            temperatureRanking_.push_back({heat(metrics[i]), i});
+        }
+    }
+    
+    // Value is the sensor closest to its limit, red within 5C of it
+    std::string valStr = "N/A";
+    SDL_Color color = valueColor_;
+    if (!temperatureRanking_.empty()) {
+        const TemperatureMetrics& hottest = metrics[std::max_element(temperatureRanking_.begin(), temperatureRanking_.end())->second];
+        valStr = formatValue(hottest.celsius, "C");
+        if (hottest.maxCelsius > 0.0 && hottest.celsius >= hottest.maxCelsius - 5.0) {
+            color = alertColor_;
+        }
+    }
+    drawRightAlignedText(labelWidth_ + 12,
+                         y + meterHeight_/2 - charHeight_/2,
+                         valStr,
+                         color);
+    if (temperatureRanking_.empty()) {
+        return;
+    }
+    
+    // As many sensors as fit, closest to their limit first
+    const int meterX = labelWidth_ + LABEL_TO_METER_SPACING;
+    const int innerLeft = meterX + 2;
+    const int innerTop = y + 2;
+    const int innerWidth = meterWidth_ - 6;
+    const int innerHeight = meterHeight_ - 4;
+    const int rowHeight = std::max(charHeight_, glyphAtlas_.lineHeight()) + 2;
+    const size_t rows = std::min(temperatureRanking_.size(), static_cast<size_t>(std::max(1, innerHeight / rowHeight)));
+    std::partial_sort(temperatureRanking_.begin(), temperatureRanking_.begin() + static_cast<std::ptrdiff_t>(rows),
+                      temperatureRanking_.end(), std::greater<>());
+    
+    const int nameWidth = innerWidth * 2 / 5;
+    const int barWidth = innerWidth - nameWidth - 2;
+    const size_t maxChars = static_cast<size_t>(std::max(1, nameWidth / std::max(1, charWidth_) - 1));
+    for (size_t row = 0; row < rows; ++row) {
+        const TemperatureMetrics& sensor = metrics[temperatureRanking_[row].second];
+        const int rowY = innerTop + static_cast<int>(row) * std::min(rowHeight, innerHeight);
+        const int barHeight = std::min(rowHeight, innerHeight) - 2;
+        
+        // Labels are long ("coretemp/Package id 0"); keep the end
+        std::string name = sensor.name.substr(sensor.name.find('/') + 1);
+        if (name.size() > maxChars) {
+            name.erase(0, name.size() - maxChars);
+        }
+        drawText(innerLeft, rowY, name, labelColor_);
+        
+        const int barX = innerLeft + nameWidth;
+        const double fill = std::clamp(temperatureRanking_[row].first, 0.0, 1.0);
+        const bool hot = sensor.maxCelsius > 0.0 && sensor.celsius >= sensor.maxCelsius - 5.0;
+        drawList_.fillRect(SDL_Rect{barX, rowY, barWidth, barHeight}, cpuIdleColor_);
+        drawList_.fillRect(SDL_Rect{barX, rowY, static_cast<int>(barWidth * fill), barHeight}, hot ? alertColor_ : cpuSystemColor_);
+        drawText(barX + 2, rowY, formatValue(sensor.celsius, "C"), valueColor_);
+    }
+}
+
+void Display::drawIpcMeter(const PerfMetrics& metrics, int y) {
+    TRACE_SCOPE("draw.ipc");
+    // Four instructions per cycle is a full bar. Without a PMU the meter
+    // falls back to context switches per second on a log scale (1M ~= 100%).
+    const bool hardware = metrics.mode == PerfMetrics::Mode::Hardware;
+    std::string valStr = "N/A";
+    double fill = 0.0;
+    if (metrics.valid && hardware) {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.2f", metrics.total.ipc);
+        valStr = buffer;
+        fill = std::min(100.0, metrics.total.ipc / 4.0 * 100.0);
+    } else if (metrics.valid) {
+        valStr = metrics.total.contextSwitches >= 10000.0
+            ? formatValue(metrics.total.contextSwitches / 1000.0, "k")
+            : formatValue(metrics.total.contextSwitches, "");
+        fill = std::min(100.0, std::log10(1.0 + metrics.total.contextSwitches) / 6.0 * 100.0);
+    }
+    drawRightAlignedText(labelWidth_ + 12,
+                         y + meterHeight_/2 - charHeight_/2,
+                         valStr,
+                         valueColor_);
+    
+    std::vector<double> values = {fill, 100.0 - fill};
+    updateHistory(ipcHistory_, values);
+    std::vector<double> avgValues = computeHistoryAverage(ipcHistory_, values.size());
+    std::vector<SDL_Color> meterColors = {hardware ? cpuUserColor_ : irqColor_, cpuIdleColor_};
+    drawHorizontalMeter(labelWidth_ + LABEL_TO_METER_SPACING, y, meterWidth_, meterHeight_, values, meterColors, &avgValues, &ipcChart_);
+    if (!metrics.valid || !hardware) {
+        return;
+    }
+    
+    // Cache and branch misses per 1000 instructions over the live bar, and
+    // each core's IPC as a strip along its bottom when the cores fit
+    const int innerLeft = labelWidth_ + LABEL_TO_METER_SPACING + 2;
+    const int innerWidth = meterWidth_ - 6;
+    const int liveHeight = (meterHeight_ - 4) / 2;
+    if (liveHeight >= charHeight_) {
+        char buffer[48];
+        std::snprintf(buffer, sizeof(buffer), "C%.1f B%.1f", metrics.total.cacheMissesPerKilo, metrics.total.branchMissesPerKilo);
+        drawText(innerLeft + 2, y + 2 + (liveHeight - charHeight_) / 2, buffer, valueColor_);
+    }
+    const int cores = static_cast<int>(metrics.cores.size());
+    if (cores > 1 && innerWidth / cores >= 3) {
+        const int cellWidth = innerWidth / cores;
+        const int stripHeight = std::min(3, std::max(1, liveHeight / 3));
+        const int stripY = y + 2 + liveHeight - stripHeight;
+        for (int i = 0; i < cores; ++i) {
+            const double share = std::clamp(metrics.cores[static_cast<size_t>(i)].ipc / 4.0, 0.0, 1.0);
+            drawList_.fillRect(SDL_Rect{innerLeft + i * cellWidth, stripY, std::max(1, static_cast<int>((cellWidth - 1) * share)), stripHeight},
+                               valueColor_);
+        }
+    }
+}
+
+void Display::drawSelfMeter(const SelfMetrics& metrics, int y) {
+    TRACE_SCOPE("draw.self");
+    // OSXview's own CPU, with twice the governor's budget as a full bar
+    // (1% of a core without one), so the budget line sits mid-bar
+    const double scale = governorBudget_ > 0.0 ? governorBudget_ * 2.0 : 1.0;
+    const bool overBudget = governorBudget_ > 0.0 && metrics.cpuPercent > governorBudget_;
+    char buffer[64];
+    std::string valStr = "N/A";
+    if (metrics.valid) {
+        std::snprintf(buffer, sizeof(buffer), "%.2f%%", metrics.cpuPercent);
+        valStr = buffer;
+    }
+    drawRightAlignedText(labelWidth_ + 12,
+                         y + meterHeight_/2 - charHeight_/2,
+                         valStr,
+                         overBudget ? alertColor_ : valueColor_);
+    
+    const double user = metrics.valid ? std::min(100.0, metrics.userPercent / scale * 100.0) : 0.0;
+    const double system = metrics.valid ? std::min(100.0 - user, metrics.systemPercent / scale * 100.0) : 0.0;
+    std::vector<double> values = {user, system, 100.0 - user - system};
+    updateHistory(selfHistory_, values);
+    std::vector<double> avgValues = computeHistoryAverage(selfHistory_, values.size());
+    std::vector<SDL_Color> meterColors = {cpuUserColor_, cpuSystemColor_, cpuIdleColor_};
+    drawHorizontalMeter(labelWidth_ + LABEL_TO_METER_SPACING, y, meterWidth_, meterHeight_, values, meterColors, &avgValues, &selfChart_);
+    
+    // Resident set, syscalls and context switches per second over the live
+    // bar, then whatever the governor has turned down
+    const int liveHeight = (meterHeight_ - 4) / 2;
+    if (liveHeight < charHeight_) {
+        return;
+    }
+    std::string text = formatBytes(metrics.rssBytes);
+    if (metrics.syscallsValid) {
+        std::snprintf(buffer, sizeof(buffer), " %.0f sys/s", metrics.syscalls);
+        text += buffer;
+    }
+    if (metrics.valid) {
+        std::snprintf(buffer, sizeof(buffer), " %.0f csw/s", metrics.contextSwitches);
+        text += buffer;
+    }
+    const int textX = labelWidth_ + LABEL_TO_METER_SPACING + 4;
+    const int textY = y + 2 + (liveHeight - charHeight_) / 2;
+    drawText(textX, textY, text, valueColor_);
+    if (!governorStatus_.empty()) {
+        const int textWidth = glyphAtlas_.isReady() ? glyphAtlas_.measure(text) : static_cast<int>(text.size()) * charWidth_;
+        drawText(textX + textWidth + charWidth_, textY, governorStatus_, alertColor_);
+    }
 }
 
 void Display::drawIRQMeter(int irqCount, int y) {
-    // Draw label and value
-    drawText(LABEL_PADDING_X, y + meterHeight_/2 - charHeight_/2, "IRQS", labelColor_);
-    drawRightAlignedDynamicText("irq_count",
-                                labelWidth_,
-                                y + meterHeight_/2 - charHeight_/2,
-                                std::to_string(irqCount),
-                                valueColor_);
-    
-    // Draw legend above the bar
-    std::vector<std::string> labels = {"IRQs per sec", "IDLE"};
-    std::vector<SDL_Color> colors = {irqColor_, cpuIdleColor_};
-    drawLegend(labelWidth_ + 16, y - charHeight_ - 5, labels, colors);
+    TRACE_SCOPE("draw.irq");
+    drawRightAlignedText(labelWidth_ + 12,
+                         y + meterHeight_/2 - charHeight_/2,
+                         std::to_string(irqCount),
+                         valueColor_);
     
     // Calculate IRQ usage as percentage (max 1000 IRQs/sec as 100%)
     double irqUsage = std::min(100.0, (double)irqCount / 10.0);
@@ -660,16 +1369,109 @@ void Display::drawIRQMeter(int irqCount, int y) {
     // Draw horizontal meter
     std::vector<double> values = {irqUsage, idle};
     std::vector<SDL_Color> meterColors = {irqColor_, irqIdleColor_};
-    drawHorizontalMeter(labelWidth_ + 16, y, meterWidth_, meterHeight_, values, meterColors);
+    drawHorizontalMeter(labelWidth_ + LABEL_TO_METER_SPACING, y, meterWidth_, meterHeight_, values, meterColors);
+}
+
+namespace {
+
+// Last path component without the systemd suffix and runtime prefix, so
+// ".../cri-containerd-3f2a9c1b7e4d....scope" reads "3f2a9c1b7e4d"
+std::string shortCgroupName(const std::string& path) {
+    std::string name = path.substr(path.rfind('/') + 1);
+    for (const char* suffix : {".scope", ".slice", ".service"}) {
+        const size_t length = std::strlen(suffix);
+        if (name.size() > length && name.compare(name.size() - length, length, suffix) == 0) {
+            name.resize(name.size() - length);
+            break;
+        }
+    }
+    for (const char* prefix : {"cri-containerd-", "docker-", "crio-", "libpod-"}) {
+        const size_t length = std::strlen(prefix);
+        if (name.compare(0, length, prefix) == 0) {
+            name = name.substr(length, 12);
+            break;
+        }
+    }
+    return name;
+}
+
+} // namespace
+
+void Display::drawCgroupMeter(const SystemMetrics& metrics, int y) {
+    TRACE_SCOPE("draw.cgroup");
+    const std::vector<CgroupMetrics>& cgroups = metrics.getCgroupMetrics();
+    drawRightAlignedText(labelWidth_ + 12,
+                         y + meterHeight_/2 - charHeight_/2,
+                         cgroups.empty() ? "N/A" : std::to_string(cgroups.size()),
+                         valueColor_);
+    if (cgroups.empty()) {
+        return;
+    }
+    
+    // Containers and services are the leaf groups; rank them by whichever
+    // of CPU and memory is closer to its limit (or to the host's capacity),
+    // so both kinds of hog surface in the same list
+    const double hostCpus = std::max(1, metrics.getSystemInfo().cpuCount);
+    const double hostMemory = static_cast<double>(metrics.getMemoryMetrics().total);
+    auto cpuShare = [&](const CgroupMetrics& cgroup) {
+        return cgroup.cpuPercent / ((cgroup.cpuLimit > 0.0 ? cgroup.cpuLimit : hostCpus) * 100.0);
+    };
+    auto memoryShare = [&](const CgroupMetrics& cgroup) {
+        const double limit = cgroup.memoryMax > 0 ? static_cast<double>(cgroup.memoryMax) : hostMemory;
+        return limit > 0.0 ? static_cast<double>(cgroup.memoryCurrent) / limit : 0.0;
+    };
+    
+    cgroupRanking_.clear();
+    for (size_t i = 0; i < cgroups.size(); ++i) {
+        if (cgroups[i].leaf) {
+            cgroupRanking_.push_back({std::max(cpuShare(cgroups[i]), memoryShare(cgroups[i])), i});
+        }
+    }
+    
+    const int meterX = labelWidth_ + LABEL_TO_METER_SPACING;
+    const int innerLeft = meterX + 2;
+    const int innerTop = y + 2;
+    const int innerWidth = meterWidth_ - 6;
+    const int innerHeight = meterHeight_ - 4;
+    const int rowHeight = std::max(charHeight_, glyphAtlas_.lineHeight()) + 2;
+    const size_t rows = std::min(cgroupRanking_.size(), static_cast<size_t>(std::max(1, innerHeight / rowHeight)));
+    std::partial_sort(cgroupRanking_.begin(), cgroupRanking_.begin() + static_cast<std::ptrdiff_t>(rows),
+                      cgroupRanking_.end(), std::greater<>());
+    
+    // Name column, then a CPU and a memory bar per row
+    const int nameWidth = innerWidth * 2 / 5;
+    const int barWidth = (innerWidth - nameWidth) / 2 - 2;
+    const size_t maxChars = static_cast<size_t>(std::max(1, nameWidth / std::max(1, charWidth_) - 1));
+    for (size_t row = 0; row < rows; ++row) {
+        const CgroupMetrics& cgroup = cgroups[cgroupRanking_[row].second];
+        const int rowY = innerTop + static_cast<int>(row) * rowHeight;
+        const int barHeight = rowHeight - 2;
+        
+        std::string name = shortCgroupName(cgroup.name);
+        if (name.size() > maxChars) {
+            name.resize(maxChars);
+        }
+        drawText(innerLeft, rowY, name, labelColor_);
+        
+        const int cpuX = innerLeft + nameWidth;
+        const int memX = cpuX + barWidth + 4;
+        const double cpu = std::clamp(cpuShare(cgroup), 0.0, 1.0);
+        const double memory = std::clamp(memoryShare(cgroup), 0.0, 1.0);
+        drawList_.fillRect(SDL_Rect{cpuX, rowY, barWidth, barHeight}, cpuIdleColor_);
+        drawList_.fillRect(SDL_Rect{cpuX, rowY, static_cast<int>(barWidth * cpu), barHeight}, cpuSystemColor_);
+        drawList_.fillRect(SDL_Rect{memX, rowY, barWidth, barHeight}, memFreeColor_);
+        drawList_.fillRect(SDL_Rect{memX, rowY, static_cast<int>(barWidth * memory), barHeight}, memUsedColor_);
+        drawText(cpuX + 2, rowY, formatValue(cgroup.cpuPercent, "%"), valueColor_);
+        drawText(memX + 2, rowY, formatBytes(cgroup.memoryCurrent), valueColor_);
+    }
 }
 
 void Display::drawHorizontalMeter(int x, int y, int width, int height,
                                 const std::vector<double>& values,
                                 const std::vector<SDL_Color>& colors,
-                                const std::vector<double>* secondaryValues) {
-    // Draw border
-    drawMeterBorder(x, y, width, height);
-    
+                                const std::vector<double>* secondaryValues,
+                                StripChart* chart) {
+    // The border is part of the cached chrome layer
     auto drawSegments = [&](const std::vector<double>& segments,
                             int drawY,
                             int segmentHeight) {
@@ -691,10 +1493,7 @@ void Display::drawHorizontalMeter(int x, int y, int width, int height,
             }
             
             if (segmentWidth > 0) {
-                const SDL_Color& color = colors[i];
-                SDL_Rect segment{currentX, drawY, segmentWidth, segmentHeight};
-                SDL_SetRenderDrawColor(renderer_, color.r, color.g, color.b, color.a);
-                SDL_RenderFillRect(renderer_, &segment);
+                drawList_.fillRect(SDL_Rect{currentX, drawY, segmentWidth, segmentHeight}, colors[i]);
             }
             
             currentX += segmentWidth;
@@ -708,6 +1507,20 @@ void Display::drawHorizontalMeter(int x, int y, int width, int height,
     
     if (secondaryValues && !secondaryValues->empty()) {
         int bottomHeight = innerHeight - halfHeight;
+        if (graphMode_ && chart) {
+            // Ring is recreated (and its history dropped) only when the layout changes
+            const int chartWidth = width - 6;
+            if (chart->width() != chartWidth || chart->height() != bottomHeight) {
+                chart->resize(renderer_, chartWidth, bottomHeight);
+            }
+            if (chart->isReady()) {
+                if (newChartSample_) {
+                    chart->push(values, colors);
+                }
+                chartDraws_.push_back({chart, x + 2, y + 2 + halfHeight});
+                return;
+            }
+        }
         drawSegments(*secondaryValues, y + 2 + halfHeight, bottomHeight);
     }
 }
@@ -719,124 +1532,25 @@ void Display::drawLegend(int x, int y, const std::vector<std::string>& labels,
         drawText(currentX, y, labels[i], colors[i]);
         
         // Get actual text width for proper spacing
-        if (font_) {
-            int textWidth;
-            TTF_SizeText(font_, labels[i].c_str(), &textWidth, nullptr);
-            currentX += textWidth + charWidth_ * 2;
+        if (glyphAtlas_.isReady()) {
+            currentX += glyphAtlas_.measure(labels[i]) + charWidth_ * 2;
         } else {
             currentX += (int)labels[i].length() * charWidth_ + charWidth_ * 2;
         }
     }
 }
 
-Display::DynamicTextEntry* Display::prepareDynamicText(const std::string& key,
-                                                       const std::string& text,
-                                                       const SDL_Color& color) {
-    if (!renderer_ || !font_) {
-        return nullptr;
-    }
-    
-    auto& entry = dynamicTextCache_[key];
-    bool needsUpdate = (entry.texture == nullptr) ||
-                       (entry.lastText != text) ||
-                       (entry.color.r != color.r ||
-                        entry.color.g != color.g ||
-                        entry.color.b != color.b ||
-                        entry.color.a != color.a);
-    
-    if (needsUpdate) {
-        if (entry.texture) {
-            SDL_DestroyTexture(entry.texture);
-            entry.texture = nullptr;
-        }
-        
-        SDL_Surface* surface = TTF_RenderText_Solid(font_, text.c_str(), color);
-        if (!surface) {
-            return nullptr;
-        }
-        
-        SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer_, surface);
-        if (!texture) {
-            SDL_FreeSurface(surface);
-            return nullptr;
-        }
-        
-        entry.texture = texture;
-        entry.width = surface->w;
-        entry.height = surface->h;
-        entry.lastText = text;
-        entry.color = color;
-        SDL_FreeSurface(surface);
-    }
-    
-    return &entry;
+void Display::drawText(int x, int y, std::string_view text, const SDL_Color& color) {
+    glyphAtlas_.draw(x, y, text, color);
 }
 
-void Display::drawDynamicText(const std::string& key, int x, int y,
-                              const std::string& text, const SDL_Color& color) {
-    DynamicTextEntry* entry = prepareDynamicText(key, text, color);
-    if (!entry || !entry->texture) {
-        return;
-    }
-    
-    SDL_Rect dstRect{x, y, entry->width, entry->height};
-    SDL_RenderCopy(renderer_, entry->texture, nullptr, &dstRect);
-}
-
-void Display::drawRightAlignedDynamicText(const std::string& key, int x, int y,
-                                          const std::string& text, const SDL_Color& color) {
-    DynamicTextEntry* entry = prepareDynamicText(key, text, color);
-    if (!entry || !entry->texture) {
-        return;
-    }
-    
-    SDL_Rect dstRect{x - entry->width, y, entry->width, entry->height};
-    SDL_RenderCopy(renderer_, entry->texture, nullptr, &dstRect);
-}
-
-void Display::clearDynamicTextCache() {
-    for (auto& kv : dynamicTextCache_) {
-        if (kv.second.texture) {
-            SDL_DestroyTexture(kv.second.texture);
-        }
-    }
-    dynamicTextCache_.clear();
-}
-
-void Display::drawText(int x, int y, const std::string& text, const SDL_Color& color) {
-    if (!renderer_ || !font_) return;
-    
-    CachedTextEntry* cached = ensureCachedText(renderer_, font_, text, color);
-    if (!cached) {
-        return;
-    }
-    
-    SDL_Rect dstRect{x, y, cached->width, cached->height};
-    SDL_RenderCopy(renderer_, cached->texture, nullptr, &dstRect);
-}
-
-void Display::drawRightAlignedText(int x, int y, const std::string& text, const SDL_Color& color) {
-    if (!renderer_ || !font_) return;
-    
-    CachedTextEntry* cached = ensureCachedText(renderer_, font_, text, color);
-    if (!cached) {
-        return;
-    }
-    
-    SDL_Rect dstRect{x - cached->width, y, cached->width, cached->height};
-    SDL_RenderCopy(renderer_, cached->texture, nullptr, &dstRect);
+void Display::drawRightAlignedText(int x, int y, std::string_view text, const SDL_Color& color) {
+    glyphAtlas_.draw(x - glyphAtlas_.measure(text), y, text, color);
 }
 
 void Display::drawMeterBorder(int x, int y, int width, int height) {
-    SDL_SetRenderDrawColor(renderer_, borderColor_.r, borderColor_.g, 
-                         borderColor_.b, borderColor_.a);
-    
-    // Draw rectangle border
-    SDL_Rect rect{x, y, width, height};
-    SDL_RenderDrawRect(renderer_, &rect);
-    
-    // Make it brighter/thicker by drawing again
-    SDL_RenderDrawRect(renderer_, &rect);
+    // Opaque border, so a single outline is identical to the old double draw
+    drawList_.strokeRect(SDL_Rect{x, y, width, height}, borderColor_);
 }
 
 std::string Display::formatBytes(uint64_t bytes) const {
@@ -849,15 +1563,17 @@ std::string Display::formatBytes(uint64_t bytes) const {
         unit++;
     }
     
-    std::ostringstream oss;
-    oss << std::fixed << std::setprecision(0) << value << units[unit];
-    return oss.str();
+    // snprintf into a short string stays within the small-string buffer,
+    // so per-frame value formatting does not touch the heap
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.0f%s", value, units[unit]);
+    return buffer;
 }
 
-std::string Display::formatValue(double value, const std::string& unit) const {
-    std::ostringstream oss;
-    oss << std::fixed << std::setprecision(0) << value << unit;
-    return oss.str();
+std::string Display::formatValue(double value, const char* unit) const {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.0f%s", value, unit);
+    return buffer;
 }
 
 void Display::updateHistory(MeterHistory& history, const std::vector<double>& values) {
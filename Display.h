@@ -5,9 +5,14 @@
 #include <SDL2/SDL_ttf.h>
 #include <vector>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <deque>
 #include <chrono>
+#include "DrawList.h"
+#include "ClusterReceiver.h"
+#include "GlyphAtlas.h"
+#include "MeterRegistry.h"
+#include "StripChart.h"
 #include "SystemMetrics.h"
 
 class Display {
@@ -16,18 +21,54 @@ public:
     ~Display();
     
     bool initialize();
+    // Renders into a CPU framebuffer instead of a window (snapshots, benchmarks)
+    bool initializeOffscreen();
     void cleanup();
     
     void beginFrame();
     void endFrame();
     
     void draw(const SystemMetrics& metrics);
+    // Grid of compact CPU/MEM/NET/DSK bars, one cell per host
+    void drawCluster(const std::vector<HostState>& hosts);
     void handleResize(int newWidth, int newHeight);
+    void invalidate();
+    
+    // Writes the last rendered frame as PNG, or PPM for a ".ppm" path
+    bool saveSnapshot(const std::string& path);
+    
+    // Which meters are shown, top to bottom, and their relative heights
+    void setMeters(const std::vector<MeterSpec>& meters);
+    const std::vector<MeterSpec>& meters() const { return meters_; }
+    // Collector subsystems the current meters read
+    uint32_t requiredSubsystems() const { return subsystemsFor(meters_); }
+    
+    // Graph mode replaces the 15 s average row with a scrolling history graph
+    void setGraphMode(bool enabled);
+    bool graphMode() const { return graphMode_; }
+    
+    // Outlines the meters with an active alert (bit 1 << MeterKind)
+    void setAlertedMeters(uint32_t meters) { alertedMeters_ = meters; }
+    
+    // Scales the self meter to the CPU budget and shows what the governor
+    // has switched off ("x2 -tcp"); a budget of 0 means no governor
+    void setGovernorStatus(double budgetPercent, std::string status) {
+        governorBudget_ = budgetPercent;
+        governorStatus_ = std::move(status);
+    }
+    
+    // The first monospace system font found, and where it was found;
+    // TTF_Init must have been called
+    static TTF_Font* openDefaultFont(int fontSize, std::string* path = nullptr);
     
 private:
     SDL_Window* window_;
+    SDL_Surface* surface_ = nullptr;
     SDL_Renderer* renderer_;
     TTF_Font* font_;
+    std::string fontPath_;      // last run's font until it has to be opened
+    GlyphAtlas glyphAtlas_;
+    DrawList drawList_;
     int width_;
     int height_;
     
@@ -73,8 +114,15 @@ private:
     SDL_Color irqColor_;
     SDL_Color irqIdleColor_;
     
+    // Alert outline
+    SDL_Color alertColor_;
+    uint32_t alertedMeters_ = 0;
+    
+    // Self meter
+    double governorBudget_ = 0.0;
+    std::string governorStatus_;
+    
     // Dynamic layout constants
-    static const int NUM_METERS = 7;
     static const int METER_SPACING = 40;
     static const int LABEL_PADDING_X = 16;
     static const int LABEL_X = 10;
@@ -82,6 +130,17 @@ private:
     static const int LEGEND_Y_OFFSET = -15;
     static const int LABEL_TO_METER_SPACING = 20;
     
+    // Active meters and where each one sits. meterHeight_ holds the height
+    // of the meter currently being drawn.
+    struct MeterSlot {
+        MeterKind kind;
+        int y;
+        int height;
+    };
+    
+    std::vector<MeterSpec> meters_ = defaultMeterLayout();
+    std::vector<MeterSlot> slots_;
+    
     // Calculated layout
     int meterHeight_;
     int meterYStart_;
@@ -94,48 +153,71 @@ private:
     int valueWidth_;
     
     void updateLayout();
+    void loadFont();
+    bool openFont(int fontSize);
+    void selectFontSize(int fontSize);
+    
+    // Static chrome (labels, legends, meter borders) cached per layout
+    struct ChromeState {
+        std::string_view batteryLabel = "N/A";
+        bool batteryOnAC = false;
+        size_t fanLegendCount = 0;
+        
+        bool operator==(const ChromeState& other) const = default;
+    };
+    
+    SDL_Texture* chromeTexture_ = nullptr;
+    int chromeWidth_ = 0;
+    int chromeHeight_ = 0;
+    bool chromeValid_ = false;
+    ChromeState chromeState_;
     
-    void drawCPUMeter(const std::vector<CPUMetrics>& metrics, int y);
+    ChromeState chromeStateFor(const SystemMetrics& metrics) const;
+    void renderChrome(const ChromeState& state);
+    void drawChrome(const ChromeState& state);
+    
+    // Damage tracking for the software renderer: per-meter hashes of the
+    // emitted draw commands decide which rows are repainted and presented
+    bool damageTracking_ = false;
+    bool fullRepaint_ = true;
+    std::vector<uint64_t> meterHashes_;
+    std::vector<SDL_Rect> damage_;
+    
+    bool usePartialUpdates() const;
+    SDL_Rect meterDamageRect(int y) const;
+    
+    void drawMeter(MeterKind kind, const SystemMetrics& metrics, int y);
+    void drawCPUMeter(const std::vector<CPUMetrics>& metrics, const CpuFreqMetrics& freq, int y);
     void drawGPUMeter(const GPUMetrics& metrics, int y);
     void drawMemoryMeter(const MemoryMetrics& metrics, int y);
+    void drawSwapMeter(const MemoryMetrics& metrics, int y);
     void drawDiskMeter(const DiskMetrics& metrics, int y);
     void drawNetworkMeter(const NetworkMetrics& metrics, int y);
     void drawFanMeter(const std::vector<FanMetrics>& metrics, int y);
     void drawBatteryMeter(const BatteryMetrics& metrics, int y);
     void drawIRQMeter(int irqCount, int y);
+    void drawCgroupMeter(const SystemMetrics& metrics, int y);
+    void drawSchedMeter(const SchedMetrics& metrics, int y);
+    void drawTcpMeter(const TcpMetrics& metrics, int y);
+    void drawNumaMeter(const NumaMetrics& metrics, int y);
+    void drawTemperatureMeter(const std::vector<TemperatureMetrics>& metrics, int y);
+    void drawIpcMeter(const PerfMetrics& metrics, int y);
+    void drawSelfMeter(const SelfMetrics& metrics, int y);
     
     void drawHorizontalMeter(int x, int y, int width, int height,
                            const std::vector<double>& values,
                            const std::vector<SDL_Color>& colors,
-                           const std::vector<double>* secondaryValues = nullptr);
-    
-    void drawText(int x, int y, const std::string& text, const SDL_Color& color);
-    void drawRightAlignedText(int x, int y, const std::string& text, const SDL_Color& color);
-    void drawDynamicText(const std::string& key, int x, int y,
-                         const std::string& text, const SDL_Color& color);
-    void drawRightAlignedDynamicText(const std::string& key, int x, int y,
-                                     const std::string& text, const SDL_Color& color);
+                           const std::vector<double>* secondaryValues = nullptr,
+                           StripChart* chart = nullptr);
+    
+    void drawText(int x, int y, std::string_view text, const SDL_Color& color);
+    void drawRightAlignedText(int x, int y, std::string_view text, const SDL_Color& color);
     void drawMeterBorder(int x, int y, int width, int height);
     void drawLegend(int x, int y, const std::vector<std::string>& labels, 
                    const std::vector<SDL_Color>& colors);
     
     std::string formatBytes(uint64_t bytes) const;
-    std::string formatValue(double value, const std::string& unit) const;
-
-    struct DynamicTextEntry {
-        SDL_Texture* texture = nullptr;
-        int width = 0;
-        int height = 0;
-        std::string lastText;
-        SDL_Color color{0, 0, 0, 0};
-    };
-    
-    std::unordered_map<std::string, DynamicTextEntry> dynamicTextCache_;
-    
-    DynamicTextEntry* prepareDynamicText(const std::string& key,
-                                         const std::string& text,
-                                         const SDL_Color& color);
-    void clearDynamicTextCache();
+    std::string formatValue(double value, const char* unit) const;
     
     struct MeterHistorySample {
         std::chrono::steady_clock::time_point timestamp;
@@ -152,8 +234,43 @@ private:
     MeterHistory netHistory_;
     MeterHistory fanHistory_;
     MeterHistory batteryHistory_;
+    MeterHistory swapHistory_;
+    MeterHistory schedHistory_;
+    MeterHistory tcpHistory_;
+    MeterHistory ipcHistory_;
+    MeterHistory selfHistory_;
     
     void updateHistory(MeterHistory& history, const std::vector<double>& values);
+    
+    // Strip charts are blitted after the chrome (and damaged-row restores)
+    // but before the batched geometry, so they are queued until endFrame
+    struct ChartDraw {
+        const StripChart* chart;
+        int x;
+        int y;
+    };
+    
+    bool graphMode_ = false;
+    bool newChartSample_ = false;
+    uint64_t lastChartSample_ = 0;
+    StripChart cpuChart_;
+    StripChart gpuChart_;
+    StripChart memChart_;
+    StripChart diskChart_;
+    StripChart netChart_;
+    StripChart batteryChart_;
+    StripChart swapChart_;
+    StripChart schedChart_;
+    StripChart tcpChart_;
+    StripChart ipcChart_;
+    StripChart selfChart_;
+    std::vector<ChartDraw> chartDraws_;
+    
+    // Scratch for ranking cgroups: (share, index)
+    std::vector<std::pair<double, size_t>> cgroupRanking_;
+    std::vector<std::pair<double, size_t>> temperatureRanking_;
+    
+    void drawCharts();
     std::vector<double> computeHistoryAverage(const MeterHistory& history, size_t componentCount) const;
 };
 
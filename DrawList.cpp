@@ -0,0 +1,85 @@
+#include "DrawList.h"
+#include "Hash.h"
+
+void DrawList::begin(SDL_Renderer* renderer) {
+    renderer_ = renderer;
+    vertices_.clear();
+    indices_.clear();
+    rectCount_ = 0;
+    submitCalls_ = 0;
+}
+
+void DrawList::fillRect(const SDL_Rect& rect, const SDL_Color& color) {
+    if (rect.w <= 0 || rect.h <= 0) {
+        return;
+    }
+    rectCount_++;
+
+    if (mode_ == Mode::Immediate) {
+        if (renderer_) {
+            SDL_SetRenderDrawColor(renderer_, color.r, color.g, color.b, color.a);
+            SDL_RenderFillRect(renderer_, &rect);
+            submitCalls_++;
+        }
+        return;
+    }
+
+    const int base = static_cast<int>(vertices_.size());
+    const float left = static_cast<float>(rect.x);
+    const float top = static_cast<float>(rect.y);
+    const float right = static_cast<float>(rect.x + rect.w);
+    const float bottom = static_cast<float>(rect.y + rect.h);
+    vertices_.push_back(SDL_Vertex{{left, top}, color, {0.0f, 0.0f}});
+    vertices_.push_back(SDL_Vertex{{right, top}, color, {0.0f, 0.0f}});
+    vertices_.push_back(SDL_Vertex{{left, bottom}, color, {0.0f, 0.0f}});
+    vertices_.push_back(SDL_Vertex{{right, bottom}, color, {0.0f, 0.0f}});
+    indices_.push_back(base);
+    indices_.push_back(base + 1);
+    indices_.push_back(base + 2);
+    indices_.push_back(base + 2);
+    indices_.push_back(base + 1);
+    indices_.push_back(base + 3);
+}
+
+void DrawList::strokeRect(const SDL_Rect& rect, const SDL_Color& color) {
+    if (rect.w <= 0 || rect.h <= 0) {
+        return;
+    }
+    // One-pixel outline as four fills (top, bottom, left, right)
+    fillRect(SDL_Rect{rect.x, rect.y, rect.w, 1}, color);
+    if (rect.h > 1) {
+        fillRect(SDL_Rect{rect.x, rect.y + rect.h - 1, rect.w, 1}, color);
+    }
+    if (rect.h > 2) {
+        fillRect(SDL_Rect{rect.x, rect.y + 1, 1, rect.h - 2}, color);
+        if (rect.w > 1) {
+            fillRect(SDL_Rect{rect.x + rect.w - 1, rect.y + 1, 1, rect.h - 2}, color);
+        }
+    }
+}
+
+void DrawList::submit() {
+    if (mode_ == Mode::Immediate || !renderer_ || vertices_.empty()) {
+        return;
+    }
+    SDL_RenderGeometry(renderer_, nullptr,
+                       vertices_.data(), static_cast<int>(vertices_.size()),
+                       indices_.data(), static_cast<int>(indices_.size()));
+    submitCalls_++;
+    vertices_.clear();
+    indices_.clear();
+}
+
+uint64_t DrawList::hashSince(size_t mark) const {
+    // FNV-1a over the emitted vertices (position + color)
+    return fnv1a(vertices_.data() + mark, (vertices_.size() - mark) * sizeof(SDL_Vertex));
+}
+
+void DrawList::rewind(size_t mark) {
+    if (mark >= vertices_.size()) {
+        return;
+    }
+    rectCount_ -= (vertices_.size() - mark) / 4;
+    vertices_.resize(mark);
+    indices_.resize(mark / 4 * 6);
+}
@@ -0,0 +1,48 @@
+#ifndef OSXVIEW_DRAWLIST_H
+#define OSXVIEW_DRAWLIST_H
+
+#include <SDL2/SDL.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Per-frame list of solid-color rectangles. Batched mode collects quads and
+// submits them as one untextured SDL_RenderGeometry call in painter's order;
+// immediate mode forwards each rect to SDL as it arrives (kept for
+// benchmarking and as a fallback for renderers without geometry support).
+class DrawList {
+public:
+    enum class Mode {
+        Batched,
+        Immediate
+    };
+
+    explicit DrawList(Mode mode = Mode::Batched) : mode_(mode) {}
+
+    void setMode(Mode mode) { mode_ = mode; }
+    Mode mode() const { return mode_; }
+
+    void begin(SDL_Renderer* renderer);
+    void fillRect(const SDL_Rect& rect, const SDL_Color& color);
+    void strokeRect(const SDL_Rect& rect, const SDL_Color& color);
+    void submit();
+
+    // Damage tracking: callers take a mark before emitting a meter, hash what
+    // was emitted since, and rewind to drop it when it matches last frame.
+    size_t mark() const { return vertices_.size(); }
+    uint64_t hashSince(size_t mark) const;
+    void rewind(size_t mark);
+
+    size_t rectCount() const { return rectCount_; }
+    size_t submitCalls() const { return submitCalls_; }
+
+private:
+    Mode mode_;
+    SDL_Renderer* renderer_ = nullptr;
+    std::vector<SDL_Vertex> vertices_;
+    std::vector<int> indices_;
+    size_t rectCount_ = 0;
+    size_t submitCalls_ = 0;
+};
+
+#endif //OSXVIEW_DRAWLIST_H
@@ -0,0 +1,361 @@
+#include "GlyphAtlas.h"
+#include "Hash.h"
+#include "StartupCache.h"
+#include "Trace.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+// Native byte order: the cache never leaves the machine
+const char CACHE_MAGIC[8] = {'O', 'S', 'X', 'G', 'L', 'Y', 'F', '1'};
+
+void putInt(std::string& out, int32_t value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+bool takeInt(std::string_view& in, int32_t& value) {
+    if (in.size() < sizeof(value)) {
+        return false;
+    }
+    std::memcpy(&value, in.data(), sizeof(value));
+    in.remove_prefix(sizeof(value));
+    return true;
+}
+
+} // namespace
+
+GlyphAtlas::~GlyphAtlas() {
+    release();
+}
+
+void GlyphAtlas::release() {
+    if (page_.texture) {
+        SDL_DestroyTexture(page_.texture);
+    }
+    page_ = Page{};
+    for (Page& page : recent_) {
+        SDL_DestroyTexture(page.texture);
+    }
+    recent_.clear();
+    vertices_.clear();
+}
+
+void GlyphAtlas::stashCurrent() {
+    // Queued vertices refer to the current texture's coordinates
+    vertices_.clear();
+    if (!page_.texture) {
+        page_ = Page{};
+        return;
+    }
+    if (recent_.size() >= CACHED_SIZES) {
+        auto oldest = std::min_element(recent_.begin(), recent_.end(), [](const Page& a, const Page& b) {
+            return a.lastUsed < b.lastUsed;
+        });
+        SDL_DestroyTexture(oldest->texture);
+        recent_.erase(oldest);
+    }
+    recent_.push_back(page_);
+    page_ = Page{};
+}
+
+bool GlyphAtlas::select(int fontSize) {
+    if (page_.texture && page_.fontSize == fontSize) {
+        return true;
+    }
+    auto cached = std::find_if(recent_.begin(), recent_.end(), [fontSize](const Page& page) {
+        return page.fontSize == fontSize;
+    });
+    if (cached == recent_.end()) {
+        return false;
+    }
+    Page page = *cached;
+    recent_.erase(cached);
+    stashCurrent();
+    page_ = page;
+    page_.lastUsed = ++useClock_;
+    return true;
+}
+
+void GlyphAtlas::setDiskCache(std::string directory, std::string key) {
+    cacheDirectory_ = std::move(directory);
+    cacheKey_ = std::move(key);
+}
+
+std::string GlyphAtlas::cachePath(int fontSize) const {
+    const uint64_t keyHash = fnv1a(cacheKey_.data(), cacheKey_.size());
+    char name[48];
+    std::snprintf(name, sizeof(name), "/glyphs-%016llx-%d", static_cast<unsigned long long>(keyHash), fontSize);
+    return cacheDirectory_ + name;
+}
+
+bool GlyphAtlas::loadCached(SDL_Renderer* renderer, int fontSize) {
+    if (select(fontSize)) {
+        return true;
+    }
+    if (!renderer || cacheDirectory_.empty() || cacheKey_.empty()) {
+        return false;
+    }
+    TRACE_SCOPE("text.cache.load");
+    std::string contents;
+    if (!readCacheFile(cachePath(fontSize), contents)) {
+        return false;
+    }
+
+    // magic, key, size, texture size, line height, glyph table, bitmap
+    std::string_view in(contents);
+    int32_t keyLength = 0;
+    if (in.size() < sizeof(CACHE_MAGIC) || std::memcmp(in.data(), CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0) {
+        return false;
+    }
+    in.remove_prefix(sizeof(CACHE_MAGIC));
+    if (!takeInt(in, keyLength) || keyLength < 0 || in.size() < static_cast<size_t>(keyLength) ||
+        in.substr(0, static_cast<size_t>(keyLength)) != cacheKey_) {
+        return false;
+    }
+    in.remove_prefix(static_cast<size_t>(keyLength));
+    Page page;
+    int32_t size = 0, width = 0, height = 0, lineHeight = 0;
+    if (!takeInt(in, size) || !takeInt(in, width) || !takeInt(in, height) || !takeInt(in, lineHeight) ||
+        size != fontSize || width != ATLAS_WIDTH || height <= 0 || height > 4096) {
+        return false;
+    }
+    for (Glyph& glyph : page.glyphs) {
+        int32_t x = 0, y = 0, w = 0, h = 0, advance = 0;
+        if (!takeInt(in, x) || !takeInt(in, y) || !takeInt(in, w) || !takeInt(in, h) || !takeInt(in, advance) ||
+            x < 0 || y < 0 || w < 0 || h < 0 || x + w > width || y + h > height) {
+            return false;
+        }
+        glyph.source = SDL_Rect{x, y, w, h};
+        glyph.advance = advance;
+    }
+    const size_t pixelCount = static_cast<size_t>(width) * static_cast<size_t>(height);
+    if (in.size() != (pixelCount + 7) / 8) {
+        return false;
+    }
+    std::vector<uint32_t> pixels(pixelCount);
+    for (size_t i = 0; i < pixelCount; ++i) {
+        pixels[i] = (static_cast<unsigned char>(in[i / 8]) >> (i % 8)) & 1 ? 0xFFFFFFFFu : 0u;
+    }
+
+    stashCurrent();
+    page_ = page;
+    page_.textureWidth = width;
+    page_.textureHeight = height;
+    page_.lineHeight = lineHeight;
+    if (!upload(renderer, pixels)) {
+        return false;
+    }
+    page_.fontSize = fontSize;
+    page_.lastUsed = ++useClock_;
+    return true;
+}
+
+void GlyphAtlas::store(const std::vector<uint32_t>& pixels) const {
+    if (cacheDirectory_.empty() || cacheKey_.empty()) {
+        return;
+    }
+    std::string out(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    putInt(out, static_cast<int32_t>(cacheKey_.size()));
+    out += cacheKey_;
+    putInt(out, page_.fontSize);
+    putInt(out, page_.textureWidth);
+    putInt(out, page_.textureHeight);
+    putInt(out, page_.lineHeight);
+    for (const Glyph& glyph : page_.glyphs) {
+        putInt(out, glyph.source.x);
+        putInt(out, glyph.source.y);
+        putInt(out, glyph.source.w);
+        putInt(out, glyph.source.h);
+        putInt(out, glyph.advance);
+    }
+    // Solid rendering only yields full or no coverage
+    const size_t start = out.size();
+    out.resize(start + (pixels.size() + 7) / 8, '\0');
+    for (size_t i = 0; i < pixels.size(); ++i) {
+        if (pixels[i]) {
+            out[start + i / 8] = static_cast<char>(out[start + i / 8] | (1 << (i % 8)));
+        }
+    }
+    writeCacheFile(cachePath(page_.fontSize), out);
+}
+
+bool GlyphAtlas::upload(SDL_Renderer* renderer, const std::vector<uint32_t>& pixels) {
+    page_.texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC,
+                                      page_.textureWidth, page_.textureHeight);
+    if (!page_.texture) {
+        page_ = Page{};
+        return false;
+    }
+    SDL_UpdateTexture(page_.texture, nullptr, pixels.data(),
+                      page_.textureWidth * static_cast<int>(sizeof(uint32_t)));
+    SDL_SetTextureBlendMode(page_.texture, SDL_BLENDMODE_BLEND);
+    return true;
+}
+
+bool GlyphAtlas::build(SDL_Renderer* renderer, TTF_Font* font, int fontSize) {
+    if (select(fontSize)) {
+        return true;
+    }
+    TRACE_SCOPE("text.rasterize");
+    stashCurrent();
+    if (!renderer || !font) {
+        return false;
+    }
+
+    const SDL_Color white{255, 255, 255, 255};
+    SDL_Surface* surfaces[GLYPH_COUNT] = {};
+
+    // First pass: rasterize and pack glyphs into rows
+    int x = 0;
+    int y = 0;
+    int rowHeight = 0;
+    for (int i = 0; i < GLYPH_COUNT; ++i) {
+        const Uint16 ch = static_cast<Uint16>(FIRST_GLYPH + i);
+        int advance = 0;
+        if (TTF_GlyphMetrics(font, ch, nullptr, nullptr, nullptr, nullptr, &advance) != 0) {
+            continue;
+        }
+        page_.glyphs[i].advance = advance;
+
+        SDL_Surface* surface = TTF_RenderGlyph_Solid(font, ch, white);
+        if (!surface) {
+            continue;
+        }
+        surfaces[i] = surface;
+
+        if (x + surface->w > ATLAS_WIDTH) {
+            x = 0;
+            y += rowHeight + 1;
+            rowHeight = 0;
+        }
+        page_.glyphs[i].source = SDL_Rect{x, y, surface->w, surface->h};
+        page_.glyphs[i].advance = std::max(advance, surface->w);
+        x += surface->w + 1;
+        rowHeight = std::max(rowHeight, surface->h);
+        page_.lineHeight = std::max(page_.lineHeight, surface->h);
+    }
+
+    page_.textureWidth = ATLAS_WIDTH;
+    page_.textureHeight = std::max(1, y + rowHeight);
+    std::vector<uint32_t> pixels(static_cast<size_t>(page_.textureWidth) * page_.textureHeight, 0);
+
+    // Second pass: copy coverage into a white ARGB atlas. TTF_RenderGlyph_Solid
+    // yields an 8-bit palettized surface where index 0 is the background.
+    for (int i = 0; i < GLYPH_COUNT; ++i) {
+        SDL_Surface* surface = surfaces[i];
+        if (!surface) {
+            continue;
+        }
+        const SDL_Rect& dst = page_.glyphs[i].source;
+        if (surface->format->BytesPerPixel == 1 && SDL_LockSurface(surface) == 0) {
+            const uint8_t* src = static_cast<const uint8_t*>(surface->pixels);
+            for (int row = 0; row < surface->h; ++row) {
+                const uint8_t* srcRow = src + row * surface->pitch;
+                uint32_t* dstRow = pixels.data() + static_cast<size_t>(dst.y + row) * page_.textureWidth + dst.x;
+                for (int col = 0; col < surface->w; ++col) {
+                    dstRow[col] = srcRow[col] ? 0xFFFFFFFFu : 0u;
+                }
+            }
+            SDL_UnlockSurface(surface);
+        }
+        SDL_FreeSurface(surface);
+    }
+
+    if (!upload(renderer, pixels)) {
+        return false;
+    }
+    page_.fontSize = fontSize;
+    page_.lastUsed = ++useClock_;
+    store(pixels);
+    return true;
+}
+
+const GlyphAtlas::Glyph* GlyphAtlas::glyphFor(char c) const {
+    int index = static_cast<unsigned char>(c) - FIRST_GLYPH;
+    if (index < 0 || index >= GLYPH_COUNT) {
+        index = '?' - FIRST_GLYPH;
+    }
+    return &page_.glyphs[index];
+}
+
+int GlyphAtlas::measure(std::string_view text) const {
+    int width = 0;
+    for (char c : text) {
+        width += glyphFor(c)->advance;
+    }
+    return width;
+}
+
+void GlyphAtlas::draw(int x, int y, std::string_view text, const SDL_Color& color) {
+    if (!page_.texture || text.empty()) {
+        return;
+    }
+
+    const float invWidth = 1.0f / static_cast<float>(page_.textureWidth);
+    const float invHeight = 1.0f / static_cast<float>(page_.textureHeight);
+    float penX = static_cast<float>(x);
+    const float top = static_cast<float>(y);
+    for (char c : text) {
+        const Glyph* glyph = glyphFor(c);
+        const SDL_Rect& src = glyph->source;
+        if (src.w > 0 && src.h > 0) {
+            const float left = penX;
+            const float right = penX + static_cast<float>(src.w);
+            const float bottom = top + static_cast<float>(src.h);
+            const float u0 = static_cast<float>(src.x) * invWidth;
+            const float v0 = static_cast<float>(src.y) * invHeight;
+            const float u1 = static_cast<float>(src.x + src.w) * invWidth;
+            const float v1 = static_cast<float>(src.y + src.h) * invHeight;
+            vertices_.push_back(SDL_Vertex{{left, top}, color, {u0, v0}});
+            vertices_.push_back(SDL_Vertex{{right, top}, color, {u1, v0}});
+            vertices_.push_back(SDL_Vertex{{left, bottom}, color, {u0, v1}});
+            vertices_.push_back(SDL_Vertex{{right, bottom}, color, {u1, v1}});
+        }
+        penX += static_cast<float>(glyph->advance);
+    }
+}
+
+void GlyphAtlas::flush(SDL_Renderer* renderer) {
+    TRACE_SCOPE("text.flush");
+    if (vertices_.empty()) {
+        return;
+    }
+    if (!page_.texture || !renderer) {
+        vertices_.clear();
+        return;
+    }
+
+    const size_t quadCount = vertices_.size() / 4;
+    if (indices_.size() < quadCount * 6) {
+        // Index pattern is the same for every quad; grow it once
+        const size_t firstQuad = indices_.size() / 6;
+        indices_.resize(quadCount * 6);
+        for (size_t q = firstQuad; q < quadCount; ++q) {
+            const int base = static_cast<int>(q * 4);
+            int* idx = &indices_[q * 6];
+            idx[0] = base;
+            idx[1] = base + 1;
+            idx[2] = base + 2;
+            idx[3] = base + 2;
+            idx[4] = base + 1;
+            idx[5] = base + 3;
+        }
+    }
+
+    SDL_RenderGeometry(renderer, page_.texture, vertices_.data(), static_cast<int>(vertices_.size()),
+                       indices_.data(), static_cast<int>(quadCount * 6));
+    vertices_.clear();
+}
+
+uint64_t GlyphAtlas::hashSince(size_t mark) const {
+    return fnv1a(vertices_.data() + mark, (vertices_.size() - mark) * sizeof(SDL_Vertex));
+}
+
+void GlyphAtlas::rewind(size_t mark) {
+    if (mark < vertices_.size()) {
+        vertices_.resize(mark);
+    }
+}
@@ -0,0 +1,90 @@
+#ifndef OSXVIEW_GLYPHATLAS_H
+#define OSXVIEW_GLYPHATLAS_H
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Printable ASCII rasterized once per font size into a single texture.
+// draw() queues textured quads whose vertex color tints the white glyphs and
+// flush() submits everything queued as one SDL_RenderGeometry call, so
+// changing values never creates textures and the vertex/index buffers are
+// reused between frames. The atlases of the last few font sizes are kept, so
+// resizing back to a recent size switches textures instead of rasterizing.
+// With a disk cache set, every page built is also stored as a 1-bit
+// coverage bitmap, and loadCached() brings a page back on the next run
+// without opening the font.
+class GlyphAtlas {
+public:
+    GlyphAtlas() = default;
+    ~GlyphAtlas();
+
+    GlyphAtlas(const GlyphAtlas&) = delete;
+    GlyphAtlas& operator=(const GlyphAtlas&) = delete;
+
+    // The key names the font (path, size, mtime) and the SDL_ttf version;
+    // a page stored under another key is never loaded. Empty disables.
+    void setDiskCache(std::string directory, std::string key);
+    bool loadCached(SDL_Renderer* renderer, int fontSize);
+    bool build(SDL_Renderer* renderer, TTF_Font* font, int fontSize);
+    // Makes a previously built size current again; false if it was evicted
+    bool select(int fontSize);
+    void release();
+
+    bool isReady() const { return page_.texture != nullptr; }
+    int fontSize() const { return page_.fontSize; }
+    int lineHeight() const { return page_.lineHeight; }
+
+    int measure(std::string_view text) const;
+    void draw(int x, int y, std::string_view text, const SDL_Color& color);
+    void flush(SDL_Renderer* renderer);
+
+    // Same mark/hash/rewind protocol as DrawList, for damage tracking
+    size_t mark() const { return vertices_.size(); }
+    uint64_t hashSince(size_t mark) const;
+    void rewind(size_t mark);
+
+private:
+    static const int FIRST_GLYPH = 32;
+    static const int LAST_GLYPH = 126;
+    static const int GLYPH_COUNT = LAST_GLYPH - FIRST_GLYPH + 1;
+    static const int ATLAS_WIDTH = 512;
+    static const size_t CACHED_SIZES = 3;
+
+    struct Glyph {
+        SDL_Rect source{0, 0, 0, 0};
+        int advance = 0;
+    };
+
+    // Everything that depends on the font size
+    struct Page {
+        Glyph glyphs[GLYPH_COUNT];
+        SDL_Texture* texture = nullptr;
+        int textureWidth = 0;
+        int textureHeight = 0;
+        int fontSize = 0;
+        int lineHeight = 0;
+        uint64_t lastUsed = 0;
+    };
+
+    const Glyph* glyphFor(char c) const;
+    void stashCurrent();
+    bool upload(SDL_Renderer* renderer, const std::vector<uint32_t>& pixels);
+    std::string cachePath(int fontSize) const;
+    void store(const std::vector<uint32_t>& pixels) const;
+
+    Page page_;
+    std::vector<Page> recent_;
+    uint64_t useClock_ = 0;
+    std::string cacheDirectory_;
+    std::string cacheKey_;
+
+    std::vector<SDL_Vertex> vertices_;
+    std::vector<int> indices_;
+};
+
+#endif //OSXVIEW_GLYPHATLAS_H
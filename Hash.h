@@ -0,0 +1,20 @@
+#ifndef OSXVIEW_HASH_H
+#define OSXVIEW_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+
+const uint64_t FNV1A_SEED = 14695981039346656037ull;
+
+// 64-bit FNV-1a. Pass a previous result as the seed to hash a sequence of
+// buffers as one; not for anything that needs collision resistance.
+inline uint64_t fnv1a(const void* data, size_t size, uint64_t seed = FNV1A_SEED) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    uint64_t hash = seed;
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+
+#endif //OSXVIEW_HASH_H
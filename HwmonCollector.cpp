@@ -0,0 +1,307 @@
+#include "HwmonCollector.h"
+
+#ifdef __linux__
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+#include <dirent.h>
+#include <fcntl.h>
+#include <linux/netlink.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+bool readInteger(int fd, long long& value) {
+    char buffer[32];
+    const ssize_t length = pread(fd, buffer, sizeof(buffer), 0);
+    if (length <= 0) {
+        return false;
+    }
+    ssize_t i = 0;
+    const bool negative = buffer[0] == '-';
+    if (negative) {
+        ++i;
+    }
+    if (i >= length || buffer[i] < '0' || buffer[i] > '9') {
+        return false;
+    }
+    value = 0;
+    for (; i < length && buffer[i] >= '0' && buffer[i] <= '9'; ++i) {
+        value = value * 10 + (buffer[i] - '0');
+    }
+    if (negative) {
+        value = -value;
+    }
+    return true;
+}
+
+// Discovery-time reads of small attribute files
+std::string readText(const std::string& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return std::string();
+    }
+    char buffer[128];
+    const ssize_t length = pread(fd, buffer, sizeof(buffer), 0);
+    ::close(fd);
+    std::string text(buffer, length > 0 ? static_cast<size_t>(length) : 0);
+    while (!text.empty() && (text.back() == '\n' || text.back() == ' ')) {
+        text.pop_back();
+    }
+    return text;
+}
+
+bool readInteger(const std::string& path, long long& value) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    const bool ok = readInteger(fd, value);
+    ::close(fd);
+    return ok;
+}
+
+// Numbers n of the entries named <prefix><n><suffix>, ascending
+std::vector<int> numberedEntries(const std::string& directory, const char* prefix, const char* suffix) {
+    std::vector<int> numbers;
+    DIR* dir = opendir(directory.c_str());
+    if (!dir) {
+        return numbers;
+    }
+    const size_t prefixLength = std::strlen(prefix);
+    while (dirent* entry = readdir(dir)) {
+        const char* name = entry->d_name;
+        if (std::strncmp(name, prefix, prefixLength) != 0) {
+            continue;
+        }
+        char* end = nullptr;
+        const long number = std::strtol(name + prefixLength, &end, 10);
+        if (end != name + prefixLength && std::strcmp(end, suffix) == 0) {
+            numbers.push_back(static_cast<int>(number));
+        }
+    }
+    closedir(dir);
+    std::sort(numbers.begin(), numbers.end());
+    return numbers;
+}
+
+} // namespace
+
+HwmonCollector::~HwmonCollector() {
+    close();
+}
+
+bool HwmonCollector::open(const std::string& hwmonRoot, const std::string& thermalRoot) {
+    close();
+    hwmonRoot_ = hwmonRoot;
+    thermalRoot_ = thermalRoot;
+    opened_ = true;
+
+    // Kernel uevents announce hwmon and thermal devices coming and going.
+    // Without them (no netlink in a container) a vanished sensor still
+    // triggers a rescan through its ENODEV read.
+    ueventFd_ = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_KOBJECT_UEVENT);
+    if (ueventFd_ >= 0) {
+        sockaddr_nl local{};
+        local.nl_family = AF_NETLINK;
+        local.nl_groups = 1;
+        if (bind(ueventFd_, reinterpret_cast<sockaddr*>(&local), sizeof(local)) != 0) {
+            ::close(ueventFd_);
+            ueventFd_ = -1;
+        }
+    }
+    ueventBuffer_.resize(8192);
+
+    discover();
+    return available();
+}
+
+void HwmonCollector::close() {
+    closeSensors();
+    if (ueventFd_ >= 0) {
+        ::close(ueventFd_);
+        ueventFd_ = -1;
+    }
+    opened_ = false;
+    rescanPending_ = false;
+}
+
+void HwmonCollector::closeSensors() {
+    for (const Fan& fan : fans_) {
+        ::close(fan.fd);
+    }
+    for (const Temperature& temperature : temperatures_) {
+        ::close(temperature.fd);
+    }
+    fans_.clear();
+    temperatures_.clear();
+}
+
+void HwmonCollector::discover() {
+    closeSensors();
+    std::vector<std::string> chips;
+    discoverHwmon(chips);
+    discoverThermal(chips);
+    rescanPending_ = false;
+}
+
+void HwmonCollector::discoverHwmon(std::vector<std::string>& chips) {
+    for (int device : numberedEntries(hwmonRoot_, "hwmon", "")) {
+        const std::string path = hwmonRoot_ + "/hwmon" + std::to_string(device) + "/";
+        std::string chip = readText(path + "name");
+        if (chip.empty()) {
+            chip = "hwmon" + std::to_string(device);
+        }
+        chips.push_back(chip);
+
+        for (int index : numberedEntries(path, "fan", "_input")) {
+            const std::string base = path + "fan" + std::to_string(index);
+            Fan fan;
+            fan.fd = ::open((base + "_input").c_str(), O_RDONLY | O_CLOEXEC);
+            if (fan.fd < 0) {
+                continue;
+            }
+            long long value = 0;
+            if (readInteger(base + "_min", value)) {
+                fan.minRpm = static_cast<double>(value);
+            }
+            if (readInteger(base + "_max", value)) {
+                fan.maxRpm = static_cast<double>(value);
+            }
+            fans_.push_back(fan);
+        }
+
+        for (int index : numberedEntries(path, "temp", "_input")) {
+            const std::string base = path + "temp" + std::to_string(index);
+            Temperature temperature;
+            temperature.fd = ::open((base + "_input").c_str(), O_RDONLY | O_CLOEXEC);
+            if (temperature.fd < 0) {
+                continue;
+            }
+            std::string label = readText(base + "_label");
+            temperature.name = chip + "/" + (label.empty() ? "temp" + std::to_string(index) : label);
+            // Millidegrees; prefer the "high" threshold over the critical one
+            long long value = 0;
+            if (readInteger(base + "_max", value) || readInteger(base + "_crit", value)) {
+                temperature.maxCelsius = static_cast<double>(value) / 1000.0;
+            }
+            temperatures_.push_back(std::move(temperature));
+        }
+    }
+}
+
+void HwmonCollector::discoverThermal(const std::vector<std::string>& chips) {
+    for (int zone : numberedEntries(thermalRoot_, "thermal_zone", "")) {
+        const std::string path = thermalRoot_ + "/thermal_zone" + std::to_string(zone) + "/";
+        const std::string type = readText(path + "type");
+        // Most zones also register a hwmon chip named after their type
+        if (std::find(chips.begin(), chips.end(), type) != chips.end()) {
+            continue;
+        }
+        Temperature temperature;
+        temperature.fd = ::open((path + "temp").c_str(), O_RDONLY | O_CLOEXEC);
+        if (temperature.fd < 0) {
+            continue;
+        }
+        temperature.name = "thermal/" + (type.empty() ? "zone" + std::to_string(zone) : type);
+        for (int trip : numberedEntries(path, "trip_point_", "_type")) {
+            const std::string base = path + "trip_point_" + std::to_string(trip);
+            const std::string tripType = readText(base + "_type");
+            long long value = 0;
+            if ((tripType == "hot" || tripType == "critical") && readInteger(base + "_temp", value)) {
+                temperature.maxCelsius = static_cast<double>(value) / 1000.0;
+                break;
+            }
+        }
+        temperatures_.push_back(std::move(temperature));
+    }
+}
+
+void HwmonCollector::checkHotplug() {
+    if (ueventFd_ >= 0) {
+        for (;;) {
+            const ssize_t length = recv(ueventFd_, ueventBuffer_.data(), ueventBuffer_.size(), MSG_DONTWAIT);
+            if (length <= 0) {
+                break;
+            }
+            // "add@/devices/...\0ACTION=add\0...\0SUBSYSTEM=hwmon\0..."
+            const std::string_view message(ueventBuffer_.data(), static_cast<size_t>(length));
+            if (message.find(std::string_view("SUBSYSTEM=hwmon\0", 16)) != std::string_view::npos ||
+                message.find(std::string_view("SUBSYSTEM=thermal\0", 18)) != std::string_view::npos) {
+                rescanPending_ = true;
+            }
+        }
+    }
+    if (rescanPending_) {
+        discover();
+    }
+}
+
+void HwmonCollector::updateFans(std::vector<FanMetrics>& out) {
+    if (!opened_) {
+        out.clear();
+        return;
+    }
+    checkHotplug();
+    out.resize(fans_.size());
+    for (size_t i = 0; i < fans_.size(); ++i) {
+        long long rpm = 0;
+        FanMetrics& metrics = out[i];
+        errno = 0;
+        metrics.valid = readInteger(fans_[i].fd, rpm);
+        metrics.rpm = metrics.valid ? static_cast<double>(rpm) : 0.0;
+        metrics.minRpm = fans_[i].minRpm;
+        metrics.maxRpm = fans_[i].maxRpm;
+        // A removed device's attributes fail with ENODEV; other errors
+        // (a sensor with no reading yet) just mark the value invalid
+        rescanPending_ |= !metrics.valid && errno == ENODEV;
+    }
+}
+
+void HwmonCollector::updateTemperatures(std::vector<TemperatureMetrics>& out) {
+    if (!opened_) {
+        out.clear();
+        return;
+    }
+    checkHotplug();
+    out.resize(temperatures_.size());
+    for (size_t i = 0; i < temperatures_.size(); ++i) {
+        long long milli = 0;
+        TemperatureMetrics& metrics = out[i];
+        errno = 0;
+        metrics.valid = readInteger(temperatures_[i].fd, milli);
+        metrics.celsius = metrics.valid ? static_cast<double>(milli) / 1000.0 : 0.0;
+        metrics.maxCelsius = temperatures_[i].maxCelsius;
+        if (metrics.name != temperatures_[i].name) {
+            metrics.name = temperatures_[i].name;
+        }
+        // A removed device's attributes fail with ENODEV; other errors
+        // (a sensor with no reading yet) just mark the value invalid
+        rescanPending_ |= !metrics.valid && errno == ENODEV;
+    }
+}
+
+#else
+
+HwmonCollector::~HwmonCollector() = default;
+
+bool HwmonCollector::open(const std::string& /* hwmonRoot */, const std::string& /* thermalRoot */) {
+    return false;
+}
+
+void HwmonCollector::close() {
+}
+
+void HwmonCollector::updateFans(std::vector<FanMetrics>& out) {
+    out.clear();
+}
+
+void HwmonCollector::updateTemperatures(std::vector<TemperatureMetrics>& out) {
+    out.clear();
+}
+
+#endif
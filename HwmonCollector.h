@@ -0,0 +1,64 @@
+#ifndef OSXVIEW_HWMONCOLLECTOR_H
+#define OSXVIEW_HWMONCOLLECTOR_H
+
+#include <string>
+#include <vector>
+#include "SensorMetrics.h"
+
+// Fans and temperature sensors from Linux hwmon (/sys/class/hwmon) and
+// thermal zones (/sys/class/thermal), the counterpart of the SMC keys on
+// macOS. Sensors are discovered at open() and again only when a hwmon or
+// thermal device is hotplugged (a kernel uevent) or a sensor disappears;
+// in between, each update is one pread per sensor on a cached fd. Thermal
+// zones that also register as a hwmon chip are listed once. On other
+// platforms open() fails.
+class HwmonCollector {
+public:
+    HwmonCollector() = default;
+    ~HwmonCollector();
+
+    HwmonCollector(const HwmonCollector&) = delete;
+    HwmonCollector& operator=(const HwmonCollector&) = delete;
+
+    bool open(const std::string& hwmonRoot = "/sys/class/hwmon",
+              const std::string& thermalRoot = "/sys/class/thermal");
+    void close();
+    bool available() const { return !fans_.empty() || !temperatures_.empty(); }
+
+    // Rediscovers on the next update; for callers that know the tree
+    // changed without a uevent (fixture trees, containers without netlink)
+    void rescan() { rescanPending_ = true; }
+
+    void updateFans(std::vector<FanMetrics>& out);
+    void updateTemperatures(std::vector<TemperatureMetrics>& out);
+
+private:
+    struct Fan {
+        int fd = -1;
+        double minRpm = 0.0;
+        double maxRpm = 0.0;
+    };
+
+    struct Temperature {
+        int fd = -1;
+        std::string name;
+        double maxCelsius = 0.0;
+    };
+
+    void discover();
+    void discoverHwmon(std::vector<std::string>& chips);
+    void discoverThermal(const std::vector<std::string>& chips);
+    void closeSensors();
+    void checkHotplug();
+
+    std::string hwmonRoot_;
+    std::string thermalRoot_;
+    int ueventFd_ = -1;
+    bool opened_ = false;
+    bool rescanPending_ = false;
+    std::vector<Fan> fans_;
+    std::vector<Temperature> temperatures_;
+    std::vector<char> ueventBuffer_;
+};
+
+#endif //OSXVIEW_HWMONCOLLECTOR_H
@@ -0,0 +1,106 @@
+#include "MeterRegistry.h"
+#include <cstdlib>
+
+const std::vector<MeterInfo>& meterCatalog() {
+    static const std::vector<MeterInfo> catalog = {
+        // On Linux the busy % comes from the schedstat run time; per-core
+        // clocks are drawn over the bar
+        {MeterKind::CPU, "cpu", SUBSYSTEM_CPU | SUBSYSTEM_SCHED | SUBSYSTEM_CPU_FREQ},
+        {MeterKind::GPU, "gpu", SUBSYSTEM_GPU},
+        {MeterKind::Memory, "mem", SUBSYSTEM_MEMORY},
+        {MeterKind::Swap, "swap", SUBSYSTEM_SWAP},
+        {MeterKind::Disk, "disk", SUBSYSTEM_DISK},
+        {MeterKind::Network, "net", SUBSYSTEM_NETWORK},
+        {MeterKind::Fan, "fan", SUBSYSTEM_FANS},
+        {MeterKind::Battery, "battery", SUBSYSTEM_BATTERY},
+        {MeterKind::IRQ, "irq", SUBSYSTEM_SYSTEM_INFO},
+        // Shares are relative to the host when a group has no limit
+        {MeterKind::Cgroups, "cgroup", SUBSYSTEM_CGROUPS | SUBSYSTEM_MEMORY | SUBSYSTEM_SYSTEM_INFO},
+        {MeterKind::Sched, "sched", SUBSYSTEM_SCHED},
+        {MeterKind::Tcp, "tcp", SUBSYSTEM_TCP},
+        {MeterKind::Numa, "numa", SUBSYSTEM_NUMA},
+        {MeterKind::Temperature, "temp", SUBSYSTEM_TEMPERATURE},
+        {MeterKind::Ipc, "ipc", SUBSYSTEM_PERF},
+        {MeterKind::Self, "self", SUBSYSTEM_SELF},
+    };
+    return catalog;
+}
+
+const MeterInfo& meterInfo(MeterKind kind) {
+    for (const MeterInfo& info : meterCatalog()) {
+        if (info.kind == kind) {
+            return info;
+        }
+    }
+    return meterCatalog().front();
+}
+
+const MeterInfo* findMeter(std::string_view name) {
+    for (const MeterInfo& info : meterCatalog()) {
+        if (name == info.name) {
+            return &info;
+        }
+    }
+    return nullptr;
+}
+
+std::vector<MeterSpec> defaultMeterLayout() {
+    return {
+        {MeterKind::CPU, 1},
+        {MeterKind::GPU, 1},
+        {MeterKind::Memory, 1},
+        {MeterKind::Disk, 1},
+        {MeterKind::Network, 1},
+        {MeterKind::Fan, 1},
+        {MeterKind::Battery, 1},
+    };
+}
+
+bool parseMeterLayout(std::string_view text, std::vector<MeterSpec>& layout, std::string& error) {
+    std::vector<MeterSpec> parsed;
+    while (!text.empty()) {
+        const size_t comma = text.find(',');
+        std::string_view item = text.substr(0, comma);
+        text = comma == std::string_view::npos ? std::string_view() : text.substr(comma + 1);
+        if (item.empty()) {
+            continue;
+        }
+
+        MeterSpec spec;
+        const size_t colon = item.find(':');
+        if (colon != std::string_view::npos) {
+            const std::string weight(item.substr(colon + 1));
+            char* end = nullptr;
+            const long value = std::strtol(weight.c_str(), &end, 10);
+            if (weight.empty() || *end != '\0' || value < 1 || value > 16) {
+                error = "invalid weight in '" + std::string(item) + "'";
+                return false;
+            }
+            spec.weight = static_cast<int>(value);
+            item = item.substr(0, colon);
+        }
+
+        const MeterInfo* info = findMeter(item);
+        if (!info) {
+            error = "unknown meter '" + std::string(item) + "'";
+            return false;
+        }
+        spec.kind = info->kind;
+        parsed.push_back(spec);
+    }
+
+    if (parsed.empty()) {
+        error = "no meters given";
+        return false;
+    }
+    layout = std::move(parsed);
+    return true;
+}
+
+uint32_t subsystemsFor(const std::vector<MeterSpec>& layout) {
+    uint32_t subsystems = 0;
+    for (const MeterSpec& spec : layout) {
+        subsystems |= meterInfo(spec.kind).subsystems;
+    }
+    return subsystems;
+}
@@ -0,0 +1,56 @@
+#ifndef OSXVIEW_METERREGISTRY_H
+#define OSXVIEW_METERREGISTRY_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "SystemMetrics.h"
+
+// Every meter the display knows how to draw, with the collector subsystems
+// it reads. A layout is an ordered list of meters with relative heights;
+// the union of their subsystems is what SystemMetrics has to sample.
+
+enum class MeterKind {
+    CPU,
+    GPU,
+    Memory,
+    Swap,
+    Disk,
+    Network,
+    Fan,
+    Battery,
+    IRQ,
+    Cgroups,
+    Sched,
+    Tcp,
+    Numa,
+    Temperature,
+    Ipc,
+    Self
+};
+
+struct MeterInfo {
+    MeterKind kind;
+    const char* name;       // as used in --meters
+    uint32_t subsystems;    // MetricSubsystem bits
+};
+
+struct MeterSpec {
+    MeterKind kind = MeterKind::CPU;
+    int weight = 1;         // height relative to the other meters
+};
+
+const std::vector<MeterInfo>& meterCatalog();
+const MeterInfo& meterInfo(MeterKind kind);
+const MeterInfo* findMeter(std::string_view name);
+
+// The classic seven-meter panel
+std::vector<MeterSpec> defaultMeterLayout();
+
+// Parses "cpu,mem:2,net" (name[:weight], comma separated)
+bool parseMeterLayout(std::string_view text, std::vector<MeterSpec>& layout, std::string& error);
+
+uint32_t subsystemsFor(const std::vector<MeterSpec>& layout);
+
+#endif //OSXVIEW_METERREGISTRY_H
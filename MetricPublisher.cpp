@@ -0,0 +1,284 @@
+#include "MetricPublisher.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#else
+#include <sys/event.h>
+#endif
+
+namespace {
+
+#ifdef MSG_NOSIGNAL
+constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+constexpr int kSendFlags = 0;
+#endif
+
+bool setNonBlocking(int fd) {
+    const int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+} // namespace
+
+MetricPublisher::~MetricPublisher() {
+    close();
+}
+
+bool MetricPublisher::listen(const std::string& path) {
+    close();
+
+    sockaddr_un address{};
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        return false;
+    }
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    // A socket file left behind by a previous run would make bind fail
+    struct stat info{};
+    if (lstat(path.c_str(), &info) == 0 && S_ISSOCK(info.st_mode)) {
+        unlink(path.c_str());
+    }
+
+    listenFd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd_ < 0) {
+        return false;
+    }
+    if (bind(listenFd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(listenFd_, 64) != 0 || !setNonBlocking(listenFd_)) {
+        ::close(listenFd_);
+        listenFd_ = -1;
+        return false;
+    }
+    path_ = path;
+
+#ifdef __linux__
+    eventFd_ = epoll_create1(EPOLL_CLOEXEC);
+#else
+    eventFd_ = kqueue();
+#endif
+    if (eventFd_ < 0 || !watch(listenFd_, false, true)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void MetricPublisher::close() {
+    for (const auto& [fd, subscriber] : subscribers_) {
+        ::close(fd);
+    }
+    subscribers_.clear();
+    if (eventFd_ >= 0) {
+        ::close(eventFd_);
+        eventFd_ = -1;
+    }
+    if (listenFd_ >= 0) {
+        ::close(listenFd_);
+        listenFd_ = -1;
+        unlink(path_.c_str());
+    }
+    path_.clear();
+}
+
+// Registers fd for reads (hangups show up as readable) and, while output
+// is pending, for writes. add distinguishes first registration.
+bool MetricPublisher::watch(int fd, bool writable, bool add) {
+#ifdef __linux__
+    epoll_event event{};
+    event.events = EPOLLIN;
+    if (writable) {
+        event.events |= EPOLLOUT;
+    }
+    event.data.fd = fd;
+    return epoll_ctl(eventFd_, add ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, fd, &event) == 0;
+#else
+    struct kevent changes[2];
+    int count = 0;
+    if (add) {
+        EV_SET(&changes[count++], fd, EVFILT_READ, EV_ADD, 0, 0, nullptr);
+    }
+    if (add ? writable : true) {
+        EV_SET(&changes[count++], fd, EVFILT_WRITE, writable ? EV_ADD : EV_DELETE, 0, 0, nullptr);
+    }
+    // Deleting a write filter that was never added is harmless
+    return kevent(eventFd_, changes, count, nullptr, 0, nullptr) == 0 || (!add && !writable);
+#endif
+}
+
+void MetricPublisher::drop(int fd) {
+    // Closing the descriptor removes it from the epoll set and kqueue
+    ::close(fd);
+    subscribers_.erase(fd);
+}
+
+void MetricPublisher::poll(int timeoutMs) {
+    if (listenFd_ < 0) {
+        return;
+    }
+
+    struct Ready {
+        int fd;
+        bool readable;
+        bool writable;
+    };
+    std::vector<Ready> ready;
+
+#ifdef __linux__
+    epoll_event events[64];
+    const int count = epoll_wait(eventFd_, events, 64, timeoutMs);
+    for (int i = 0; i < count; ++i) {
+        ready.push_back({events[i].data.fd, (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) != 0,
+                         (events[i].events & EPOLLOUT) != 0});
+    }
+#else
+    struct kevent events[64];
+    timespec timeout{timeoutMs / 1000, (timeoutMs % 1000) * 1000000L};
+    const int count = kevent(eventFd_, nullptr, 0, events, 64, timeoutMs < 0 ? nullptr : &timeout);
+    for (int i = 0; i < count; ++i) {
+        const int fd = static_cast<int>(events[i].ident);
+        const bool error = (events[i].flags & (EV_EOF | EV_ERROR)) != 0;
+        ready.push_back({fd, events[i].filter == EVFILT_READ || error, events[i].filter == EVFILT_WRITE});
+    }
+#endif
+
+    for (const Ready& event : ready) {
+        if (event.fd == listenFd_) {
+            acceptSubscribers();
+            continue;
+        }
+        auto it = subscribers_.find(event.fd);
+        if (it == subscribers_.end()) {
+            continue;
+        }
+        if (event.readable) {
+            // Subscribers never send anything; a read of 0 means they left
+            uint8_t discard[256];
+            const ssize_t n = recv(event.fd, discard, sizeof(discard), 0);
+            if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+                drop(event.fd);
+                continue;
+            }
+        }
+        if (event.writable) {
+            Subscriber& subscriber = it->second;
+            if (!flush(event.fd, subscriber)) {
+                drop(event.fd);
+                continue;
+            }
+            // Caught up after falling behind: one delta covering the skipped samples
+            if (subscriber.output.empty() && subscriber.sentSequence != sequence_) {
+                queueFrame(subscriber);
+                if (!flush(event.fd, subscriber)) {
+                    drop(event.fd);
+                }
+            }
+        }
+    }
+}
+
+void MetricPublisher::acceptSubscribers() {
+    for (;;) {
+        const int fd = accept(listenFd_, nullptr, nullptr);
+        if (fd < 0) {
+            return;
+        }
+        if (subscribers_.size() >= MAX_SUBSCRIBERS || !setNonBlocking(fd)) {
+            ::close(fd);
+            continue;
+        }
+#ifdef SO_NOSIGPIPE
+        const int on = 1;
+        setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+        if (!watch(fd, false, true)) {
+            ::close(fd);
+            continue;
+        }
+        Subscriber& subscriber = subscribers_[fd];
+        if (sequence_ > 0) {
+            queueFrame(subscriber);
+            if (!flush(fd, subscriber)) {
+                drop(fd);
+            }
+        }
+    }
+}
+
+void MetricPublisher::setSchema(const std::vector<SeriesInfo>& series) {
+    schemaFrame_.clear();
+    encodeSchemaFrame(series, schemaFrame_);
+    schemaVersion_++;
+}
+
+void MetricPublisher::publish(int64_t timestampMs, const std::vector<double>& values) {
+    latest_ = values;
+    latestTimestampMs_ = timestampMs;
+    sequence_++;
+
+    for (auto it = subscribers_.begin(); it != subscribers_.end();) {
+        Subscriber& subscriber = it->second;
+        if (!subscriber.output.empty()) {
+            // Still draining an earlier frame; poll() sends the catch-up delta
+            framesCoalesced_++;
+            ++it;
+            continue;
+        }
+        queueFrame(subscriber);
+        if (!flush(it->first, subscriber)) {
+            ::close(it->first);
+            it = subscribers_.erase(it);
+            continue;
+        }
+        ++it;
+    }
+}
+
+void MetricPublisher::queueFrame(Subscriber& subscriber) {
+    if (subscriber.schemaVersion != schemaVersion_) {
+        subscriber.output.insert(subscriber.output.end(), schemaFrame_.begin(), schemaFrame_.end());
+        subscriber.sentBits.assign(latest_.size(), kUnsentValueBits);
+        subscriber.schemaVersion = schemaVersion_;
+    }
+    encodeDeltaFrame(sequence_, latestTimestampMs_, latest_, subscriber.sentBits, subscriber.output);
+    subscriber.sentSequence = sequence_;
+    framesSent_++;
+}
+
+// Writes as much pending output as the socket takes. Returns false when
+// the subscriber is gone.
+bool MetricPublisher::flush(int fd, Subscriber& subscriber) {
+    while (subscriber.written < subscriber.output.size()) {
+        const ssize_t n = send(fd, subscriber.output.data() + subscriber.written,
+                               subscriber.output.size() - subscriber.written, kSendFlags);
+        if (n > 0) {
+            subscriber.written += static_cast<size_t>(n);
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else {
+            return false;
+        }
+    }
+
+    const bool pending = subscriber.written < subscriber.output.size();
+    if (!pending) {
+        subscriber.output.clear();
+        subscriber.written = 0;
+    }
+    if (pending != subscriber.writeInterest) {
+        if (!watch(fd, pending, false)) {
+            return false;
+        }
+        subscriber.writeInterest = pending;
+    }
+    return true;
+}
@@ -0,0 +1,71 @@
+#ifndef OSXVIEW_METRICPUBLISHER_H
+#define OSXVIEW_METRICPUBLISHER_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "MetricStream.h"
+
+// Serves sampled metrics to local subscribers over a Unix domain socket.
+// Everything runs on the caller's thread from one epoll (kqueue on macOS)
+// loop; no write ever blocks the sampler. A subscriber that has not drained
+// its previous frame is skipped, and once it catches up it is sent a single
+// delta against what it last received, so slow readers see coalesced
+// samples instead of a growing queue.
+class MetricPublisher {
+public:
+    MetricPublisher() = default;
+    ~MetricPublisher();
+
+    MetricPublisher(const MetricPublisher&) = delete;
+    MetricPublisher& operator=(const MetricPublisher&) = delete;
+
+    // Replaces a stale socket file left at path
+    bool listen(const std::string& path);
+    void close();
+    // Accepts subscribers and flushes pending output, waiting up to timeoutMs
+    void poll(int timeoutMs);
+
+    // A new layout is sent to every subscriber before the next delta
+    void setSchema(const std::vector<SeriesInfo>& series);
+    void publish(int64_t timestampMs, const std::vector<double>& values);
+
+    size_t subscriberCount() const { return subscribers_.size(); }
+    uint64_t framesSent() const { return framesSent_; }
+    uint64_t framesCoalesced() const { return framesCoalesced_; }
+
+private:
+    static const size_t MAX_SUBSCRIBERS = 1024;
+
+    struct Subscriber {
+        std::vector<uint8_t> output;
+        size_t written = 0;
+        std::vector<uint64_t> sentBits;
+        uint64_t schemaVersion = 0;
+        uint64_t sentSequence = 0;
+        bool writeInterest = false;
+    };
+
+    void acceptSubscribers();
+    void queueFrame(Subscriber& subscriber);
+    bool flush(int fd, Subscriber& subscriber);
+    bool watch(int fd, bool writable, bool add);
+    void drop(int fd);
+
+    int listenFd_ = -1;
+    int eventFd_ = -1;
+    std::string path_;
+    std::unordered_map<int, Subscriber> subscribers_;
+
+    std::vector<uint8_t> schemaFrame_;
+    uint64_t schemaVersion_ = 0;
+    std::vector<double> latest_;
+    int64_t latestTimestampMs_ = 0;
+    uint64_t sequence_ = 0;
+
+    uint64_t framesSent_ = 0;
+    uint64_t framesCoalesced_ = 0;
+};
+
+#endif //OSXVIEW_METRICPUBLISHER_H
@@ -0,0 +1,38 @@
+#include "MetricRecorder.h"
+#include <chrono>
+
+MetricRecorder::MetricRecorder(const std::string& path)
+    : path_(path) {
+}
+
+MetricRecorder::~MetricRecorder() {
+    close();
+}
+
+bool MetricRecorder::openFor(const SystemMetrics& metrics) {
+    return writer_.open(path_, mapper_.layoutFor(metrics));
+}
+
+bool MetricRecorder::record(const SystemMetrics& metrics) {
+    if (failed_) {
+        return false;
+    }
+    if (!writer_.isOpen() && !openFor(metrics)) {
+        failed_ = true;
+        return false;
+    }
+
+    mapper_.values(metrics, values_);
+
+    const int64_t timestampMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    if (!writer_.append(timestampMs, values_.data(), values_.size())) {
+        failed_ = true;
+        return false;
+    }
+    return true;
+}
+
+void MetricRecorder::close() {
+    writer_.close();
+}
@@ -0,0 +1,33 @@
+#ifndef OSXVIEW_METRICRECORDER_H
+#define OSXVIEW_METRICRECORDER_H
+
+#include <string>
+#include <vector>
+#include "MetricSeries.h"
+#include "RecordingFormat.h"
+#include "SystemMetrics.h"
+
+// Maps SystemMetrics snapshots onto the columns of a RecordingWriter.
+// The series layout is fixed from the first recorded snapshot.
+class MetricRecorder {
+public:
+    explicit MetricRecorder(const std::string& path);
+    ~MetricRecorder();
+
+    bool record(const SystemMetrics& metrics);
+    void close();
+
+    bool failed() const { return failed_; }
+    const std::string& path() const { return path_; }
+
+private:
+    bool openFor(const SystemMetrics& metrics);
+
+    std::string path_;
+    RecordingWriter writer_;
+    MetricSeriesMapper mapper_;
+    std::vector<double> values_;
+    bool failed_ = false;
+};
+
+#endif //OSXVIEW_METRICRECORDER_H
@@ -0,0 +1,211 @@
+#include "MetricSeries.h"
+#include <cmath>
+#include <string>
+
+std::vector<SeriesInfo> MetricSeriesMapper::layoutFor(const SystemMetrics& metrics) {
+    cpuCount_ = metrics.getCPUMetrics().size();
+    fanCount_ = metrics.getFanMetrics().size();
+    numaCount_ = metrics.getNumaMetrics().nodes.size();
+    temperatureCount_ = metrics.getTemperatureMetrics().size();
+    perfCount_ = metrics.getPerfMetrics().cores.size();
+
+    std::vector<SeriesInfo> series;
+    auto gauge = [&](const std::string& name) { series.push_back({name, SeriesKind::Gauge}); };
+    // Whole numbers that are not cumulative: memory, sockets and processes
+    // are levels, net.* is the change since the last sample, disk.* a rate
+    auto integer = [&](const std::string& name) { series.push_back({name, SeriesKind::Integer}); };
+    auto percent = [&](const std::string& name) { series.push_back({name, SeriesKind::Fixed}); };
+
+    for (size_t i = 0; i < cpuCount_; ++i) {
+        const std::string prefix = "cpu" + std::to_string(i) + ".";
+        percent(prefix + "user");
+        percent(prefix + "system");
+        percent(prefix + "idle");
+    }
+    for (const char* name : {"mem.total", "mem.used", "mem.free", "mem.active", "mem.inactive", "mem.wired",
+                             "swap.total", "swap.used", "swap.free"}) {
+        integer(name);
+    }
+    percent("gpu.device");
+    percent("gpu.renderer");
+    percent("gpu.tiler");
+    for (const char* name : {"net.bytesIn", "net.bytesOut", "net.packetsIn", "net.packetsOut",
+                             "disk.readBytes", "disk.writeBytes", "disk.readOps", "disk.writeOps"}) {
+        integer(name);
+    }
+    gauge("load.1");
+    gauge("load.5");
+    gauge("load.15");
+    integer("proc.count");
+    percent("battery.charge");
+    integer("battery.onAC");
+    for (size_t i = 0; i < fanCount_; ++i) {
+        gauge("fan" + std::to_string(i) + ".rpm");
+    }
+    percent("sched.busy");
+    percent("sched.wait");
+    gauge("sched.latencyUs");
+    gauge("tcp.retransSegs");
+    percent("tcp.retransPercent");
+    for (const char* name : {"tcp.listenOverflows", "tcp.listenDrops", "tcp.resetsSent", "tcp.establishedResets",
+                             "tcp.attemptFails"}) {
+        gauge(name);
+    }
+    for (const char* name : {"tcp.established", "tcp.timeWait", "tcp.closeWait", "tcp.sockets"}) {
+        integer(name);
+    }
+    gauge("tcp.rttP50Us");
+    gauge("tcp.rttP90Us");
+    gauge("tcp.rttP99Us");
+    for (size_t i = 0; i < cpuCount_; ++i) {
+        gauge("cpu" + std::to_string(i) + ".mhz");
+    }
+    integer("cpu.throttlingCores");
+    percent("numa.remotePercent");
+    for (size_t i = 0; i < numaCount_; ++i) {
+        const std::string prefix = "numa" + std::to_string(i) + ".";
+        integer(prefix + "used");
+        integer(prefix + "free");
+        gauge(prefix + "hits");
+        gauge(prefix + "misses");
+        gauge(prefix + "foreign");
+        percent(prefix + "remotePercent");
+    }
+    for (size_t i = 0; i < temperatureCount_; ++i) {
+        gauge("temp" + std::to_string(i) + ".celsius");
+    }
+    for (const char* name : {"ipc.total", "ipc.cacheMpki", "ipc.branchMpki", "ipc.contextSwitches", "ipc.pageFaults"}) {
+        gauge(name);
+    }
+    for (size_t i = 0; i < perfCount_; ++i) {
+        gauge("ipc.cpu" + std::to_string(i));
+    }
+    percent("self.cpuPercent");
+    integer("self.rss");
+    gauge("self.syscalls");
+    gauge("self.contextSwitches");
+
+    return series;
+}
+
+bool MetricSeriesMapper::layoutChanged(const SystemMetrics& metrics) const {
+    return metrics.getCPUMetrics().size() != cpuCount_ || metrics.getFanMetrics().size() != fanCount_ ||
+           metrics.getNumaMetrics().nodes.size() != numaCount_ ||
+           metrics.getTemperatureMetrics().size() != temperatureCount_ ||
+           metrics.getPerfMetrics().cores.size() != perfCount_;
+}
+
+void MetricSeriesMapper::values(const SystemMetrics& metrics, std::vector<double>& out) const {
+    out.clear();
+    auto put = [&](double value) { out.push_back(value); };
+
+    const auto cpus = metrics.getCPUMetrics();
+    for (size_t c = 0; c < cpuCount_; ++c) {
+        const bool present = c < cpus.size();
+        put(present ? cpus[c].user : NAN);
+        put(present ? cpus[c].system : NAN);
+        put(present ? cpus[c].idle : NAN);
+    }
+
+    const MemoryMetrics mem = metrics.getMemoryMetrics();
+    const MemoryMetrics swap = metrics.getSwapMetrics();
+    put(static_cast<double>(mem.total));
+    put(static_cast<double>(mem.used));
+    put(static_cast<double>(mem.free));
+    put(static_cast<double>(mem.active));
+    put(static_cast<double>(mem.inactive));
+    put(static_cast<double>(mem.wired));
+    put(static_cast<double>(swap.total));
+    put(static_cast<double>(swap.used));
+    put(static_cast<double>(swap.free));
+
+    const GPUMetrics gpu = metrics.getGPUMetrics();
+    put(gpu.valid ? gpu.deviceUtilization : NAN);
+    put(gpu.valid ? gpu.rendererUtilization : NAN);
+    put(gpu.valid ? gpu.tilerUtilization : NAN);
+
+    const NetworkMetrics net = metrics.getNetworkMetrics();
+    const DiskMetrics disk = metrics.getDiskMetrics();
+    put(static_cast<double>(net.bytesIn));
+    put(static_cast<double>(net.bytesOut));
+    put(static_cast<double>(net.packetsIn));
+    put(static_cast<double>(net.packetsOut));
+    put(static_cast<double>(disk.readBytes));
+    put(static_cast<double>(disk.writeBytes));
+    put(static_cast<double>(disk.readOps));
+    put(static_cast<double>(disk.writeOps));
+
+    const SystemInfo info = metrics.getSystemInfo();
+    put(info.loadAverage[0]);
+    put(info.loadAverage[1]);
+    put(info.loadAverage[2]);
+    put(static_cast<double>(info.processCount));
+
+    const BatteryMetrics battery = metrics.getBatteryMetrics();
+    put(battery.isPresent ? battery.chargePercent : NAN);
+    put(battery.onACPower ? 1.0 : 0.0);
+
+    const auto fans = metrics.getFanMetrics();
+    for (size_t f = 0; f < fanCount_; ++f) {
+        put(f < fans.size() && fans[f].valid ? fans[f].rpm : NAN);
+    }
+
+    const SchedMetrics sched = metrics.getSchedMetrics();
+    put(sched.valid ? sched.busyPercent : NAN);
+    put(sched.valid ? sched.waitPercent : NAN);
+    put(sched.valid ? sched.latencyUs : NAN);
+
+    const TcpMetrics tcp = metrics.getTcpMetrics();
+    for (double rate : {tcp.retransSegs, tcp.retransPercent, tcp.listenOverflows, tcp.listenDrops,
+                        tcp.resetsSent, tcp.establishedResets, tcp.attemptFails}) {
+        put(tcp.countersValid ? rate : NAN);
+    }
+    for (uint32_t count : {tcp.established, tcp.timeWait, tcp.closeWait, tcp.total}) {
+        put(tcp.socketsValid ? static_cast<double>(count) : NAN);
+    }
+    put(tcp.rttValid ? tcp.rttP50Us : NAN);
+    put(tcp.rttValid ? tcp.rttP90Us : NAN);
+    put(tcp.rttValid ? tcp.rttP99Us : NAN);
+
+    const CpuFreqMetrics& freq = metrics.getCpuFreqMetrics();
+    for (size_t c = 0; c < cpuCount_; ++c) {
+        put(freq.valid && c < freq.cores.size() ? freq.cores[c].mhz : NAN);
+    }
+    put(freq.valid ? static_cast<double>(freq.throttlingCores) : NAN);
+
+    const NumaMetrics& numa = metrics.getNumaMetrics();
+    put(numa.ratesValid ? numa.remotePercent : NAN);
+    for (size_t n = 0; n < numaCount_; ++n) {
+        const bool present = n < numa.nodes.size();
+        const bool rates = present && numa.ratesValid;
+        put(present ? static_cast<double>(numa.nodes[n].used) : NAN);
+        put(present ? static_cast<double>(numa.nodes[n].free) : NAN);
+        put(rates ? numa.nodes[n].hits : NAN);
+        put(rates ? numa.nodes[n].misses : NAN);
+        put(rates ? numa.nodes[n].foreign : NAN);
+        put(rates ? numa.nodes[n].remotePercent : NAN);
+    }
+
+    const auto& temperatures = metrics.getTemperatureMetrics();
+    for (size_t t = 0; t < temperatureCount_; ++t) {
+        put(t < temperatures.size() && temperatures[t].valid ? temperatures[t].celsius : NAN);
+    }
+
+    // Hardware counters only in hardware mode; software ones in both
+    const PerfMetrics& perf = metrics.getPerfMetrics();
+    const bool hardware = perf.valid && perf.mode == PerfMetrics::Mode::Hardware;
+    put(hardware ? perf.total.ipc : NAN);
+    put(hardware ? perf.total.cacheMissesPerKilo : NAN);
+    put(hardware ? perf.total.branchMissesPerKilo : NAN);
+    put(perf.valid ? perf.total.contextSwitches : NAN);
+    put(perf.valid ? perf.total.pageFaults : NAN);
+    for (size_t c = 0; c < perfCount_; ++c) {
+        put(hardware && c < perf.cores.size() ? perf.cores[c].ipc : NAN);
+    }
+
+    const SelfMetrics& self = metrics.getSelfMetrics();
+    put(self.valid ? self.cpuPercent : NAN);
+    put(self.rssBytes > 0 ? static_cast<double>(self.rssBytes) : NAN);
+    put(self.syscallsValid ? self.syscalls : NAN);
+    put(self.valid ? self.contextSwitches : NAN);
+}
@@ -0,0 +1,29 @@
+#ifndef OSXVIEW_METRICSERIES_H
+#define OSXVIEW_METRICSERIES_H
+
+#include <vector>
+#include "RecordingFormat.h"
+#include "SystemMetrics.h"
+
+// Flattens SystemMetrics snapshots into named series: the columns of a
+// recording and the fields of a published frame. The layout (per-CPU and
+// per-fan, per-sensor, per-NUMA-node and per-core counter series) is fixed by the snapshot
+// passed to layoutFor().
+class MetricSeriesMapper {
+public:
+    std::vector<SeriesInfo> layoutFor(const SystemMetrics& metrics);
+    // True when metrics has a different CPU, fan, sensor, node or counter group
+    // count than the last layout
+    bool layoutChanged(const SystemMetrics& metrics) const;
+    // One value per series in layout order; missing values are NaN
+    void values(const SystemMetrics& metrics, std::vector<double>& out) const;
+
+private:
+    size_t cpuCount_ = 0;
+    size_t fanCount_ = 0;
+    size_t numaCount_ = 0;
+    size_t temperatureCount_ = 0;
+    size_t perfCount_ = 0;
+};
+
+#endif //OSXVIEW_METRICSERIES_H
@@ -0,0 +1,207 @@
+#include "MetricStream.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+constexpr size_t kMaxFrameSize = 16 * 1024 * 1024;
+
+void putBytes(std::vector<uint8_t>& out, uint64_t value, int count) {
+    for (int i = 0; i < count; ++i) {
+        out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+uint64_t getBytes(const uint8_t* in, int count) {
+    uint64_t value = 0;
+    for (int i = 0; i < count; ++i) {
+        value |= static_cast<uint64_t>(in[i]) << (8 * i);
+    }
+    return value;
+}
+
+void putVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value) | 0x80);
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+bool getVarint(const uint8_t*& in, const uint8_t* end, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && in < end; shift += 7) {
+        const uint8_t byte = *in++;
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Reserves the length and type; finishFrame patches the length
+size_t beginFrame(std::vector<uint8_t>& out, StreamFrameType type) {
+    const size_t start = out.size();
+    putBytes(out, 0, 4);
+    out.push_back(static_cast<uint8_t>(type));
+    return start;
+}
+
+void finishFrame(std::vector<uint8_t>& out, size_t start) {
+    const uint32_t length = static_cast<uint32_t>(out.size() - start - 4);
+    for (int i = 0; i < 4; ++i) {
+        out[start + i] = static_cast<uint8_t>(length >> (8 * i));
+    }
+}
+
+} // namespace
+
+void encodeSchemaFrame(const std::vector<SeriesInfo>& series, std::vector<uint8_t>& out) {
+    const size_t start = beginFrame(out, StreamFrameType::Schema);
+    putBytes(out, series.size(), 4);
+    for (const SeriesInfo& info : series) {
+        const size_t length = std::min<size_t>(info.name.size(), 255);
+        out.push_back(static_cast<uint8_t>(info.kind));
+        out.push_back(static_cast<uint8_t>(length));
+        out.insert(out.end(), info.name.begin(), info.name.begin() + length);
+    }
+    finishFrame(out, start);
+}
+
+size_t encodeDeltaFrame(uint64_t sequence, int64_t timestampMs, const std::vector<double>& values,
+                        std::vector<uint64_t>& previousBits, std::vector<uint8_t>& out) {
+    previousBits.resize(values.size(), kUnsentValueBits);
+
+    const size_t start = beginFrame(out, StreamFrameType::Delta);
+    putBytes(out, sequence, 8);
+    putBytes(out, static_cast<uint64_t>(timestampMs), 8);
+
+    // Count first so the change count can lead the entries
+    size_t changed = 0;
+    for (size_t i = 0; i < values.size(); ++i) {
+        uint64_t bits;
+        std::memcpy(&bits, &values[i], sizeof(bits));
+        if (bits != previousBits[i]) {
+            changed++;
+        }
+    }
+    putVarint(out, changed);
+
+    size_t next = 0;
+    for (size_t i = 0; i < values.size(); ++i) {
+        uint64_t bits;
+        std::memcpy(&bits, &values[i], sizeof(bits));
+        if (bits == previousBits[i]) {
+            continue;
+        }
+        putVarint(out, i - next);
+        putBytes(out, bits, 8);
+        previousBits[i] = bits;
+        next = i + 1;
+    }
+    finishFrame(out, start);
+    return changed;
+}
+
+bool MetricStreamDecoder::feed(const uint8_t* data, size_t size) {
+    buffer_.insert(buffer_.end(), data, data + size);
+
+    size_t offset = 0;
+    bool ok = true;
+    while (buffer_.size() - offset >= 5) {
+        const size_t length = static_cast<size_t>(getBytes(buffer_.data() + offset, 4));
+        if (length == 0 || length > kMaxFrameSize) {
+            ok = false;
+            break;
+        }
+        if (buffer_.size() - offset - 4 < length) {
+            break;
+        }
+        if (!parseFrame(buffer_.data() + offset + 4, length)) {
+            ok = false;
+            break;
+        }
+        offset += 4 + length;
+    }
+    buffer_.erase(buffer_.begin(), buffer_.begin() + offset);
+    return ok;
+}
+
+bool MetricStreamDecoder::takeUpdate() {
+    const bool updated = updated_;
+    updated_ = false;
+    return updated;
+}
+
+bool MetricStreamDecoder::parseFrame(const uint8_t* payload, size_t size) {
+    const uint8_t* in = payload + 1;
+    const uint8_t* end = payload + size;
+
+    if (payload[0] == static_cast<uint8_t>(StreamFrameType::Schema)) {
+        if (end - in < 4) {
+            return false;
+        }
+        const size_t count = static_cast<size_t>(getBytes(in, 4));
+        in += 4;
+        std::vector<SeriesInfo> series;
+        for (size_t i = 0; i < count; ++i) {
+            if (end - in < 2 || end - in < 2 + in[1]) {
+                return false;
+            }
+            SeriesInfo info;
+            info.kind = in[0] <= static_cast<uint8_t>(SeriesKind::Integer) ? static_cast<SeriesKind>(in[0]) : SeriesKind::Gauge;
+            info.name.assign(reinterpret_cast<const char*>(in + 2), in[1]);
+            in += 2 + in[1];
+            series.push_back(std::move(info));
+        }
+        series_ = std::move(series);
+        values_.assign(series_.size(), NAN);
+        haveDelta_ = false;
+        return true;
+    }
+
+    if (payload[0] == static_cast<uint8_t>(StreamFrameType::Delta)) {
+        if (end - in < 16) {
+            return false;
+        }
+        const uint64_t sequence = getBytes(in, 8);
+        const int64_t timestampMs = static_cast<int64_t>(getBytes(in + 8, 8));
+        in += 16;
+        uint64_t changed = 0;
+        if (!getVarint(in, end, changed)) {
+            return false;
+        }
+
+        size_t next = 0;
+        for (uint64_t c = 0; c < changed; ++c) {
+            uint64_t gap = 0;
+            if (!getVarint(in, end, gap) || end - in < 8) {
+                return false;
+            }
+            const size_t index = next + static_cast<size_t>(gap);
+            if (index >= values_.size()) {
+                return false;
+            }
+            const uint64_t bits = getBytes(in, 8);
+            in += 8;
+            std::memcpy(&values_[index], &bits, sizeof(bits));
+            next = index + 1;
+        }
+
+        // Sequence numbers count samples, so a jump means frames were coalesced
+        if (haveDelta_ && sequence > sequence_ + 1) {
+            gaps_ += sequence - sequence_ - 1;
+        }
+        sequence_ = sequence;
+        timestampMs_ = timestampMs;
+        lastChangeCount_ = static_cast<size_t>(changed);
+        haveDelta_ = true;
+        updated_ = true;
+        return true;
+    }
+
+    // Unknown frame types are skipped so the format can grow
+    return true;
+}
@@ -0,0 +1,64 @@
+#ifndef OSXVIEW_METRICSTREAM_H
+#define OSXVIEW_METRICSTREAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "RecordingFormat.h"
+
+// Frames sent by the collector daemon to its subscribers over a stream socket.
+//
+// Every frame is a u32 payload length, a u8 type and the payload (little-endian):
+//   Schema: u32 series count, then per series u8 kind, u8 name length, name
+//   Delta:  u64 sequence, i64 timestamp (ms), varint change count, then per
+//           change a varint index gap (from the previous changed index + 1)
+//           and the f64 value
+//
+// A delta carries only the series whose value differs from the last frame
+// that subscriber was sent; the first delta after a schema carries all of them.
+
+enum class StreamFrameType : uint8_t {
+    Schema = 1,
+    Delta = 2
+};
+
+void encodeSchemaFrame(const std::vector<SeriesInfo>& series, std::vector<uint8_t>& out);
+
+// Appends a delta of values against previousBits (the bit patterns last sent)
+// and updates previousBits. Returns the number of series included.
+size_t encodeDeltaFrame(uint64_t sequence, int64_t timestampMs, const std::vector<double>& values,
+                        std::vector<uint64_t>& previousBits, std::vector<uint8_t>& out);
+
+// Bit pattern for "nothing sent yet"; a NaN payload no collector produces
+constexpr uint64_t kUnsentValueBits = 0x7FF4DEADBEEF0001ull;
+
+// Rebuilds the full snapshot on the subscriber side from a byte stream
+class MetricStreamDecoder {
+public:
+    // Feeds received bytes; returns false on a malformed stream
+    bool feed(const uint8_t* data, size_t size);
+    // True once per delta applied since the last call
+    bool takeUpdate();
+
+    const std::vector<SeriesInfo>& series() const { return series_; }
+    const std::vector<double>& values() const { return values_; }
+    uint64_t sequence() const { return sequence_; }
+    int64_t timestampMs() const { return timestampMs_; }
+    size_t lastChangeCount() const { return lastChangeCount_; }
+    uint64_t gaps() const { return gaps_; }
+
+private:
+    bool parseFrame(const uint8_t* payload, size_t size);
+
+    std::vector<uint8_t> buffer_;
+    std::vector<SeriesInfo> series_;
+    std::vector<double> values_;
+    uint64_t sequence_ = 0;
+    int64_t timestampMs_ = 0;
+    size_t lastChangeCount_ = 0;
+    uint64_t gaps_ = 0;
+    bool haveDelta_ = false;
+    bool updated_ = false;
+};
+
+#endif //OSXVIEW_METRICSTREAM_H
@@ -0,0 +1,191 @@
+#include "NumaCollector.h"
+
+#ifdef __linux__
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+// Calls fn(key, value) for every "Node 0 MemFree:  123 kB" (meminfo) or
+// "numa_hit 123" (numastat) line, without copying
+template <typename Fn>
+void forEachField(const char* p, const char* end, Fn fn) {
+    while (p < end) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+        if (!lineEnd) {
+            lineEnd = end;
+        }
+        const char* colon = static_cast<const char*>(std::memchr(p, ':', static_cast<size_t>(lineEnd - p)));
+        const char* keyEnd = colon ? colon : static_cast<const char*>(std::memchr(p, ' ', static_cast<size_t>(lineEnd - p)));
+        if (keyEnd) {
+            const char* keyStart = keyEnd;
+            while (keyStart > p && keyStart[-1] != ' ') {
+                --keyStart;
+            }
+            const char* v = keyEnd + 1;
+            while (v < lineEnd && *v == ' ') {
+                ++v;
+            }
+            uint64_t value = 0;
+            while (v < lineEnd && *v >= '0' && *v <= '9') {
+                value = value * 10 + static_cast<uint64_t>(*v - '0');
+                ++v;
+            }
+            fn(std::string_view(keyStart, static_cast<size_t>(keyEnd - keyStart)), value);
+        }
+        p = lineEnd + 1;
+    }
+}
+
+} // namespace
+
+NumaCollector::~NumaCollector() {
+    close();
+}
+
+bool NumaCollector::open(const std::string& root) {
+    close();
+    DIR* dir = opendir(root.c_str());
+    if (!dir) {
+        return false;
+    }
+    while (dirent* entry = readdir(dir)) {
+        const char* name = entry->d_name;
+        if (std::strncmp(name, "node", 4) != 0 || name[4] < '0' || name[4] > '9') {
+            continue;
+        }
+        Node node;
+        node.id = std::atoi(name + 4);
+        const std::string path = root + "/" + name;
+        node.meminfoFd = ::open((path + "/meminfo").c_str(), O_RDONLY | O_CLOEXEC);
+        node.numastatFd = ::open((path + "/numastat").c_str(), O_RDONLY | O_CLOEXEC);
+        if (node.meminfoFd < 0) {
+            if (node.numastatFd >= 0) {
+                ::close(node.numastatFd);
+            }
+            continue;
+        }
+        nodes_.push_back(node);
+    }
+    closedir(dir);
+
+    std::sort(nodes_.begin(), nodes_.end(), [](const Node& a, const Node& b) { return a.id < b.id; });
+    // A node's meminfo is about 1.5 KB
+    buffer_.resize(8192);
+    return !nodes_.empty();
+}
+
+void NumaCollector::close() {
+    for (Node& node : nodes_) {
+        ::close(node.meminfoFd);
+        if (node.numastatFd >= 0) {
+            ::close(node.numastatFd);
+        }
+    }
+    nodes_.clear();
+    haveSample_ = false;
+}
+
+bool NumaCollector::readFile(int fd, size_t& length) {
+    ssize_t result = pread(fd, buffer_.data(), buffer_.size(), 0);
+    while (result == static_cast<ssize_t>(buffer_.size())) {
+        buffer_.resize(buffer_.size() * 2);
+        result = pread(fd, buffer_.data(), buffer_.size(), 0);
+    }
+    if (result <= 0) {
+        return false;
+    }
+    length = static_cast<size_t>(result);
+    return true;
+}
+
+void NumaCollector::update(NumaMetrics& out) {
+    const auto now = std::chrono::steady_clock::now();
+    const double elapsed = std::chrono::duration<double>(now - previousTime_).count();
+    const bool rates = haveSample_ && elapsed > 0.0;
+
+    out.nodes.resize(nodes_.size());
+    double hits = 0.0;
+    double misses = 0.0;
+    for (size_t i = 0; i < nodes_.size(); ++i) {
+        Node& node = nodes_[i];
+        NumaNodeMetrics& metrics = out.nodes[i];
+        metrics.node = node.id;
+
+        size_t length = 0;
+        if (readFile(node.meminfoFd, length)) {
+            uint64_t used = 0;
+            bool haveUsed = false;
+            forEachField(buffer_.data(), buffer_.data() + length, [&](std::string_view key, uint64_t value) {
+                if (key == "MemTotal") {
+                    metrics.total = value * 1024;
+                } else if (key == "MemFree") {
+                    metrics.free = value * 1024;
+                } else if (key == "MemUsed") {
+                    used = value * 1024;
+                    haveUsed = true;
+                }
+            });
+            metrics.used = haveUsed ? used : metrics.total - std::min(metrics.total, metrics.free);
+        }
+
+        uint64_t hit = node.hits;
+        uint64_t miss = node.misses;
+        uint64_t foreign = node.foreign;
+        if (node.numastatFd >= 0 && readFile(node.numastatFd, length)) {
+            forEachField(buffer_.data(), buffer_.data() + length, [&](std::string_view key, uint64_t value) {
+                if (key == "numa_hit") {
+                    hit = value;
+                } else if (key == "numa_miss") {
+                    miss = value;
+                } else if (key == "numa_foreign") {
+                    foreign = value;
+                }
+            });
+        }
+        if (rates) {
+            auto rate = [elapsed](uint64_t current, uint64_t previous) {
+                return current >= previous ? static_cast<double>(current - previous) / elapsed : 0.0;
+            };
+            metrics.hits = rate(hit, node.hits);
+            metrics.misses = rate(miss, node.misses);
+            metrics.foreign = rate(foreign, node.foreign);
+            const double allocations = metrics.hits + metrics.misses;
+            metrics.remotePercent = allocations > 0.0 ? metrics.misses / allocations * 100.0 : 0.0;
+            hits += metrics.hits;
+            misses += metrics.misses;
+        }
+        node.hits = hit;
+        node.misses = miss;
+        node.foreign = foreign;
+    }
+
+    out.remotePercent = hits + misses > 0.0 ? misses / (hits + misses) * 100.0 : 0.0;
+    out.ratesValid = rates && !nodes_.empty();
+    previousTime_ = now;
+    haveSample_ = true;
+}
+
+#else
+
+NumaCollector::~NumaCollector() = default;
+
+bool NumaCollector::open(const std::string& /* root */) {
+    return false;
+}
+
+void NumaCollector::close() {
+}
+
+void NumaCollector::update(NumaMetrics& out) {
+    out.nodes.clear();
+    out.ratesValid = false;
+}
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef OSXVIEW_NUMACOLLECTOR_H
+#define OSXVIEW_NUMACOLLECTOR_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct NumaNodeMetrics {
+    int node = 0;
+    uint64_t total = 0;             // bytes
+    uint64_t free = 0;
+    uint64_t used = 0;
+    // Page allocations per second, from numastat
+    double hits = 0.0;              // placed on this node as intended
+    double misses = 0.0;            // placed here because the preferred node was full
+    double foreign = 0.0;           // meant for this node, placed elsewhere
+    double remotePercent = 0.0;     // misses of hits + misses
+};
+
+struct NumaMetrics {
+    std::vector<NumaNodeMetrics> nodes;
+    double remotePercent = 0.0;     // over all nodes
+    bool ratesValid = false;        // rates need two samples
+};
+
+// Per-node memory and allocation locality from Linux sysfs
+// (/sys/devices/system/node/node*/meminfo and numastat). Nodes are listed
+// once at open(); their files stay open and are re-read with pread into
+// one buffer and parsed in place, so an update allocates nothing. On
+// other platforms, and on machines without NUMA sysfs, open() fails.
+class NumaCollector {
+public:
+    NumaCollector() = default;
+    ~NumaCollector();
+
+    NumaCollector(const NumaCollector&) = delete;
+    NumaCollector& operator=(const NumaCollector&) = delete;
+
+    bool open(const std::string& root = "/sys/devices/system/node");
+    void close();
+    bool available() const { return !nodes_.empty(); }
+
+    void update(NumaMetrics& out);
+
+private:
+    struct Node {
+        int id = 0;
+        int meminfoFd = -1;
+        int numastatFd = -1;
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t foreign = 0;
+    };
+
+    bool readFile(int fd, size_t& length);
+
+    std::vector<Node> nodes_;
+    std::vector<char> buffer_;
+    std::chrono::steady_clock::time_point previousTime_;
+    bool haveSample_ = false;
+};
+
+#endif //OSXVIEW_NUMACOLLECTOR_H
@@ -0,0 +1,207 @@
+#include "PerfCollector.h"
+
+#ifdef __linux__
+
+#include <cerrno>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+int openEvent(uint32_t type, uint64_t config, int cpu, int leader) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    attr.disabled = leader < 0 ? 1 : 0;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, -1, cpu, leader, PERF_FLAG_FD_CLOEXEC));
+}
+
+} // namespace
+
+PerfCollector::~PerfCollector() {
+    close();
+}
+
+bool PerfCollector::open() {
+    close();
+    if (openGroups(true)) {
+        mode_ = PerfMetrics::Mode::Hardware;
+    } else if (openGroups(false)) {
+        mode_ = PerfMetrics::Mode::Software;
+    }
+    return available();
+}
+
+bool PerfCollector::openGroups(bool hardware) {
+    struct Event {
+        uint32_t type;
+        uint64_t config;
+    };
+    static const Event hardwareEvents[HW_EVENT_COUNT] = {
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+        {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES},
+        {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+    };
+    static const Event softwareEvents[SW_EVENT_COUNT] = {
+        {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_CLOCK},
+        {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES},
+        {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+    };
+    const Event* events = hardware ? hardwareEvents : softwareEvents;
+    const int eventCount = hardware ? static_cast<int>(HW_EVENT_COUNT) : static_cast<int>(SW_EVENT_COUNT);
+
+    const long cpus = sysconf(_SC_NPROCESSORS_CONF);
+    for (int cpu = 0; cpu < cpus; ++cpu) {
+        Group group;
+        for (int e = 0; e < eventCount; ++e) {
+            const int fd = openEvent(events[e].type, events[e].config, cpu, group.fds.empty() ? -1 : group.fds[0]);
+            if (fd < 0) {
+                break;
+            }
+            group.fds.push_back(fd);
+        }
+        if (static_cast<int>(group.fds.size()) == eventCount) {
+            groups_.push_back(std::move(group));
+            continue;
+        }
+
+        const int error = errno;
+        for (int fd : group.fds) {
+            ::close(fd);
+        }
+        // Offline CPUs can't be counted; any other failure (no PMU, no
+        // permission, too few counters for the group) applies to all
+        if (error != ENODEV || !group.fds.empty()) {
+            close();
+            return false;
+        }
+    }
+    if (groups_.empty()) {
+        return false;
+    }
+
+    for (const Group& group : groups_) {
+        ioctl(group.fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+    readBuffer_.resize(3 + static_cast<size_t>(eventCount));
+    return true;
+}
+
+void PerfCollector::close() {
+    for (const Group& group : groups_) {
+        for (int fd : group.fds) {
+            ::close(fd);
+        }
+    }
+    groups_.clear();
+    mode_ = PerfMetrics::Mode::None;
+}
+
+void PerfCollector::update(PerfMetrics& out) {
+    out.mode = mode_;
+    out.valid = false;
+    if (groups_.empty()) {
+        out.cores.clear();
+        return;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    const double elapsed = std::chrono::duration<double>(now - previousTime_).count();
+    previousTime_ = now;
+
+    const bool hardware = mode_ == PerfMetrics::Mode::Hardware;
+    const size_t eventCount = readBuffer_.size() - 3;
+    const size_t bytes = readBuffer_.size() * sizeof(uint64_t);
+    out.cores.resize(groups_.size());
+    double cycles = 0.0;
+    double instructions = 0.0;
+    double cacheMisses = 0.0;
+    double branchMisses = 0.0;
+    out.total = PerfCoreMetrics{};
+    bool valid = elapsed > 0.0;
+
+    for (size_t i = 0; i < groups_.size(); ++i) {
+        Group& group = groups_[i];
+        PerfCoreMetrics& core = out.cores[i];
+        // { nr, time_enabled, time_running, value[nr] }
+        if (read(group.fds[0], readBuffer_.data(), bytes) != static_cast<ssize_t>(bytes) || readBuffer_[0] != eventCount) {
+            core = PerfCoreMetrics{};
+            valid = false;
+            continue;
+        }
+        const uint64_t enabled = readBuffer_[1];
+        const uint64_t running = readBuffer_[2];
+        const uint64_t* values = &readBuffer_[3];
+
+        // Scale for the share of the interval the group was on the PMU
+        const uint64_t enabledDelta = enabled - group.timeEnabled;
+        const uint64_t runningDelta = running - group.timeRunning;
+        const double scale = runningDelta > 0 ? static_cast<double>(enabledDelta) / static_cast<double>(runningDelta) : 0.0;
+        auto delta = [&](size_t event) {
+            return static_cast<double>(values[event] - group.counts[event]) * scale;
+        };
+
+        if (group.primed && elapsed > 0.0) {
+            if (hardware) {
+                const double groupCycles = delta(HW_CYCLES);
+                const double groupInstructions = delta(HW_INSTRUCTIONS);
+                core.ipc = groupCycles > 0.0 ? groupInstructions / groupCycles : 0.0;
+                core.cacheMissesPerKilo = groupInstructions > 0.0 ? delta(HW_CACHE_MISSES) * 1000.0 / groupInstructions : 0.0;
+                core.branchMissesPerKilo = groupInstructions > 0.0 ? delta(HW_BRANCH_MISSES) * 1000.0 / groupInstructions : 0.0;
+                core.contextSwitches = delta(HW_CONTEXT_SWITCHES) / elapsed;
+                core.pageFaults = delta(HW_PAGE_FAULTS) / elapsed;
+                cycles += groupCycles;
+                instructions += groupInstructions;
+                cacheMisses += delta(HW_CACHE_MISSES);
+                branchMisses += delta(HW_BRANCH_MISSES);
+            } else {
+                core.contextSwitches = delta(SW_CONTEXT_SWITCHES) / elapsed;
+                core.pageFaults = delta(SW_PAGE_FAULTS) / elapsed;
+            }
+            out.total.contextSwitches += core.contextSwitches;
+            out.total.pageFaults += core.pageFaults;
+        } else {
+            valid = false;
+        }
+
+        std::memcpy(group.counts, values, eventCount * sizeof(uint64_t));
+        group.timeEnabled = enabled;
+        group.timeRunning = running;
+        group.primed = true;
+    }
+
+    if (hardware) {
+        out.total.ipc = cycles > 0.0 ? instructions / cycles : 0.0;
+        out.total.cacheMissesPerKilo = instructions > 0.0 ? cacheMisses * 1000.0 / instructions : 0.0;
+        out.total.branchMissesPerKilo = instructions > 0.0 ? branchMisses * 1000.0 / instructions : 0.0;
+    }
+    out.valid = valid;
+}
+
+#else
+
+PerfCollector::~PerfCollector() = default;
+
+bool PerfCollector::open() {
+    return false;
+}
+
+void PerfCollector::close() {
+}
+
+void PerfCollector::update(PerfMetrics& out) {
+    out.cores.clear();
+    out.mode = PerfMetrics::Mode::None;
+    out.valid = false;
+}
+
+#endif
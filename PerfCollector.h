@@ -0,0 +1,86 @@
+#ifndef OSXVIEW_PERFCOLLECTOR_H
+#define OSXVIEW_PERFCOLLECTOR_H
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+struct PerfCoreMetrics {
+    // Hardware mode
+    double ipc = 0.0;                   // instructions per cycle
+    double cacheMissesPerKilo = 0.0;    // per 1000 instructions
+    double branchMissesPerKilo = 0.0;
+    // Both modes, per second
+    double contextSwitches = 0.0;
+    double pageFaults = 0.0;
+};
+
+struct PerfMetrics {
+    enum class Mode {
+        None,
+        Hardware,   // cycles, instructions, cache and branch misses
+        Software    // no PMU (most VMs): scheduler and fault counts only
+    };
+
+    std::vector<PerfCoreMetrics> cores;
+    PerfCoreMetrics total;              // IPC and miss rates over all cores, rates summed
+    Mode mode = Mode::None;
+    bool valid = false;                 // rates need two reads
+};
+
+// Per-CPU performance counters through perf_event_open. Each CPU gets one
+// event group (a leader plus its siblings) read with a single read() in
+// PERF_FORMAT_GROUP layout; counts are scaled by enabled/running time when
+// the PMU multiplexes. Without hardware events the groups fall back to
+// software events. Needs CAP_PERFMON or perf_event_paranoid <= 0 to count
+// system-wide; on other platforms open() fails.
+class PerfCollector {
+public:
+    PerfCollector() = default;
+    ~PerfCollector();
+
+    PerfCollector(const PerfCollector&) = delete;
+    PerfCollector& operator=(const PerfCollector&) = delete;
+
+    bool open();
+    void close();
+    bool available() const { return mode_ != PerfMetrics::Mode::None; }
+
+    void update(PerfMetrics& out);
+
+private:
+    // Sibling order within a group, after the leader
+    enum HardwareEvent {
+        HW_CYCLES,
+        HW_INSTRUCTIONS,
+        HW_CACHE_MISSES,
+        HW_BRANCH_MISSES,
+        HW_CONTEXT_SWITCHES,
+        HW_PAGE_FAULTS,
+        HW_EVENT_COUNT
+    };
+    enum SoftwareEvent {
+        SW_CPU_CLOCK,
+        SW_CONTEXT_SWITCHES,
+        SW_PAGE_FAULTS,
+        SW_EVENT_COUNT
+    };
+    static const int MAX_EVENTS = HW_EVENT_COUNT;
+
+    struct Group {
+        std::vector<int> fds;           // fds[0] is the leader
+        uint64_t counts[MAX_EVENTS] = {};
+        uint64_t timeEnabled = 0;
+        uint64_t timeRunning = 0;
+        bool primed = false;
+    };
+
+    bool openGroups(bool hardware);
+
+    PerfMetrics::Mode mode_ = PerfMetrics::Mode::None;
+    std::vector<Group> groups_;
+    std::vector<uint64_t> readBuffer_;
+    std::chrono::steady_clock::time_point previousTime_;
+};
+
+#endif //OSXVIEW_PERFCOLLECTOR_H
@@ -0,0 +1,763 @@
+#include "RecordingFormat.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <unistd.h>
+
+namespace {
+
+constexpr uint32_t kFileMagic = 0x5256584F;    // "OXVR"
+constexpr uint32_t kBlockMagic = 0x4256584F;   // "OXVB"
+constexpr uint32_t kIndexMagic = 0x4956584F;   // "OXVI"
+constexpr uint16_t kFormatVersion = 3;   // 2 added SeriesKind::Fixed, 3 SeriesKind::Integer
+
+struct FileHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t seriesCount;
+};
+
+struct BlockHeader {
+    uint32_t magic;
+    uint32_t sampleCount;
+    int64_t firstTimestamp;
+    int64_t lastTimestamp;
+    uint32_t payloadBytes;
+    uint32_t crc;
+};
+
+struct IndexRecord {
+    int64_t firstTimestamp;
+    int64_t lastTimestamp;
+    uint64_t offset;
+    uint32_t sampleCount;
+    uint32_t payloadBytes;
+};
+
+struct IndexTrailer {
+    uint64_t indexOffset;
+    uint32_t entryCount;
+    uint32_t crc;
+    uint32_t magic;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(FileHeader) == 12, "FileHeader size mismatch");
+static_assert(sizeof(BlockHeader) == 32, "BlockHeader size mismatch");
+static_assert(sizeof(IndexRecord) == 32, "IndexRecord size mismatch");
+static_assert(sizeof(IndexTrailer) == 24, "IndexTrailer size mismatch");
+
+struct Crc32Table {
+    uint32_t entries[256];
+
+    constexpr Crc32Table() : entries{} {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+            }
+            entries[i] = c;
+        }
+    }
+};
+
+constexpr Crc32Table kCrcTable;
+
+template <typename T>
+bool readStruct(const uint8_t* data, size_t size, size_t offset, T& out) {
+    if (offset > size || size - offset < sizeof(T)) {
+        return false;
+    }
+    std::memcpy(&out, data + offset, sizeof(T));
+    return true;
+}
+
+uint64_t zigzagEncode(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t zigzagDecode(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+// Fixed-point columns: hundredths, clamped so a real delta never reaches the
+// missing-value marker
+constexpr double kFixedScale = 100.0;
+constexpr double kFixedLimit = 1e15;
+constexpr int64_t kFixedMissing = INT64_MIN;
+
+} // namespace
+
+uint32_t recordingCrc32(const uint8_t* data, size_t size, uint32_t crc) {
+    crc = ~crc;
+    for (size_t i = 0; i < size; ++i) {
+        crc = kCrcTable.entries[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+void BitWriter::writeBits(uint64_t value, int count) {
+    while (count > 0) {
+        if (bitPos_ == 0) {
+            bytes_.push_back(0);
+        }
+        const int room = 8 - bitPos_;
+        const int take = count < room ? count : room;
+        const uint8_t chunk = static_cast<uint8_t>((value >> (count - take)) & ((1u << take) - 1));
+        bytes_.back() |= static_cast<uint8_t>(chunk << (room - take));
+        bitPos_ = (bitPos_ + take) & 7;
+        count -= take;
+    }
+}
+
+void BitWriter::writeVarint(uint64_t value) {
+    while (value >= 0x80) {
+        writeBits((value & 0x7F) | 0x80, 8);
+        value >>= 7;
+    }
+    writeBits(value, 8);
+}
+
+void BitReader::refill() {
+    // Keep the unread bits left-aligned in a 64-bit window so most reads are
+    // a shift and a mask instead of a per-byte loop.
+    if (available_ <= 0 && bytePos_ + 8 <= size_) {
+        uint64_t word = 0;
+        for (int i = 0; i < 8; ++i) {
+            word = (word << 8) | data_[bytePos_ + i];
+        }
+        window_ = word;
+        available_ = 64;
+        bytePos_ += 8;
+        return;
+    }
+    while (available_ <= 56 && bytePos_ < size_) {
+        window_ |= static_cast<uint64_t>(data_[bytePos_++]) << (56 - available_);
+        available_ += 8;
+    }
+}
+
+uint64_t BitReader::readBitsSlow(int count) {
+    if (count <= 0) {
+        return 0;
+    }
+    if (count > 56) {
+        const uint64_t high = readBits(count - 32);
+        return (high << 32) | readBits(32);
+    }
+    if (available_ < count) {
+        refill();
+        if (available_ < count) {
+            overflowed_ = true;
+            return 0;
+        }
+    }
+    const uint64_t value = window_ >> (64 - count);
+    window_ <<= count;
+    available_ -= count;
+    return value;
+}
+
+uint64_t BitReader::readVarint() {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        uint64_t byte = readBits(8);
+        if (overflowed_) {
+            return 0;
+        }
+        value |= (byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            break;
+        }
+    }
+    return value;
+}
+
+RecordingWriter::RecordingWriter(uint32_t samplesPerBlock)
+    : samplesPerBlock_(std::max<uint32_t>(1, samplesPerBlock)) {
+}
+
+RecordingWriter::~RecordingWriter() {
+    close();
+}
+
+bool RecordingWriter::open(const std::string& path, const std::vector<SeriesInfo>& series) {
+    close();
+
+    // An existing recording is continued rather than truncated
+    file_ = std::fopen(path.c_str(), "r+b");
+    if (!file_) {
+        file_ = std::fopen(path.c_str(), "wb");
+    }
+    if (!file_) {
+        return false;
+    }
+
+    series_ = series;
+    columns_.assign(series_.size(), ColumnState{});
+    for (size_t i = 0; i < series_.size(); ++i) {
+        columns_[i].kind = series_[i].kind;
+    }
+    index_.clear();
+    bytesWritten_ = 0;
+    valuesWritten_ = 0;
+    resetBlock();
+
+    std::vector<uint8_t> header;
+    FileHeader fileHeader{kFileMagic, kFormatVersion, 0, static_cast<uint32_t>(series_.size())};
+    header.resize(sizeof(fileHeader));
+    std::memcpy(header.data(), &fileHeader, sizeof(fileHeader));
+    for (const auto& info : series_) {
+        const uint16_t nameLength = static_cast<uint16_t>(std::min<size_t>(info.name.size(), 0xFFFF));
+        header.push_back(static_cast<uint8_t>(info.kind));
+        header.push_back(0);
+        header.push_back(static_cast<uint8_t>(nameLength & 0xFF));
+        header.push_back(static_cast<uint8_t>(nameLength >> 8));
+        header.insert(header.end(), info.name.begin(), info.name.begin() + nameLength);
+    }
+    const uint32_t crc = recordingCrc32(header.data(), header.size());
+
+    std::fseek(file_, 0, SEEK_END);
+    const long existing = std::ftell(file_);
+    if (existing > 0) {
+        if (!resume(header.size() + sizeof(crc), static_cast<size_t>(existing))) {
+            std::fclose(file_);
+            file_ = nullptr;
+            return false;
+        }
+        return true;
+    }
+
+    if (!writeRaw(header.data(), header.size()) || !writeRaw(&crc, sizeof(crc))) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool RecordingWriter::resume(size_t headerBytes, size_t fileBytes) {
+    std::vector<uint8_t> data(fileBytes);
+    std::fseek(file_, 0, SEEK_SET);
+    if (std::fread(data.data(), 1, data.size(), file_) != data.size()) {
+        return false;
+    }
+
+    // Refuse anything that is not a recording of exactly these series, so a
+    // changed layout never produces blocks the header does not describe
+    RecordingReader reader;
+    if (!reader.open(data.data(), data.size()) || reader.series().size() != series_.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < series_.size(); ++i) {
+        if (reader.series()[i].name != series_[i].name || reader.series()[i].kind != series_[i].kind) {
+            return false;
+        }
+    }
+
+    // Keep every intact block; a block torn by a crash (the scan already
+    // stopped there) or failing its CRC ends the recording, and the old index
+    // goes too since close() writes a new one covering old and new blocks
+    index_ = reader.blocks();
+    while (!index_.empty() && !reader.verifyBlock(index_.size() - 1)) {
+        index_.pop_back();
+    }
+    uint64_t end = headerBytes;
+    if (!index_.empty()) {
+        end = index_.back().offset + sizeof(BlockHeader) + index_.back().payloadBytes;
+    }
+
+    std::fflush(file_);
+    if (ftruncate(fileno(file_), static_cast<off_t>(end)) != 0 ||
+        std::fseek(file_, static_cast<long>(end), SEEK_SET) != 0) {
+        return false;
+    }
+    bytesWritten_ = end;
+    return true;
+}
+
+bool RecordingWriter::append(int64_t timestampMs, const double* values, size_t count) {
+    if (!file_ || count != columns_.size()) {
+        return false;
+    }
+
+    const bool first = blockSamples_ == 0;
+    encodeTimestamp(timestampMs);
+    for (size_t i = 0; i < count; ++i) {
+        ColumnState& column = columns_[i];
+        if (column.kind == SeriesKind::Counter || column.kind == SeriesKind::Integer) {
+            encodeCounter(column, values[i]);
+        } else if (column.kind == SeriesKind::Fixed) {
+            encodeFixed(column, values[i]);
+        } else {
+            encodeGauge(column, values[i], first);
+        }
+    }
+
+    blockSamples_++;
+    valuesWritten_ += count;
+
+    if (blockSamples_ >= samplesPerBlock_) {
+        return flush();
+    }
+    return true;
+}
+
+void RecordingWriter::encodeTimestamp(int64_t timestampMs) {
+    if (blockSamples_ == 0) {
+        firstTimestamp_ = timestampMs;
+        prevTimestamp_ = timestampMs;
+        prevDelta_ = 0;
+        return;
+    }
+
+    const int64_t delta = timestampMs - prevTimestamp_;
+    const int64_t dod = delta - prevDelta_;
+    if (dod == 0) {
+        timestamps_.writeBits(0, 1);
+    } else if (dod >= -63 && dod <= 64) {
+        timestamps_.writeBits(0b10, 2);
+        timestamps_.writeBits(static_cast<uint64_t>(dod + 63), 7);
+    } else if (dod >= -255 && dod <= 256) {
+        timestamps_.writeBits(0b110, 3);
+        timestamps_.writeBits(static_cast<uint64_t>(dod + 255), 9);
+    } else if (dod >= -2047 && dod <= 2048) {
+        timestamps_.writeBits(0b1110, 4);
+        timestamps_.writeBits(static_cast<uint64_t>(dod + 2047), 12);
+    } else {
+        timestamps_.writeBits(0b1111, 4);
+        timestamps_.writeBits(static_cast<uint64_t>(dod), 64);
+    }
+    prevTimestamp_ = timestampMs;
+    prevDelta_ = delta;
+}
+
+void RecordingWriter::encodeGauge(ColumnState& column, double value, bool first) {
+    const uint64_t bits = std::bit_cast<uint64_t>(value);
+    if (first) {
+        column.stream.writeBits(bits, 64);
+        column.prevBits = bits;
+        column.prevLeading = -1;
+        return;
+    }
+
+    const uint64_t xorValue = bits ^ column.prevBits;
+    column.prevBits = bits;
+    if (xorValue == 0) {
+        column.stream.writeBits(0, 1);
+        return;
+    }
+
+    const int leading = std::min(std::countl_zero(xorValue), 31);
+    const int trailing = std::countr_zero(xorValue);
+    column.stream.writeBits(1, 1);
+
+    if (column.prevLeading >= 0 && leading >= column.prevLeading && trailing >= column.prevTrailing) {
+        const int significant = 64 - column.prevLeading - column.prevTrailing;
+        column.stream.writeBits(0, 1);
+        column.stream.writeBits(xorValue >> column.prevTrailing, significant);
+        return;
+    }
+
+    const int significant = 64 - leading - trailing;
+    column.stream.writeBits(1, 1);
+    column.stream.writeBits(static_cast<uint64_t>(leading), 5);
+    column.stream.writeBits(static_cast<uint64_t>(significant - 1), 6);
+    column.stream.writeBits(xorValue >> trailing, significant);
+    column.prevLeading = leading;
+    column.prevTrailing = trailing;
+}
+
+void RecordingWriter::encodeCounter(ColumnState& column, double value) {
+    const int64_t current = std::isfinite(value) ? std::llround(value) : 0;
+    const int64_t delta = static_cast<int64_t>(static_cast<uint64_t>(current) -
+                                               static_cast<uint64_t>(column.prevCounter));
+    column.stream.writeVarint(zigzagEncode(delta));
+    column.prevCounter = current;
+}
+
+void RecordingWriter::encodeFixed(ColumnState& column, double value) {
+    // An unchanged value (an idle core, a full battery) is a single bit; a
+    // CPU share moving by up to 20 points fits in 15 bits
+    int64_t delta = kFixedMissing;
+    if (std::isfinite(value)) {
+        const int64_t current = std::llround(std::clamp(value, -kFixedLimit, kFixedLimit) * kFixedScale);
+        delta = current - column.prevCounter;
+        column.prevCounter = current;
+    }
+    if (delta == 0) {
+        column.stream.writeBits(0, 1);
+    } else if (delta >= -127 && delta <= 128) {
+        column.stream.writeBits(0b10, 2);
+        column.stream.writeBits(static_cast<uint64_t>(delta + 127), 8);
+    } else if (delta >= -2047 && delta <= 2048) {
+        column.stream.writeBits(0b110, 3);
+        column.stream.writeBits(static_cast<uint64_t>(delta + 2047), 12);
+    } else if (delta >= -16383 && delta <= 16384) {
+        column.stream.writeBits(0b1110, 4);
+        column.stream.writeBits(static_cast<uint64_t>(delta + 16383), 15);
+    } else {
+        column.stream.writeBits(0b1111, 4);
+        column.stream.writeBits(static_cast<uint64_t>(delta), 64);
+    }
+}
+
+bool RecordingWriter::flush() {
+    if (!file_) {
+        return false;
+    }
+    if (blockSamples_ == 0) {
+        return true;
+    }
+
+    const size_t columnCount = columns_.size() + 1;
+    const size_t tableBytes = (columnCount + 1) * sizeof(uint32_t);
+    payload_.assign(tableBytes, 0);
+
+    auto appendColumn = [&](size_t column, const std::vector<uint8_t>& bytes) {
+        const uint32_t offset = static_cast<uint32_t>(payload_.size());
+        std::memcpy(payload_.data() + column * sizeof(uint32_t), &offset, sizeof(offset));
+        payload_.insert(payload_.end(), bytes.begin(), bytes.end());
+    };
+
+    appendColumn(0, timestamps_.bytes());
+    for (size_t i = 0; i < columns_.size(); ++i) {
+        appendColumn(i + 1, columns_[i].stream.bytes());
+    }
+    const uint32_t end = static_cast<uint32_t>(payload_.size());
+    std::memcpy(payload_.data() + columnCount * sizeof(uint32_t), &end, sizeof(end));
+
+    BlockHeader header{};
+    header.magic = kBlockMagic;
+    header.sampleCount = blockSamples_;
+    header.firstTimestamp = firstTimestamp_;
+    header.lastTimestamp = prevTimestamp_;
+    header.payloadBytes = end;
+    header.crc = recordingCrc32(payload_.data(), payload_.size());
+
+    BlockIndexEntry entry;
+    entry.firstTimestamp = header.firstTimestamp;
+    entry.lastTimestamp = header.lastTimestamp;
+    entry.offset = bytesWritten_;
+    entry.sampleCount = header.sampleCount;
+    entry.payloadBytes = header.payloadBytes;
+
+    resetBlock();
+
+    if (!writeRaw(&header, sizeof(header)) || !writeRaw(payload_.data(), payload_.size())) {
+        return false;
+    }
+    std::fflush(file_);
+    index_.push_back(entry);
+    return true;
+}
+
+void RecordingWriter::close() {
+    if (!file_) {
+        return;
+    }
+
+    flush();
+
+    const uint64_t indexOffset = bytesWritten_;
+    std::vector<IndexRecord> records;
+    records.reserve(index_.size());
+    for (const auto& entry : index_) {
+        records.push_back({entry.firstTimestamp, entry.lastTimestamp, entry.offset,
+                           entry.sampleCount, entry.payloadBytes});
+    }
+
+    IndexTrailer trailer{};
+    trailer.indexOffset = indexOffset;
+    trailer.entryCount = static_cast<uint32_t>(records.size());
+    trailer.crc = recordingCrc32(reinterpret_cast<const uint8_t*>(records.data()),
+                                 records.size() * sizeof(IndexRecord));
+    trailer.magic = kIndexMagic;
+
+    writeRaw(records.data(), records.size() * sizeof(IndexRecord));
+    writeRaw(&trailer, sizeof(trailer));
+
+    std::fclose(file_);
+    file_ = nullptr;
+}
+
+void RecordingWriter::resetBlock() {
+    timestamps_.clear();
+    for (auto& column : columns_) {
+        column.stream.clear();
+        column.prevBits = 0;
+        column.prevCounter = 0;
+        column.prevLeading = -1;
+        column.prevTrailing = 0;
+    }
+    blockSamples_ = 0;
+    prevDelta_ = 0;
+}
+
+bool RecordingWriter::writeRaw(const void* data, size_t size) {
+    if (size == 0) {
+        return true;
+    }
+    if (std::fwrite(data, 1, size, file_) != size) {
+        return false;
+    }
+    bytesWritten_ += size;
+    return true;
+}
+
+bool RecordingReader::open(const uint8_t* data, size_t size) {
+    data_ = data;
+    size_ = size;
+    series_.clear();
+    blocks_.clear();
+    hasIndex_ = false;
+
+    FileHeader header{};
+    if (!readStruct(data_, size_, 0, header) || header.magic != kFileMagic ||
+        header.version == 0 || header.version > kFormatVersion) {
+        return false;
+    }
+
+    size_t offset = sizeof(header);
+    series_.reserve(header.seriesCount);
+    for (uint32_t i = 0; i < header.seriesCount; ++i) {
+        if (size_ - offset < 4) {
+            return false;
+        }
+        SeriesInfo info;
+        if (data_[offset] > static_cast<uint8_t>(SeriesKind::Integer)) {
+            return false;
+        }
+        info.kind = static_cast<SeriesKind>(data_[offset]);
+        // Before version 3 every integer series was stored as a counter,
+        // levels included
+        if (header.version < 3 && info.kind == SeriesKind::Counter) {
+            info.kind = SeriesKind::Integer;
+        }
+        const size_t nameLength = data_[offset + 2] | (static_cast<size_t>(data_[offset + 3]) << 8);
+        offset += 4;
+        if (size_ - offset < nameLength) {
+            return false;
+        }
+        info.name.assign(reinterpret_cast<const char*>(data_ + offset), nameLength);
+        offset += nameLength;
+        series_.push_back(std::move(info));
+    }
+
+    uint32_t crc = 0;
+    if (!readStruct(data_, size_, offset, crc) || crc != recordingCrc32(data_, offset)) {
+        return false;
+    }
+    firstBlockOffset_ = offset + sizeof(crc);
+
+    if (!readIndex()) {
+        scanBlocks();
+    }
+    return true;
+}
+
+int RecordingReader::findSeries(const std::string& name) const {
+    for (size_t i = 0; i < series_.size(); ++i) {
+        if (series_[i].name == name) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+bool RecordingReader::readIndex() {
+    IndexTrailer trailer{};
+    if (size_ < firstBlockOffset_ + sizeof(trailer) ||
+        !readStruct(data_, size_, size_ - sizeof(trailer), trailer) ||
+        trailer.magic != kIndexMagic) {
+        return false;
+    }
+
+    const uint64_t indexBytes = static_cast<uint64_t>(trailer.entryCount) * sizeof(IndexRecord);
+    if (trailer.indexOffset < firstBlockOffset_ ||
+        trailer.indexOffset + indexBytes + sizeof(trailer) != size_) {
+        return false;
+    }
+    if (recordingCrc32(data_ + trailer.indexOffset, indexBytes) != trailer.crc) {
+        return false;
+    }
+
+    blocks_.resize(trailer.entryCount);
+    for (uint32_t i = 0; i < trailer.entryCount; ++i) {
+        IndexRecord record{};
+        readStruct(data_, size_, trailer.indexOffset + i * sizeof(IndexRecord), record);
+        if (record.offset + sizeof(BlockHeader) + record.payloadBytes > trailer.indexOffset) {
+            blocks_.clear();
+            return false;
+        }
+        blocks_[i] = {record.firstTimestamp, record.lastTimestamp, record.offset,
+                      record.sampleCount, record.payloadBytes};
+    }
+    hasIndex_ = true;
+    return true;
+}
+
+void RecordingReader::scanBlocks() {
+    // No trailer (writer did not close cleanly): walk block headers and stop
+    // at the first truncated or corrupt block.
+    size_t offset = firstBlockOffset_;
+    BlockHeader header{};
+    while (readStruct(data_, size_, offset, header) && header.magic == kBlockMagic) {
+        const size_t payloadOffset = offset + sizeof(header);
+        if (size_ - payloadOffset < header.payloadBytes ||
+            recordingCrc32(data_ + payloadOffset, header.payloadBytes) != header.crc) {
+            break;
+        }
+        blocks_.push_back({header.firstTimestamp, header.lastTimestamp, offset,
+                           header.sampleCount, header.payloadBytes});
+        offset = payloadOffset + header.payloadBytes;
+    }
+}
+
+bool RecordingReader::verifyBlock(size_t block) const {
+    if (block >= blocks_.size()) {
+        return false;
+    }
+    BlockHeader header{};
+    const BlockIndexEntry& entry = blocks_[block];
+    if (!readStruct(data_, size_, entry.offset, header) || header.magic != kBlockMagic ||
+        header.payloadBytes != entry.payloadBytes) {
+        return false;
+    }
+    return recordingCrc32(data_ + entry.offset + sizeof(header), header.payloadBytes) == header.crc;
+}
+
+bool RecordingReader::columnRange(size_t block, size_t column, const uint8_t*& begin, size_t& size) const {
+    if (block >= blocks_.size() || column > series_.size()) {
+        return false;
+    }
+    const BlockIndexEntry& entry = blocks_[block];
+    if ((column + 2) * sizeof(uint32_t) > entry.payloadBytes) {
+        return false;
+    }
+    const uint8_t* payload = data_ + entry.offset + sizeof(BlockHeader);
+
+    uint32_t start = 0;
+    uint32_t end = 0;
+    std::memcpy(&start, payload + column * sizeof(uint32_t), sizeof(start));
+    std::memcpy(&end, payload + (column + 1) * sizeof(uint32_t), sizeof(end));
+    if (start > end || end > entry.payloadBytes) {
+        return false;
+    }
+    begin = payload + start;
+    size = end - start;
+    return true;
+}
+
+size_t RecordingReader::columnBytes(size_t block, size_t column) const {
+    const uint8_t* begin = nullptr;
+    size_t size = 0;
+    return columnRange(block, column, begin, size) ? size : 0;
+}
+
+bool RecordingReader::decodeTimestamps(size_t block, std::vector<int64_t>& out) const {
+    const uint8_t* begin = nullptr;
+    size_t size = 0;
+    if (!columnRange(block, 0, begin, size)) {
+        return false;
+    }
+
+    const BlockIndexEntry& entry = blocks_[block];
+    out.resize(entry.sampleCount);
+    if (entry.sampleCount == 0) {
+        return true;
+    }
+
+    BitReader reader(begin, size);
+    int64_t timestamp = entry.firstTimestamp;
+    int64_t delta = 0;
+    out[0] = timestamp;
+    for (uint32_t i = 1; i < entry.sampleCount; ++i) {
+        int64_t dod = 0;
+        if (reader.readBits(1) != 0) {
+            if (reader.readBits(1) == 0) {
+                dod = static_cast<int64_t>(reader.readBits(7)) - 63;
+            } else if (reader.readBits(1) == 0) {
+                dod = static_cast<int64_t>(reader.readBits(9)) - 255;
+            } else if (reader.readBits(1) == 0) {
+                dod = static_cast<int64_t>(reader.readBits(12)) - 2047;
+            } else {
+                dod = static_cast<int64_t>(reader.readBits(64));
+            }
+        }
+        delta += dod;
+        timestamp += delta;
+        out[i] = timestamp;
+    }
+    return !reader.overflowed();
+}
+
+bool RecordingReader::decodeColumn(size_t block, size_t series, std::vector<double>& out) const {
+    const uint8_t* begin = nullptr;
+    size_t size = 0;
+    if (series >= series_.size() || !columnRange(block, series + 1, begin, size)) {
+        return false;
+    }
+
+    const uint32_t count = blocks_[block].sampleCount;
+    out.resize(count);
+    BitReader reader(begin, size);
+
+    if (series_[series].kind == SeriesKind::Counter || series_[series].kind == SeriesKind::Integer) {
+        int64_t value = 0;
+        for (uint32_t i = 0; i < count; ++i) {
+            value = static_cast<int64_t>(static_cast<uint64_t>(value) +
+                                         static_cast<uint64_t>(zigzagDecode(reader.readVarint())));
+            out[i] = static_cast<double>(value);
+        }
+        return !reader.overflowed();
+    }
+
+    if (series_[series].kind == SeriesKind::Fixed) {
+        int64_t value = 0;
+        for (uint32_t i = 0; i < count; ++i) {
+            int64_t delta = 0;
+            if (reader.readBits(1) != 0) {
+                if (reader.readBits(1) == 0) {
+                    delta = static_cast<int64_t>(reader.readBits(8)) - 127;
+                } else if (reader.readBits(1) == 0) {
+                    delta = static_cast<int64_t>(reader.readBits(12)) - 2047;
+                } else if (reader.readBits(1) == 0) {
+                    delta = static_cast<int64_t>(reader.readBits(15)) - 16383;
+                } else {
+                    delta = static_cast<int64_t>(reader.readBits(64));
+                }
+            }
+            if (delta == kFixedMissing) {
+                out[i] = NAN;
+                continue;
+            }
+            value += delta;
+            out[i] = static_cast<double>(value) / kFixedScale;
+        }
+        return !reader.overflowed();
+    }
+
+    if (count == 0) {
+        return true;
+    }
+
+    uint64_t bits = reader.readBits(64);
+    int leading = 0;
+    int trailing = 0;
+    out[0] = std::bit_cast<double>(bits);
+    for (uint32_t i = 1; i < count; ++i) {
+        if (reader.readBits(1) != 0) {
+            if (reader.readBits(1) != 0) {
+                leading = static_cast<int>(reader.readBits(5));
+                const int significant = static_cast<int>(reader.readBits(6)) + 1;
+                trailing = 64 - leading - significant;
+            }
+            const int significant = 64 - leading - trailing;
+            bits ^= reader.readBits(significant) << trailing;
+        }
+        out[i] = std::bit_cast<double>(bits);
+    }
+    return !reader.overflowed();
+}
@@ -0,0 +1,176 @@
+#ifndef OSXVIEW_RECORDINGFORMAT_H
+#define OSXVIEW_RECORDINGFORMAT_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Columnar, append-only recording of metric samples.
+//
+// File layout:
+//   FileHeader, series table, header CRC
+//   Block* (BlockHeader + payload, payload CRC in the header)
+//   Block index + IndexTrailer (written on close; rebuilt by scanning if missing)
+//
+// Every block holds the same columns: column 0 is the timestamp stream
+// (delta-of-delta), followed by one stream per series. Gauges are XOR-float
+// encoded, counters and integer levels are zigzag varint deltas, fixed-point
+// gauges are deltas
+// of the value in hundredths in a few prefix-coded widths. Columns restart
+// their encoder state at each block so any block/column can be decoded on
+// its own.
+
+enum class SeriesKind : uint8_t {
+    Gauge = 0,
+    // A cumulative count that only grows (until a reset), so a rate can be
+    // derived from it
+    Counter = 1,
+    // A gauge kept to 0.01, for percentages: noisy doubles cost most of
+    // their 64 bits under XOR encoding, small integer deltas a byte or two
+    Fixed = 2,
+    // A whole-number gauge (bytes in use, socket counts, per-interval
+    // deltas); stored like a counter but not cumulative
+    Integer = 3
+};
+
+struct SeriesInfo {
+    std::string name;
+    SeriesKind kind = SeriesKind::Gauge;
+};
+
+struct BlockIndexEntry {
+    int64_t firstTimestamp = 0;
+    int64_t lastTimestamp = 0;
+    uint64_t offset = 0;
+    uint32_t sampleCount = 0;
+    uint32_t payloadBytes = 0;
+};
+
+class BitWriter {
+public:
+    void clear() { bytes_.clear(); bitPos_ = 0; }
+    void writeBits(uint64_t value, int count);
+    void writeVarint(uint64_t value);
+    const std::vector<uint8_t>& bytes() const { return bytes_; }
+
+private:
+    std::vector<uint8_t> bytes_;
+    int bitPos_ = 0;
+};
+
+class BitReader {
+public:
+    BitReader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+    uint64_t readBits(int count) {
+        if (count > 0 && count <= available_) {
+            const uint64_t value = window_ >> (64 - count);
+            window_ <<= count;
+            available_ -= count;
+            return value;
+        }
+        return readBitsSlow(count);
+    }
+    uint64_t readVarint();
+    bool overflowed() const { return overflowed_; }
+
+private:
+    void refill();
+    uint64_t readBitsSlow(int count);
+
+    const uint8_t* data_;
+    size_t size_;
+    size_t bytePos_ = 0;
+    uint64_t window_ = 0;
+    int available_ = 0;
+    bool overflowed_ = false;
+};
+
+class RecordingWriter {
+public:
+    explicit RecordingWriter(uint32_t samplesPerBlock = 1200);
+    ~RecordingWriter();
+
+    // Creates the file, or continues an existing recording of the same
+    // series after its last intact block; fails if the series differ
+    bool open(const std::string& path, const std::vector<SeriesInfo>& series);
+    bool append(int64_t timestampMs, const double* values, size_t count);
+    bool flush();
+    void close();
+
+    bool isOpen() const { return file_ != nullptr; }
+    size_t seriesCount() const { return series_.size(); }
+    // File size so far, including the blocks of a continued recording
+    uint64_t bytesWritten() const { return bytesWritten_; }
+    uint64_t valuesWritten() const { return valuesWritten_; }
+
+private:
+    struct ColumnState {
+        SeriesKind kind = SeriesKind::Gauge;
+        BitWriter stream;
+        uint64_t prevBits = 0;
+        int64_t prevCounter = 0;
+        int prevLeading = -1;
+        int prevTrailing = 0;
+    };
+
+    bool resume(size_t headerBytes, size_t fileBytes);
+    void resetBlock();
+    void encodeTimestamp(int64_t timestampMs);
+    static void encodeGauge(ColumnState& column, double value, bool first);
+    static void encodeCounter(ColumnState& column, double value);
+    static void encodeFixed(ColumnState& column, double value);
+    bool writeRaw(const void* data, size_t size);
+
+    uint32_t samplesPerBlock_;
+    std::FILE* file_ = nullptr;
+    std::vector<SeriesInfo> series_;
+    std::vector<ColumnState> columns_;
+    std::vector<BlockIndexEntry> index_;
+    std::vector<uint8_t> payload_;
+
+    BitWriter timestamps_;
+    int64_t firstTimestamp_ = 0;
+    int64_t prevTimestamp_ = 0;
+    int64_t prevDelta_ = 0;
+    uint32_t blockSamples_ = 0;
+
+    uint64_t bytesWritten_ = 0;
+    uint64_t valuesWritten_ = 0;
+};
+
+// Decodes a recording held in memory (a read buffer or an mmap'd file).
+class RecordingReader {
+public:
+    bool open(const uint8_t* data, size_t size);
+
+    const std::vector<SeriesInfo>& series() const { return series_; }
+    const std::vector<BlockIndexEntry>& blocks() const { return blocks_; }
+    bool hasIndex() const { return hasIndex_; }
+    int findSeries(const std::string& name) const;
+
+    bool verifyBlock(size_t block) const;
+    // Encoded bytes of one column (0 is the timestamps, series s is column
+    // s + 1); 0 if the block is unreadable
+    size_t columnBytes(size_t block, size_t column) const;
+    bool decodeTimestamps(size_t block, std::vector<int64_t>& out) const;
+    bool decodeColumn(size_t block, size_t series, std::vector<double>& out) const;
+
+private:
+    bool readIndex();
+    void scanBlocks();
+    bool columnRange(size_t block, size_t column, const uint8_t*& begin, size_t& size) const;
+
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    size_t firstBlockOffset_ = 0;
+    bool hasIndex_ = false;
+    std::vector<SeriesInfo> series_;
+    std::vector<BlockIndexEntry> blocks_;
+};
+
+uint32_t recordingCrc32(const uint8_t* data, size_t size, uint32_t crc = 0);
+
+#endif //OSXVIEW_RECORDINGFORMAT_H
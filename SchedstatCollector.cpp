@@ -0,0 +1,152 @@
+#include "SchedstatCollector.h"
+
+#ifdef __linux__
+
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace {
+
+uint64_t monotonicNs() {
+    timespec now{};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000000000ull + static_cast<uint64_t>(now.tv_nsec);
+}
+
+} // namespace
+
+SchedstatCollector::~SchedstatCollector() {
+    close();
+}
+
+bool SchedstatCollector::open(const char* path) {
+    close();
+    fd_ = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd_ < 0) {
+        return false;
+    }
+    // One "cpuN" line of ten fields plus a few domain lines per CPU
+    buffer_.resize(256 * 1024);
+    return true;
+}
+
+void SchedstatCollector::close() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    previous_.clear();
+    previousNs_ = 0;
+}
+
+// Lines look like "cpu3 y 0 s g w l <run ns> <wait ns> <timeslices>"; the
+// domain lines between them and the header are most of the file and are
+// stepped over with memchr, which libc vectorizes. Only the cpu lines are
+// decoded, one pass over their digits.
+bool SchedstatCollector::read(std::vector<Counters>& counters) {
+    ssize_t length = pread(fd_, buffer_.data(), buffer_.size(), 0);
+    // Large machines: grow until the whole file fits in one read
+    while (length == static_cast<ssize_t>(buffer_.size())) {
+        buffer_.resize(buffer_.size() * 2);
+        length = pread(fd_, buffer_.data(), buffer_.size(), 0);
+    }
+    if (length <= 0) {
+        return false;
+    }
+    counters.clear();
+
+    const char* p = buffer_.data();
+    const char* end = p + length;
+    while (p < end) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+        if (!lineEnd) {
+            lineEnd = end;
+        }
+        if (lineEnd - p > 3 && p[0] == 'c' && p[1] == 'p' && p[2] == 'u') {
+            uint64_t fields[10] = {};
+            int field = 0;
+            for (p += 3; p < lineEnd; ++p) {
+                if (*p >= '0' && *p <= '9') {
+                    uint64_t value = 0;
+                    for (; p < lineEnd && *p >= '0' && *p <= '9'; ++p) {
+                        value = value * 10 + static_cast<uint64_t>(*p - '0');
+                    }
+                    if (field < 10) {
+                        fields[field] = value;
+                    }
+                    ++field;
+                }
+            }
+            // fields[0] is the CPU number
+            if (field >= 10) {
+                counters.push_back({fields[7], fields[8], fields[9]});
+            }
+        }
+        p = lineEnd + 1;
+    }
+    return !counters.empty();
+}
+
+void SchedstatCollector::update(SchedMetrics& out) {
+    out.valid = false;
+    if (fd_ < 0 || !read(current_)) {
+        out.cpus.clear();
+        return;
+    }
+    const uint64_t now = monotonicNs();
+    const bool comparable = !previous_.empty() && previous_.size() == current_.size() && now > previousNs_;
+
+    if (comparable) {
+        const double elapsedNs = static_cast<double>(now - previousNs_);
+        out.cpus.resize(current_.size());
+        double busy = 0.0;
+        double wait = 0.0;
+        uint64_t waitNs = 0;
+        uint64_t timeslices = 0;
+        for (size_t i = 0; i < current_.size(); ++i) {
+            const Counters& a = previous_[i];
+            const Counters& b = current_[i];
+            const uint64_t run = b.runNs >= a.runNs ? b.runNs - a.runNs : 0;
+            const uint64_t waited = b.waitNs >= a.waitNs ? b.waitNs - a.waitNs : 0;
+            const uint64_t slices = b.timeslices >= a.timeslices ? b.timeslices - a.timeslices : 0;
+
+            SchedCpuMetrics& cpu = out.cpus[i];
+            cpu.busyPercent = std::min(100.0, static_cast<double>(run) / elapsedNs * 100.0);
+            cpu.waitPercent = static_cast<double>(waited) / elapsedNs * 100.0;
+            cpu.latencyUs = slices > 0 ? static_cast<double>(waited) / static_cast<double>(slices) / 1000.0 : 0.0;
+            busy += cpu.busyPercent;
+            wait += cpu.waitPercent;
+            waitNs += waited;
+            timeslices += slices;
+        }
+        const double count = static_cast<double>(current_.size());
+        out.busyPercent = busy / count;
+        out.waitPercent = wait / count;
+        out.latencyUs = timeslices > 0 ? static_cast<double>(waitNs) / static_cast<double>(timeslices) / 1000.0 : 0.0;
+        out.valid = true;
+    }
+
+    previous_.swap(current_);
+    previousNs_ = now;
+}
+
+#else
+
+SchedstatCollector::~SchedstatCollector() = default;
+
+bool SchedstatCollector::open(const char* /* path */) {
+    return false;
+}
+
+void SchedstatCollector::close() {
+}
+
+void SchedstatCollector::update(SchedMetrics& out) {
+    out.valid = false;
+    out.cpus.clear();
+}
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef OSXVIEW_SCHEDSTATCOLLECTOR_H
+#define OSXVIEW_SCHEDSTATCOLLECTOR_H
+
+#include <cstdint>
+#include <vector>
+
+struct SchedCpuMetrics {
+    double busyPercent = 0.0;   // time tasks ran on this CPU, ns resolution
+    double waitPercent = 0.0;   // time runnable tasks waited for it; above 100 with several waiting
+    double latencyUs = 0.0;     // mean wait per timeslice
+};
+
+struct SchedMetrics {
+    std::vector<SchedCpuMetrics> cpus;
+    double busyPercent = 0.0;   // averages over all CPUs
+    double waitPercent = 0.0;
+    double latencyUs = 0.0;
+    bool valid = false;
+};
+
+// Per-CPU run and run-queue wait time from Linux /proc/schedstat. The file
+// is kept open; each update is one pread and one pass over the buffer. On
+// other platforms open() fails.
+class SchedstatCollector {
+public:
+    SchedstatCollector() = default;
+    ~SchedstatCollector();
+
+    SchedstatCollector(const SchedstatCollector&) = delete;
+    SchedstatCollector& operator=(const SchedstatCollector&) = delete;
+
+    bool open(const char* path = "/proc/schedstat");
+    void close();
+    bool available() const { return fd_ >= 0; }
+
+    // Rates need two reads; the first update leaves out invalid
+    void update(SchedMetrics& out);
+
+private:
+    struct Counters {
+        uint64_t runNs = 0;
+        uint64_t waitNs = 0;
+        uint64_t timeslices = 0;
+    };
+
+    bool read(std::vector<Counters>& counters);
+
+    int fd_ = -1;
+    std::vector<char> buffer_;
+    std::vector<Counters> previous_;
+    std::vector<Counters> current_;
+    uint64_t previousNs_ = 0;
+};
+
+#endif //OSXVIEW_SCHEDSTATCOLLECTOR_H
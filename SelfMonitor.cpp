@@ -0,0 +1,151 @@
+#include "SelfMonitor.h"
+
+#include <cstring>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#ifdef __APPLE__
+#include <mach/mach.h>
+#endif
+
+namespace {
+
+uint64_t micros(const timeval& time) {
+    return static_cast<uint64_t>(time.tv_sec) * 1000000 + static_cast<uint64_t>(time.tv_usec);
+}
+
+uint64_t parseNumber(const char*& p, const char* end) {
+    uint64_t value = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        value = value * 10 + static_cast<uint64_t>(*p - '0');
+        ++p;
+    }
+    return value;
+}
+
+} // namespace
+
+SelfMonitor::~SelfMonitor() {
+    close();
+}
+
+bool SelfMonitor::open() {
+    close();
+#ifdef __linux__
+    statmFd_ = ::open("/proc/self/statm", O_RDONLY | O_CLOEXEC);
+    // Needs task I/O accounting in the kernel
+    ioFd_ = ::open("/proc/self/io", O_RDONLY | O_CLOEXEC);
+#endif
+    return true;
+}
+
+void SelfMonitor::close() {
+    if (statmFd_ >= 0) {
+        ::close(statmFd_);
+        statmFd_ = -1;
+    }
+    if (ioFd_ >= 0) {
+        ::close(ioFd_);
+        ioFd_ = -1;
+    }
+    primed_ = false;
+}
+
+bool SelfMonitor::readResident(uint64_t& bytes) {
+#if defined(__APPLE__)
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) != KERN_SUCCESS) {
+        return false;
+    }
+    bytes = info.resident_size;
+    return true;
+#else
+    // "size resident shared text lib data dt", in pages
+    char buffer[128];
+    const ssize_t length = statmFd_ >= 0 ? pread(statmFd_, buffer, sizeof(buffer), 0) : -1;
+    if (length <= 0) {
+        return false;
+    }
+    const char* p = buffer;
+    const char* end = buffer + length;
+    parseNumber(p, end);
+    if (p >= end || *p != ' ') {
+        return false;
+    }
+    ++p;
+    bytes = parseNumber(p, end) * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    return true;
+#endif
+}
+
+bool SelfMonitor::readSyscalls(uint64_t& count) {
+#if defined(__APPLE__)
+    task_events_info_data_t info;
+    mach_msg_type_number_t infoCount = TASK_EVENTS_INFO_COUNT;
+    if (task_info(mach_task_self(), TASK_EVENTS_INFO, reinterpret_cast<task_info_t>(&info), &infoCount) != KERN_SUCCESS) {
+        return false;
+    }
+    count = static_cast<uint64_t>(info.syscalls_mach) + static_cast<uint64_t>(info.syscalls_unix);
+    return true;
+#else
+    // Linux counts no syscall total per task; /proc/self/io has the read
+    // and write family ("syscr: N" and "syscw: N"), most of what a sampler makes
+    char buffer[256];
+    const ssize_t length = ioFd_ >= 0 ? pread(ioFd_, buffer, sizeof(buffer), 0) : -1;
+    if (length <= 0) {
+        return false;
+    }
+    count = 0;
+    int found = 0;
+    const char* end = buffer + length;
+    for (const char* p = buffer; p < end;) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+        if (!lineEnd) {
+            lineEnd = end;
+        }
+        if (lineEnd - p > 7 && (std::strncmp(p, "syscr: ", 7) == 0 || std::strncmp(p, "syscw: ", 7) == 0)) {
+            const char* value = p + 7;
+            count += parseNumber(value, lineEnd);
+            ++found;
+        }
+        p = lineEnd + 1;
+    }
+    return found == 2;
+#endif
+}
+
+void SelfMonitor::update(SelfMetrics& out) {
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        out.valid = false;
+        return;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    const uint64_t user = micros(usage.ru_utime);
+    const uint64_t system = micros(usage.ru_stime);
+    const uint64_t switches = static_cast<uint64_t>(usage.ru_nvcsw) + static_cast<uint64_t>(usage.ru_nivcsw);
+    uint64_t syscalls = 0;
+    const bool haveSyscalls = readSyscalls(syscalls);
+    uint64_t resident = 0;
+    out.rssBytes = readResident(resident) ? resident : 0;
+
+    const double elapsedMicros = std::chrono::duration<double, std::micro>(now - previousTime_).count();
+    out.valid = primed_ && elapsedMicros > 0.0;
+    if (out.valid) {
+        out.userPercent = static_cast<double>(user - userMicros_) / elapsedMicros * 100.0;
+        out.systemPercent = static_cast<double>(system - systemMicros_) / elapsedMicros * 100.0;
+        out.cpuPercent = out.userPercent + out.systemPercent;
+        out.contextSwitches = static_cast<double>(switches - contextSwitches_) / elapsedMicros * 1e6;
+    }
+    out.syscallsValid = out.valid && haveSyscalls && syscallsPrimed_;
+    out.syscalls = out.syscallsValid ? static_cast<double>(syscalls - syscalls_) / elapsedMicros * 1e6 : 0.0;
+
+    userMicros_ = user;
+    systemMicros_ = system;
+    contextSwitches_ = switches;
+    syscalls_ = syscalls;
+    syscallsPrimed_ = haveSyscalls;
+    previousTime_ = now;
+    primed_ = true;
+}
@@ -0,0 +1,49 @@
+#ifndef OSXVIEW_SELFMONITOR_H
+#define OSXVIEW_SELFMONITOR_H
+
+#include <chrono>
+#include <cstdint>
+
+struct SelfMetrics {
+    double cpuPercent = 0.0;        // of one core, user + system
+    double userPercent = 0.0;
+    double systemPercent = 0.0;
+    uint64_t rssBytes = 0;
+    double contextSwitches = 0.0;   // per second, voluntary and involuntary
+    double syscalls = 0.0;          // per second; on Linux read and write calls only
+    bool syscallsValid = false;
+    bool valid = false;             // rates need two samples
+};
+
+// OSXview's own cost: CPU time and context switches from getrusage, the
+// resident set and syscall counts from /proc/self (statm, io) on Linux and
+// task_info on macOS. The /proc files stay open and are re-read with pread.
+class SelfMonitor {
+public:
+    SelfMonitor() = default;
+    ~SelfMonitor();
+
+    SelfMonitor(const SelfMonitor&) = delete;
+    SelfMonitor& operator=(const SelfMonitor&) = delete;
+
+    bool open();
+    void close();
+
+    void update(SelfMetrics& out);
+
+private:
+    bool readResident(uint64_t& bytes);
+    bool readSyscalls(uint64_t& count);
+
+    int statmFd_ = -1;
+    int ioFd_ = -1;
+    bool primed_ = false;
+    uint64_t userMicros_ = 0;
+    uint64_t systemMicros_ = 0;
+    uint64_t contextSwitches_ = 0;
+    uint64_t syscalls_ = 0;
+    bool syscallsPrimed_ = false;
+    std::chrono::steady_clock::time_point previousTime_;
+};
+
+#endif //OSXVIEW_SELFMONITOR_H
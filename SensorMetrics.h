@@ -0,0 +1,21 @@
+#ifndef OSXVIEW_SENSORMETRICS_H
+#define OSXVIEW_SENSORMETRICS_H
+
+#include <string>
+
+// Filled from the SMC on macOS and from hwmon on Linux
+struct FanMetrics {
+    double rpm = 0.0;
+    double minRpm = 0.0;
+    double maxRpm = 0.0;
+    bool valid = false;
+};
+
+struct TemperatureMetrics {
+    std::string name;           // "chip/label", e.g. "coretemp/Package id 0"
+    double celsius = 0.0;
+    double maxCelsius = 0.0;    // high or critical trip point, 0 when unknown
+    bool valid = false;
+};
+
+#endif //OSXVIEW_SENSORMETRICS_H
@@ -0,0 +1,236 @@
+#include "Snapshot.h"
+#include "RecordingFormat.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+// Little-endian bit stream as used by deflate
+class DeflateBits {
+public:
+    void write(uint32_t value, int count) {
+        bitBuffer_ |= static_cast<uint64_t>(value) << bitCount_;
+        bitCount_ += count;
+        while (bitCount_ >= 8) {
+            bytes_.push_back(static_cast<uint8_t>(bitBuffer_));
+            bitBuffer_ >>= 8;
+            bitCount_ -= 8;
+        }
+    }
+
+    // Huffman codes are defined MSB first
+    void writeCode(uint32_t code, int length) {
+        uint32_t reversed = 0;
+        for (int i = 0; i < length; ++i) {
+            reversed = (reversed << 1) | ((code >> i) & 1);
+        }
+        write(reversed, length);
+    }
+
+    std::vector<uint8_t>& finish() {
+        if (bitCount_ > 0) {
+            bytes_.push_back(static_cast<uint8_t>(bitBuffer_));
+            bitBuffer_ = 0;
+            bitCount_ = 0;
+        }
+        return bytes_;
+    }
+
+private:
+    std::vector<uint8_t> bytes_;
+    uint64_t bitBuffer_ = 0;
+    int bitCount_ = 0;
+};
+
+const uint16_t kLengthBase[] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+const uint8_t kLengthExtra[] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+const uint16_t kDistanceBase[] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                  257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+                                  8193, 12289, 16385, 24577};
+const uint8_t kDistanceExtra[] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                  7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+void writeLiteralOrLength(DeflateBits& bits, int symbol) {
+    // Fixed Huffman table from RFC 1951 section 3.2.6
+    if (symbol < 144) {
+        bits.writeCode(0x30 + symbol, 8);
+    } else if (symbol < 256) {
+        bits.writeCode(0x190 + (symbol - 144), 9);
+    } else if (symbol < 280) {
+        bits.writeCode(symbol - 256, 7);
+    } else {
+        bits.writeCode(0xC0 + (symbol - 280), 8);
+    }
+}
+
+void writeMatch(DeflateBits& bits, int length, int distance) {
+    int lengthCode = 28;
+    while (kLengthBase[lengthCode] > length) {
+        --lengthCode;
+    }
+    writeLiteralOrLength(bits, 257 + lengthCode);
+    bits.write(length - kLengthBase[lengthCode], kLengthExtra[lengthCode]);
+
+    int distanceCode = 29;
+    while (kDistanceBase[distanceCode] > distance) {
+        --distanceCode;
+    }
+    bits.writeCode(distanceCode, 5);
+    bits.write(distance - kDistanceBase[distanceCode], kDistanceExtra[distanceCode]);
+}
+
+// Single fixed-Huffman deflate block. Meter panels are flat runs of colour,
+// so matching only against the previous pixel and the pixel above (the two
+// distances PNG's Sub/Up filters would exploit) gets most of the gain of a
+// real LZ77 search at a fraction of the cost.
+std::vector<uint8_t> deflateScanlines(const std::vector<uint8_t>& data, int rowBytes) {
+    DeflateBits bits;
+    bits.write(1, 1);   // BFINAL
+    bits.write(1, 2);   // BTYPE = fixed Huffman
+
+    const int candidates[] = {3, rowBytes};
+    const size_t size = data.size();
+    size_t pos = 0;
+    while (pos < size) {
+        int bestLength = 0;
+        int bestDistance = 0;
+        for (int distance : candidates) {
+            if (distance > 32768 || static_cast<size_t>(distance) > pos) {
+                continue;
+            }
+            const size_t limit = std::min<size_t>(258, size - pos);
+            size_t length = 0;
+            while (length < limit && data[pos + length] == data[pos + length - distance]) {
+                ++length;
+            }
+            if (static_cast<int>(length) > bestLength) {
+                bestLength = static_cast<int>(length);
+                bestDistance = distance;
+            }
+        }
+
+        if (bestLength >= 3) {
+            writeMatch(bits, bestLength, bestDistance);
+            pos += static_cast<size_t>(bestLength);
+        } else {
+            writeLiteralOrLength(bits, data[pos]);
+            ++pos;
+        }
+    }
+    writeLiteralOrLength(bits, 256);
+    return std::move(bits.finish());
+}
+
+uint32_t adler32(const uint8_t* data, size_t size) {
+    uint32_t a = 1;
+    uint32_t b = 0;
+    while (size > 0) {
+        const size_t chunk = std::min<size_t>(size, 5552);
+        for (size_t i = 0; i < chunk; ++i) {
+            a += data[i];
+            b += a;
+        }
+        a %= 65521;
+        b %= 65521;
+        data += chunk;
+        size -= chunk;
+    }
+    return (b << 16) | a;
+}
+
+void putBigEndian(std::vector<uint8_t>& out, uint32_t value) {
+    out.push_back(static_cast<uint8_t>(value >> 24));
+    out.push_back(static_cast<uint8_t>(value >> 16));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+void appendChunk(std::vector<uint8_t>& png, const char type[4], const std::vector<uint8_t>& payload) {
+    putBigEndian(png, static_cast<uint32_t>(payload.size()));
+    const size_t typeOffset = png.size();
+    png.insert(png.end(), type, type + 4);
+    png.insert(png.end(), payload.begin(), payload.end());
+    putBigEndian(png, recordingCrc32(png.data() + typeOffset, png.size() - typeOffset));
+}
+
+bool writeFile(const std::string& path, const void* header, size_t headerSize,
+               const uint8_t* rgb, int rowBytes, int height, int pitch) {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    bool ok = std::fwrite(header, 1, headerSize, file) == headerSize;
+    for (int y = 0; ok && y < height; ++y) {
+        ok = std::fwrite(rgb + static_cast<size_t>(y) * pitch, 1, rowBytes, file) == static_cast<size_t>(rowBytes);
+    }
+    return std::fclose(file) == 0 && ok;
+}
+
+bool writePPM(const std::string& path, const uint8_t* rgb, int width, int height, int pitch) {
+    char header[64];
+    const int headerSize = std::snprintf(header, sizeof(header), "P6\n%d %d\n255\n", width, height);
+    return writeFile(path, header, static_cast<size_t>(headerSize), rgb, width * 3, height, pitch);
+}
+
+bool writePNG(const std::string& path, const uint8_t* rgb, int width, int height, int pitch) {
+    const int rowBytes = width * 3;
+
+    // Each scanline is prefixed with filter type 0; the compressor's
+    // previous-pixel and previous-row matches stand in for real filters
+    std::vector<uint8_t> scanlines;
+    scanlines.reserve(static_cast<size_t>(rowBytes + 1) * height);
+    for (int y = 0; y < height; ++y) {
+        const uint8_t* row = rgb + static_cast<size_t>(y) * pitch;
+        scanlines.push_back(0);
+        scanlines.insert(scanlines.end(), row, row + rowBytes);
+    }
+
+    std::vector<uint8_t> idat = {0x78, 0x01};
+    const std::vector<uint8_t> deflated = deflateScanlines(scanlines, rowBytes + 1);
+    idat.insert(idat.end(), deflated.begin(), deflated.end());
+    putBigEndian(idat, adler32(scanlines.data(), scanlines.size()));
+
+    std::vector<uint8_t> ihdr;
+    putBigEndian(ihdr, static_cast<uint32_t>(width));
+    putBigEndian(ihdr, static_cast<uint32_t>(height));
+    ihdr.insert(ihdr.end(), {8, 2, 0, 0, 0});   // 8-bit RGB, deflate, no interlace
+
+    std::vector<uint8_t> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    appendChunk(png, "IHDR", ihdr);
+    appendChunk(png, "IDAT", idat);
+    appendChunk(png, "IEND", {});
+    return writeFile(path, png.data(), png.size(), nullptr, 0, 0, 0);
+}
+
+bool hasSuffix(const std::string& path, const char* suffix) {
+    const size_t length = std::strlen(suffix);
+    if (path.size() < length) {
+        return false;
+    }
+    for (size_t i = 0; i < length; ++i) {
+        char c = path[path.size() - length + i];
+        if (c >= 'A' && c <= 'Z') {
+            c = static_cast<char>(c - 'A' + 'a');
+        }
+        if (c != suffix[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool writeSnapshot(const std::string& path, const uint8_t* rgb, int width, int height, int pitch) {
+    if (!rgb || width <= 0 || height <= 0 || pitch < width * 3) {
+        return false;
+    }
+    if (hasSuffix(path, ".ppm")) {
+        return writePPM(path, rgb, width, height, pitch);
+    }
+    return writePNG(path, rgb, width, height, pitch);
+}
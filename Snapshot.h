@@ -0,0 +1,11 @@
+#ifndef OSXVIEW_SNAPSHOT_H
+#define OSXVIEW_SNAPSHOT_H
+
+#include <cstdint>
+#include <string>
+
+// Writes a packed RGB24 image (pitch bytes per row) to disk. Paths ending in
+// ".ppm" are written as binary PPM, everything else as PNG.
+bool writeSnapshot(const std::string& path, const uint8_t* rgb, int width, int height, int pitch);
+
+#endif //OSXVIEW_SNAPSHOT_H
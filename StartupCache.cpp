@@ -0,0 +1,71 @@
+#include "StartupCache.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+// mkdir -p, for ~/.cache itself possibly missing
+bool makeDirectories(const std::string& path) {
+    for (size_t slash = path.find('/', 1); ; slash = path.find('/', slash + 1)) {
+        const std::string prefix = path.substr(0, slash);
+        if (mkdir(prefix.c_str(), 0755) != 0 && errno != EEXIST) {
+            return false;
+        }
+        if (slash == std::string::npos) {
+            return true;
+        }
+    }
+}
+
+} // namespace
+
+std::string startupCacheDirectory() {
+    const char* home = std::getenv("HOME");
+#ifdef __APPLE__
+    return home && *home ? std::string(home) + "/Library/Caches/OSXview" : std::string();
+#else
+    const char* xdg = std::getenv("XDG_CACHE_HOME");
+    if (xdg && *xdg == '/') {
+        return std::string(xdg) + "/osxview";
+    }
+    return home && *home ? std::string(home) + "/.cache/osxview" : std::string();
+#endif
+}
+
+bool readCacheFile(const std::string& path, std::string& contents) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+    contents.clear();
+    char buffer[16384];
+    size_t length = 0;
+    while ((length = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        contents.append(buffer, length);
+    }
+    const bool ok = !std::ferror(file);
+    std::fclose(file);
+    return ok;
+}
+
+bool writeCacheFile(const std::string& path, std::string_view contents) {
+    const size_t slash = path.rfind('/');
+    if (slash != std::string::npos && slash > 0 && !makeDirectories(path.substr(0, slash))) {
+        return false;
+    }
+    const std::string temporary = path + "." + std::to_string(getpid());
+    std::FILE* file = std::fopen(temporary.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    const bool written = std::fwrite(contents.data(), 1, contents.size(), file) == contents.size();
+    if (std::fclose(file) != 0 || !written || std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,21 @@
+#ifndef OSXVIEW_STARTUPCACHE_H
+#define OSXVIEW_STARTUPCACHE_H
+
+#include <string>
+#include <string_view>
+
+// Small files that make the next start faster: the font path that was
+// found and the rasterized glyph pages. They live in the per-user cache
+// directory and can be deleted at any time; whoever reads one validates it
+// and falls back to the slow path.
+
+// ~/Library/Caches/OSXview on macOS, $XDG_CACHE_HOME/osxview or
+// ~/.cache/osxview elsewhere; empty without a home directory
+std::string startupCacheDirectory();
+
+bool readCacheFile(const std::string& path, std::string& contents);
+// Creates the directory, then writes a temporary file and renames it over
+// the old one, so a concurrent start never reads half a file
+bool writeCacheFile(const std::string& path, std::string_view contents);
+
+#endif //OSXVIEW_STARTUPCACHE_H
@@ -0,0 +1,88 @@
+#include "StripChart.h"
+#include <algorithm>
+
+namespace {
+
+constexpr uint32_t kBlack = 0xFF000000u;
+
+uint32_t packColor(const SDL_Color& color) {
+    return (static_cast<uint32_t>(color.a) << 24) | (static_cast<uint32_t>(color.r) << 16) |
+           (static_cast<uint32_t>(color.g) << 8) | color.b;
+}
+
+} // namespace
+
+StripChart::~StripChart() {
+    release();
+}
+
+void StripChart::release() {
+    if (texture_) {
+        SDL_DestroyTexture(texture_);
+        texture_ = nullptr;
+    }
+    width_ = 0;
+    height_ = 0;
+    head_ = 0;
+    samples_ = 0;
+}
+
+bool StripChart::resize(SDL_Renderer* renderer, int width, int height) {
+    release();
+    if (!renderer || width <= 0 || height <= 0) {
+        return false;
+    }
+
+    texture_ = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING,
+                                 width, height);
+    if (!texture_) {
+        return false;
+    }
+    width_ = width;
+    height_ = height;
+    column_.assign(static_cast<size_t>(height_), kBlack);
+
+    // Only time the whole ring is written
+    std::vector<uint32_t> blank(static_cast<size_t>(width_) * height_, kBlack);
+    SDL_UpdateTexture(texture_, nullptr, blank.data(), width_ * static_cast<int>(sizeof(uint32_t)));
+    return true;
+}
+
+void StripChart::push(const std::vector<double>& values, const std::vector<SDL_Color>& colors) {
+    if (!texture_) {
+        return;
+    }
+
+    // Row 0 is the top of the texture, so segments fill upwards from the end
+    int filled = 0;
+    const size_t segments = std::min(values.size(), colors.size());
+    for (size_t i = 0; i < segments && filled < height_; ++i) {
+        const double fraction = std::clamp(values[i], 0.0, 100.0) / 100.0;
+        const int rows = std::min(height_ - filled, static_cast<int>(fraction * height_ + 0.5));
+        std::fill_n(column_.begin() + (height_ - filled - rows), rows, packColor(colors[i]));
+        filled += rows;
+    }
+    std::fill_n(column_.begin(), height_ - filled, kBlack);
+
+    const SDL_Rect rect{head_, 0, 1, height_};
+    SDL_UpdateTexture(texture_, &rect, column_.data(), static_cast<int>(sizeof(uint32_t)));
+    head_ = (head_ + 1) % width_;
+    samples_++;
+}
+
+void StripChart::draw(SDL_Renderer* renderer, int x, int y) const {
+    if (!texture_) {
+        return;
+    }
+
+    // Columns [head_, width_) are the oldest and go on the left
+    const int olderWidth = width_ - head_;
+    const SDL_Rect olderSource{head_, 0, olderWidth, height_};
+    const SDL_Rect olderDest{x, y, olderWidth, height_};
+    SDL_RenderCopy(renderer, texture_, &olderSource, &olderDest);
+    if (head_ > 0) {
+        const SDL_Rect newerSource{0, 0, head_, height_};
+        const SDL_Rect newerDest{x + olderWidth, y, head_, height_};
+        SDL_RenderCopy(renderer, texture_, &newerSource, &newerDest);
+    }
+}
@@ -0,0 +1,44 @@
+#ifndef OSXVIEW_STRIPCHART_H
+#define OSXVIEW_STRIPCHART_H
+
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <vector>
+
+// Scrolling history graph backed by a ring of texture columns. push() uploads
+// a single column of stacked segments at the write head and advances it;
+// draw() shows the ring oldest-to-newest with two copies split at the head.
+// Per-sample cost depends only on the chart height, never on its width or
+// on how much history it holds, and old samples are never re-plotted.
+class StripChart {
+public:
+    StripChart() = default;
+    ~StripChart();
+
+    StripChart(const StripChart&) = delete;
+    StripChart& operator=(const StripChart&) = delete;
+
+    // (Re)creates the ring for a new size; history is cleared
+    bool resize(SDL_Renderer* renderer, int width, int height);
+    void release();
+
+    bool isReady() const { return texture_ != nullptr; }
+    int width() const { return width_; }
+    int height() const { return height_; }
+    uint64_t samples() const { return samples_; }
+
+    // Values are percentages stacked bottom-up; the rest of the column is
+    // left black like the meters' idle segment
+    void push(const std::vector<double>& values, const std::vector<SDL_Color>& colors);
+    void draw(SDL_Renderer* renderer, int x, int y) const;
+
+private:
+    SDL_Texture* texture_ = nullptr;
+    int width_ = 0;
+    int height_ = 0;
+    int head_ = 0;
+    uint64_t samples_ = 0;
+    std::vector<uint32_t> column_;
+};
+
+#endif //OSXVIEW_STRIPCHART_H
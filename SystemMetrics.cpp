@@ -1,4 +1,6 @@
 #include "SystemMetrics.h"
+#include "Trace.h"
+#ifdef __APPLE__
 #include <IOKit/network/IOEthernetInterface.h>
 #include <IOKit/storage/IOBlockStorageDevice.h>
 #include <IOKit/storage/IOBlockStorageDriver.h>
@@ -14,9 +16,13 @@
 #include <net/if_types.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#endif
 #include <cstring>
 #include <cstdio>
 #include <algorithm>
+#include <bit>
+
+#ifdef __APPLE__
 
 namespace {
 
@@ -283,6 +289,153 @@ bool smcReadFloat(io_connect_t connection, const char* keyString, double& outVal
     return true;
 }
 
+// Utilization from an accelerator's PerformanceStatistics; false when it
+// has none of the keys
+bool readGPUStatistics(io_object_t object, GPUMetrics& out) {
+    CFDictionaryRef perfStats = (CFDictionaryRef)IORegistryEntryCreateCFProperty(
+        object, CFSTR("PerformanceStatistics"), kCFAllocatorDefault, 0);
+    if (!perfStats) {
+        return false;
+    }
+    const CFStringRef deviceKeys[] = {
+        CFSTR("Device Utilization %"),
+        CFSTR("device_utilization"),
+        CFSTR("Device Utilization")
+    };
+    const CFStringRef rendererKeys[] = {
+        CFSTR("Renderer Utilization %"),
+        CFSTR("renderer_utilization"),
+        CFSTR("Renderer Utilization")
+    };
+    const CFStringRef tilerKeys[] = {
+        CFSTR("Tiler Utilization %"),
+        CFSTR("tiler_utilization"),
+        CFSTR("Tiler Utilization")
+    };
+
+    double value = 0.0;
+    bool anyValue = false;
+    if (tryGetDictionaryDouble(perfStats, deviceKeys, arraySize(deviceKeys), value)) {
+        out.deviceUtilization = value;
+        anyValue = true;
+    }
+    if (tryGetDictionaryDouble(perfStats, rendererKeys, arraySize(rendererKeys), value)) {
+        out.rendererUtilization = value;
+        anyValue = true;
+    }
+    if (tryGetDictionaryDouble(perfStats, tilerKeys, arraySize(tilerKeys), value)) {
+        out.tilerUtilization = value;
+        anyValue = true;
+    }
+    CFRelease(perfStats);
+    return anyValue;
+}
+
+// The first service of a class that reports utilization, retained
+io_object_t findGPUService(const char* className) {
+    CFMutableDictionaryRef matching = IOServiceMatching(className);
+    if (!matching) {
+        return IO_OBJECT_NULL;
+    }
+    io_iterator_t iterator = IO_OBJECT_NULL;
+    if (IOServiceGetMatchingServices(getIOKitMasterPort(), matching, &iterator) != KERN_SUCCESS) {
+        return IO_OBJECT_NULL;
+    }
+    io_object_t found = IO_OBJECT_NULL;
+    io_object_t object = IO_OBJECT_NULL;
+    while (found == IO_OBJECT_NULL && (object = IOIteratorNext(iterator)) != IO_OBJECT_NULL) {
+        GPUMetrics probe;
+        if (readGPUStatistics(object, probe)) {
+            found = object;
+        } else {
+            IOObjectRelease(object);
+        }
+    }
+    IOObjectRelease(iterator);
+    return found;
+}
+
+struct DiskCounters {
+    uint64_t readBytes = 0;
+    uint64_t writeBytes = 0;
+    uint64_t readOps = 0;
+    uint64_t writeOps = 0;
+};
+
+// Totals over every block storage driver in the registry
+bool readDiskCounters(DiskCounters& out) {
+    CFMutableDictionaryRef matching = IOServiceMatching("IOBlockStorageDriver");
+    if (!matching) {
+        return false;
+    }
+
+    io_iterator_t iterator = IO_OBJECT_NULL;
+    kern_return_t kr = IOServiceGetMatchingServices(getIOKitMasterPort(), matching, &iterator);
+    if (kr != KERN_SUCCESS) {
+        return false;
+    }
+
+    out = DiskCounters{};
+    io_object_t object = IO_OBJECT_NULL;
+    while ((object = IOIteratorNext(iterator)) != IO_OBJECT_NULL) {
+        CFDictionaryRef stats = (CFDictionaryRef)IORegistryEntryCreateCFProperty(
+            object, CFSTR(kIOBlockStorageDriverStatisticsKey), kCFAllocatorDefault, 0);
+        if (!stats) {
+            stats = (CFDictionaryRef)IORegistryEntryCreateCFProperty(
+                object, CFSTR("IOBlockStorageDriverStatistics"), kCFAllocatorDefault, 0);
+        }
+        if (!stats) {
+            stats = (CFDictionaryRef)IORegistryEntryCreateCFProperty(
+                object, CFSTR("Statistics"), kCFAllocatorDefault, 0);
+        }
+
+        if (stats) {
+            const CFStringRef readByteKeys[] = {
+                CFSTR("Bytes (Read)"),
+                CFSTR("Bytes Read"),
+                CFSTR("BytesRead")
+            };
+            const CFStringRef writeByteKeys[] = {
+                CFSTR("Bytes (Write)"),
+                CFSTR("Bytes Written"),
+                CFSTR("BytesWritten")
+            };
+            const CFStringRef readOpKeys[] = {
+                CFSTR("Operations (Read)"),
+                CFSTR("Read Operations"),
+                CFSTR("Reads")
+            };
+            const CFStringRef writeOpKeys[] = {
+                CFSTR("Operations (Write)"),
+                CFSTR("Write Operations"),
+                CFSTR("Writes")
+            };
+
+            uint64_t value = 0;
+
+            if (tryGetDictionaryValue(stats, readByteKeys, arraySize(readByteKeys), value)) {
+                out.readBytes += value;
+            }
+            if (tryGetDictionaryValue(stats, writeByteKeys, arraySize(writeByteKeys), value)) {
+                out.writeBytes += value;
+            }
+            if (tryGetDictionaryValue(stats, readOpKeys, arraySize(readOpKeys), value)) {
+                out.readOps += value;
+            }
+            if (tryGetDictionaryValue(stats, writeOpKeys, arraySize(writeOpKeys), value)) {
+                out.writeOps += value;
+            }
+
+            CFRelease(stats);
+        }
+
+        IOObjectRelease(object);
+    }
+
+    IOObjectRelease(iterator);
+    return true;
+}
+
 } // namespace
 
 SystemMetrics::SystemMetrics() 
@@ -295,10 +448,14 @@ SystemMetrics::SystemMetrics()
       lastNetworkSample_(),
       lastSystemInfoSample_(),
       lastGpuSample_(),
-      networkIter_(0), diskIter_(0), smcConnection_(IO_OBJECT_NULL) {
+      networkIter_(0), diskIter_(0), smcConnection_(IO_OBJECT_NULL), gpuService_(IO_OBJECT_NULL) {
 }
 
 SystemMetrics::~SystemMetrics() {
+    // The opener may still be using the connections released below
+    if (opener_.joinable()) {
+        opener_.join();
+    }
     if (prevCpuLoad_) {
         vm_deallocate(mach_host_self(), (vm_address_t)prevCpuLoad_, 
                       numCpus_ * sizeof(processor_cpu_load_info_data_t));
@@ -314,6 +471,9 @@ SystemMetrics::~SystemMetrics() {
         IOServiceClose(smcConnection_);
         smcConnection_ = IO_OBJECT_NULL;
     }
+    if (gpuService_ != IO_OBJECT_NULL) {
+        IOObjectRelease(gpuService_);
+    }
 }
 
 bool SystemMetrics::initialize() {
@@ -329,7 +489,16 @@ bool SystemMetrics::initialize() {
     
     // Initialize system info
     updateSystemInfo();
+    
+    // Resolve the registry port here rather than racing for it on the opener
+    getIOKitMasterPort();
+
+    return true;
+}
 
+void SystemMetrics::openSMC() {
+    // Opened on first use so configurations without fan meters never touch the SMC
+    smcOpenAttempted_ = true;
     io_service_t smcService = IOServiceGetMatchingService(getIOKitMasterPort(), IOServiceMatching("AppleSMC"));
     if (smcService == IO_OBJECT_NULL) {
         smcService = IOServiceGetMatchingService(getIOKitMasterPort(), IOServiceMatching("AppleSMCKeysEndpoint"));
@@ -341,23 +510,181 @@ bool SystemMetrics::initialize() {
             smcConnection_ = IO_OBJECT_NULL;
         }
     }
+}
+
+void SystemMetrics::openGPU() {
+    // The accelerator is looked up once; samples only read its statistics
+    if (gpuOpenAttempted_) {
+        return;
+    }
+    gpuOpenAttempted_ = true;
+    gpuService_ = findGPUService("IOAccelerator");
+    if (gpuService_ == IO_OBJECT_NULL) {
+        gpuService_ = findGPUService("AGXAccelerator");
+    }
+}
+
+void SystemMetrics::openDisk() {
+    // The first registry walk, cold and the slowest, only sets the baseline
+    // the rates are taken against
+    if (diskOpenAttempted_) {
+        return;
+    }
+    diskOpenAttempted_ = true;
+    DiskCounters counters;
+    if (!readDiskCounters(counters)) {
+        return;
+    }
+    prevDiskRead_ = counters.readBytes;
+    prevDiskWrite_ = counters.writeBytes;
+    prevDiskReadOps_ = counters.readOps;
+    prevDiskWriteOps_ = counters.writeOps;
+    lastDiskSample_ = std::chrono::steady_clock::now();
+    diskStatsInitialized_ = true;
+}
+#else
+
+SystemMetrics::SystemMetrics()
+    : memoryMetrics_(), swapMetrics_(), networkMetrics_(), diskMetrics_(), systemInfo_() {
+}
+
+SystemMetrics::~SystemMetrics() {
+    if (opener_.joinable()) {
+        opener_.join();
+    }
+}
 
+bool SystemMetrics::initialize() {
+    // The mach/IOKit meters stay empty; the Linux collectors below still work
+    systemInfo_.cpuCount = static_cast<int>(sysconf(_SC_NPROCESSORS_ONLN));
     return true;
 }
 
+void SystemMetrics::openSMC() {
+    smcOpenAttempted_ = true;
+}
+
+void SystemMetrics::openGPU() {
+    gpuOpenAttempted_ = true;
+}
+
+void SystemMetrics::openDisk() {
+    diskOpenAttempted_ = true;
+}
+
+#endif
+
+void SystemMetrics::openInBackground(uint32_t subsystems) {
+    if (opener_.joinable()) {
+        opener_.join();
+    }
+    // Only opens that walk a registry or a tree, or talk to the kernel or
+    // the SMC, are worth a thread; the rest open inline on first update
+    struct SlowOpen {
+        uint32_t subsystems;
+        bool SystemMetrics::*attempted;
+        void (SystemMetrics::*open)();
+    };
+    static const SlowOpen kSlowOpens[] = {
+        {SUBSYSTEM_FANS | SUBSYSTEM_TEMPERATURE, &SystemMetrics::hwmonOpenAttempted_, &SystemMetrics::openSensors},
+        {SUBSYSTEM_GPU, &SystemMetrics::gpuOpenAttempted_, &SystemMetrics::openGPU},
+        {SUBSYSTEM_DISK, &SystemMetrics::diskOpenAttempted_, &SystemMetrics::openDisk},
+        {SUBSYSTEM_CGROUPS, &SystemMetrics::cgroupOpenAttempted_, &SystemMetrics::openCgroups},
+        {SUBSYSTEM_TCP, &SystemMetrics::tcpOpenAttempted_, &SystemMetrics::openTcp},
+        {SUBSYSTEM_NUMA, &SystemMetrics::numaOpenAttempted_, &SystemMetrics::openNuma},
+        {SUBSYSTEM_CPU_FREQ, &SystemMetrics::cpuFreqOpenAttempted_, &SystemMetrics::openCpuFreq},
+        {SUBSYSTEM_PERF, &SystemMetrics::perfOpenAttempted_, &SystemMetrics::openPerf},
+    };
+    std::vector<const SlowOpen*> opens;
+    uint32_t pending = 0;
+    for (const SlowOpen& open : kSlowOpens) {
+        if ((subsystems & open.subsystems) && !(this->*open.attempted)) {
+            opens.push_back(&open);
+            pending |= open.subsystems;
+        }
+    }
+    if (opens.empty()) {
+        return;
+    }
+    // update() leaves a pending subsystem alone, so the opener has its
+    // collector and open flag to itself until it clears the bits
+    opening_.store(pending, std::memory_order_release);
+    opener_ = std::thread([this, opens = std::move(opens)] {
+        for (const SlowOpen* open : opens) {
+            TRACE_SCOPE("metrics.open");
+            (this->*open->open)();
+            opening_.fetch_and(~open->subsystems, std::memory_order_release);
+        }
+    });
+}
+
 void SystemMetrics::update() {
-    updateCPU();
-    updateMemory();
-    updateSwap();
-    updateGPU();
-    updateNetwork();
-    updateDisk();
-    updateSystemInfo();
-    updateBattery();
-    updateFans();
+    TRACE_SCOPE("metrics.update");
+    timedUpdate(SUBSYSTEM_CPU, &SystemMetrics::updateCPU);
+    timedUpdate(SUBSYSTEM_SCHED, &SystemMetrics::updateSched);
+    timedUpdate(SUBSYSTEM_CPU_FREQ, &SystemMetrics::updateCpuFreq);
+    timedUpdate(SUBSYSTEM_PERF, &SystemMetrics::updatePerf);
+    timedUpdate(SUBSYSTEM_MEMORY, &SystemMetrics::updateMemory);
+    timedUpdate(SUBSYSTEM_SWAP, &SystemMetrics::updateSwap);
+    timedUpdate(SUBSYSTEM_GPU, &SystemMetrics::updateGPU);
+    timedUpdate(SUBSYSTEM_NETWORK, &SystemMetrics::updateNetwork);
+    timedUpdate(SUBSYSTEM_DISK, &SystemMetrics::updateDisk);
+    timedUpdate(SUBSYSTEM_SYSTEM_INFO, &SystemMetrics::updateSystemInfo);
+    timedUpdate(SUBSYSTEM_BATTERY, &SystemMetrics::updateBattery);
+    timedUpdate(SUBSYSTEM_FANS, &SystemMetrics::updateFans);
+    timedUpdate(SUBSYSTEM_TEMPERATURE, &SystemMetrics::updateTemperatures);
+    timedUpdate(SUBSYSTEM_CGROUPS, &SystemMetrics::updateCgroups);
+    timedUpdate(SUBSYSTEM_TCP, &SystemMetrics::updateTcp);
+    timedUpdate(SUBSYSTEM_NUMA, &SystemMetrics::updateNuma);
+    // Last, so the sample's own collection cost is included
+    timedUpdate(SUBSYSTEM_SELF, &SystemMetrics::updateSelf);
+    sampleCount_++;
 }
 
+void SystemMetrics::timedUpdate(uint32_t subsystem, void (SystemMetrics::*update)()) {
+    if (!(subsystems_ & subsystem) || (opening_.load(std::memory_order_acquire) & subsystem)) {
+        return;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    (this->*update)();
+    const double micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    // The first update also opens the collector, so the second one
+    // replaces its cost instead of being averaged with it
+    const int index = std::countr_zero(subsystem);
+    double& cost = updateCost_[index];
+    cost = updateRuns_[index] < 2 ? micros : cost + (micros - cost) * 0.2;
+    ++updateRuns_[index];
+}
+
+double SystemMetrics::updateCostMicros(uint32_t subsystem) const {
+    const int index = std::countr_zero(subsystem);
+    return index < SUBSYSTEM_COUNT ? updateCost_[index] : 0.0;
+}
+
+void SystemMetrics::setSnapshot(const MetricsSnapshot& snapshot) {
+    cpuMetrics_ = snapshot.cpu;
+    memoryMetrics_ = snapshot.memory;
+    swapMetrics_ = snapshot.swap;
+    gpuMetrics_ = snapshot.gpu;
+    networkMetrics_ = snapshot.network;
+    diskMetrics_ = snapshot.disk;
+    systemInfo_ = snapshot.systemInfo;
+    batteryMetrics_ = snapshot.battery;
+    fanMetrics_ = snapshot.fans;
+    cgroupMetrics_ = snapshot.cgroups;
+    schedMetrics_ = snapshot.sched;
+    tcpMetrics_ = snapshot.tcp;
+    numaMetrics_ = snapshot.numa;
+    cpuFreqMetrics_ = snapshot.cpuFreq;
+    temperatureMetrics_ = snapshot.temperatures;
+    perfMetrics_ = snapshot.perf;
+    selfMetrics_ = snapshot.self;
+    sampleCount_++;
+}
+
+#ifdef __APPLE__
 void SystemMetrics::updateCPU() {
+    TRACE_SCOPE("update.cpu");
     processor_cpu_load_info_t cpuLoad;
     unsigned int numCpus;
     kern_return_t kr = host_processor_info(machPort_, PROCESSOR_CPU_LOAD_INFO,
@@ -415,6 +742,7 @@ void SystemMetrics::updateCPU() {
 }
 
 void SystemMetrics::updateMemory() {
+    TRACE_SCOPE("update.memory");
     vm_size_t pageSize;
     host_page_size(machPort_, &pageSize);
     
@@ -441,6 +769,7 @@ void SystemMetrics::updateMemory() {
 }
 
 void SystemMetrics::updateSwap() {
+    TRACE_SCOPE("update.swap");
     xsw_usage swapUsage;
     size_t size = sizeof(swapUsage);
     sysctlbyname("vm.swapusage", &swapUsage, &size, nullptr, 0);
@@ -454,6 +783,7 @@ void SystemMetrics::updateSwap() {
 }
 
 void SystemMetrics::updateGPU() {
+    TRACE_SCOPE("update.gpu");
     auto now = std::chrono::steady_clock::now();
     if (lastGpuSample_.time_since_epoch().count() != 0 &&
         now - lastGpuSample_ < kGPUUpdateInterval) {
@@ -462,84 +792,22 @@ void SystemMetrics::updateGPU() {
     lastGpuSample_ = now;
 
     gpuMetrics_ = GPUMetrics{};
-
-    auto fetchStatsForClass = [&](const char* className) -> bool {
-        if (!className) {
-            return false;
-        }
-        CFMutableDictionaryRef matching = IOServiceMatching(className);
-        if (!matching) {
-            return false;
-        }
-
-        io_iterator_t iterator = IO_OBJECT_NULL;
-        kern_return_t kr = IOServiceGetMatchingServices(getIOKitMasterPort(), matching, &iterator);
-        if (kr != KERN_SUCCESS) {
-            return false;
-        }
-
-        io_object_t object = IO_OBJECT_NULL;
-        bool found = false;
-        while ((object = IOIteratorNext(iterator)) != IO_OBJECT_NULL) {
-            CFDictionaryRef perfStats = (CFDictionaryRef)IORegistryEntryCreateCFProperty(
-                object, CFSTR("PerformanceStatistics"), kCFAllocatorDefault, 0);
-            if (perfStats) {
-                const CFStringRef deviceKeys[] = {
-                    CFSTR("Device Utilization %"),
-                    CFSTR("device_utilization"),
-                    CFSTR("Device Utilization")
-                };
-                const CFStringRef rendererKeys[] = {
-                    CFSTR("Renderer Utilization %"),
-                    CFSTR("renderer_utilization"),
-                    CFSTR("Renderer Utilization")
-                };
-                const CFStringRef tilerKeys[] = {
-                    CFSTR("Tiler Utilization %"),
-                    CFSTR("tiler_utilization"),
-                    CFSTR("Tiler Utilization")
-                };
-
-                double value = 0.0;
-                bool anyValue = false;
-                if (tryGetDictionaryDouble(perfStats, deviceKeys, arraySize(deviceKeys), value)) {
-                    gpuMetrics_.deviceUtilization = value;
-                    anyValue = true;
-                }
-                if (tryGetDictionaryDouble(perfStats, rendererKeys, arraySize(rendererKeys), value)) {
-                    gpuMetrics_.rendererUtilization = value;
-                    anyValue = true;
-                }
-                if (tryGetDictionaryDouble(perfStats, tilerKeys, arraySize(tilerKeys), value)) {
-                    gpuMetrics_.tilerUtilization = value;
-                    anyValue = true;
-                }
-
-                if (anyValue) {
-                    gpuMetrics_.valid = true;
-                    found = true;
-                }
-                CFRelease(perfStats);
-            }
-
-            IOObjectRelease(object);
-
-            if (found) {
-                break;
-            }
-        }
-
-        IOObjectRelease(iterator);
-        return found;
-    };
-
-    if (!fetchStatsForClass("IOAccelerator") &&
-        !fetchStatsForClass("AGXAccelerator")) {
-        gpuMetrics_.valid = false;
+    openGPU();
+    if (gpuService_ == IO_OBJECT_NULL) {
+        return;
+    }
+    if (readGPUStatistics(gpuService_, gpuMetrics_)) {
+        gpuMetrics_.valid = true;
+        return;
     }
+    // The driver went away or was replaced; look it up again next time
+    IOObjectRelease(gpuService_);
+    gpuService_ = IO_OBJECT_NULL;
+    gpuOpenAttempted_ = false;
 }
 
 void SystemMetrics::updateNetwork() {
+    TRACE_SCOPE("update.network");
     auto now = std::chrono::steady_clock::now();
     if (lastNetworkSample_.time_since_epoch().count() != 0 &&
         now - lastNetworkSample_ < kNetworkUpdateInterval) {
@@ -595,6 +863,8 @@ void SystemMetrics::updateNetwork() {
 }
 
 void SystemMetrics::updateDisk() {
+    TRACE_SCOPE("update.disk");
+    openDisk();
     auto now = std::chrono::steady_clock::now();
     if (diskStatsInitialized_ && now - lastDiskSample_ < kDiskUpdateInterval) {
         return;
@@ -608,85 +878,16 @@ void SystemMetrics::updateDisk() {
 
     lastDiskSample_ = now;
 
-    CFMutableDictionaryRef matching = IOServiceMatching("IOBlockStorageDriver");
-    if (!matching) {
-        return;
-    }
-
-    io_iterator_t iterator = IO_OBJECT_NULL;
-    kern_return_t kr = IOServiceGetMatchingServices(getIOKitMasterPort(), matching, &iterator);
-    if (kr != KERN_SUCCESS) {
+    DiskCounters counters;
+    if (!readDiskCounters(counters)) {
         return;
     }
 
-    uint64_t totalRead = 0;
-    uint64_t totalWrite = 0;
-    uint64_t totalReadOps = 0;
-    uint64_t totalWriteOps = 0;
-
-    io_object_t object = IO_OBJECT_NULL;
-    while ((object = IOIteratorNext(iterator)) != IO_OBJECT_NULL) {
-        CFDictionaryRef stats = (CFDictionaryRef)IORegistryEntryCreateCFProperty(
-            object, CFSTR(kIOBlockStorageDriverStatisticsKey), kCFAllocatorDefault, 0);
-        if (!stats) {
-            stats = (CFDictionaryRef)IORegistryEntryCreateCFProperty(
-                object, CFSTR("IOBlockStorageDriverStatistics"), kCFAllocatorDefault, 0);
-        }
-        if (!stats) {
-            stats = (CFDictionaryRef)IORegistryEntryCreateCFProperty(
-                object, CFSTR("Statistics"), kCFAllocatorDefault, 0);
-        }
-
-        if (stats) {
-            const CFStringRef readByteKeys[] = {
-                CFSTR("Bytes (Read)"),
-                CFSTR("Bytes Read"),
-                CFSTR("BytesRead")
-            };
-            const CFStringRef writeByteKeys[] = {
-                CFSTR("Bytes (Write)"),
-                CFSTR("Bytes Written"),
-                CFSTR("BytesWritten")
-            };
-            const CFStringRef readOpKeys[] = {
-                CFSTR("Operations (Read)"),
-                CFSTR("Read Operations"),
-                CFSTR("Reads")
-            };
-            const CFStringRef writeOpKeys[] = {
-                CFSTR("Operations (Write)"),
-                CFSTR("Write Operations"),
-                CFSTR("Writes")
-            };
-
-            uint64_t value = 0;
-
-            if (tryGetDictionaryValue(stats, readByteKeys, arraySize(readByteKeys), value)) {
-                totalRead += value;
-            }
-            if (tryGetDictionaryValue(stats, writeByteKeys, arraySize(writeByteKeys), value)) {
-                totalWrite += value;
-            }
-            if (tryGetDictionaryValue(stats, readOpKeys, arraySize(readOpKeys), value)) {
-                totalReadOps += value;
-            }
-            if (tryGetDictionaryValue(stats, writeOpKeys, arraySize(writeOpKeys), value)) {
-                totalWriteOps += value;
-            }
-
-            CFRelease(stats);
-        }
-
-        IOObjectRelease(object);
-    }
-
-    IOObjectRelease(iterator);
-
     if (!diskStatsInitialized_) {
-        prevDiskRead_ = totalRead;
-        prevDiskWrite_ = totalWrite;
-        prevDiskReadOps_ = totalReadOps;
-        prevDiskWriteOps_ = totalWriteOps;
+        prevDiskRead_ = counters.readBytes;
+        prevDiskWrite_ = counters.writeBytes;
+        prevDiskReadOps_ = counters.readOps;
+        prevDiskWriteOps_ = counters.writeOps;
         diskStatsInitialized_ = true;
         diskMetrics_.readBytes = 0;
         diskMetrics_.writeBytes = 0;
@@ -703,18 +904,19 @@ void SystemMetrics::updateDisk() {
         return static_cast<uint64_t>(delta / intervalSeconds);
     };
 
-    diskMetrics_.readBytes = rateFromDelta(totalRead, prevDiskRead_);
-    diskMetrics_.writeBytes = rateFromDelta(totalWrite, prevDiskWrite_);
-    diskMetrics_.readOps = rateFromDelta(totalReadOps, prevDiskReadOps_);
-    diskMetrics_.writeOps = rateFromDelta(totalWriteOps, prevDiskWriteOps_);
+    diskMetrics_.readBytes = rateFromDelta(counters.readBytes, prevDiskRead_);
+    diskMetrics_.writeBytes = rateFromDelta(counters.writeBytes, prevDiskWrite_);
+    diskMetrics_.readOps = rateFromDelta(counters.readOps, prevDiskReadOps_);
+    diskMetrics_.writeOps = rateFromDelta(counters.writeOps, prevDiskWriteOps_);
 
-    prevDiskRead_ = totalRead;
-    prevDiskWrite_ = totalWrite;
-    prevDiskReadOps_ = totalReadOps;
-    prevDiskWriteOps_ = totalWriteOps;
+    prevDiskRead_ = counters.readBytes;
+    prevDiskWrite_ = counters.writeBytes;
+    prevDiskReadOps_ = counters.readOps;
+    prevDiskWriteOps_ = counters.writeOps;
 }
 
 void SystemMetrics::updateSystemInfo() {
+    TRACE_SCOPE("update.systemInfo");
     auto now = std::chrono::steady_clock::now();
     if (lastSystemInfoSample_.time_since_epoch().count() != 0 &&
         now - lastSystemInfoSample_ < kSystemInfoUpdateInterval) {
@@ -741,6 +943,7 @@ void SystemMetrics::updateSystemInfo() {
 }
 
 void SystemMetrics::updateBattery() {
+    TRACE_SCOPE("update.battery");
     BatteryMetrics metrics{};
 
     CFTypeRef powerInfo = IOPSCopyPowerSourcesInfo();
@@ -814,8 +1017,14 @@ void SystemMetrics::updateBattery() {
 }
 
 void SystemMetrics::updateFans() {
+    TRACE_SCOPE("update.fans");
+    if (!smcOpenAttempted_) {
+        openSMC();
+    }
     if (smcConnection_ == IO_OBJECT_NULL) {
-        fanMetrics_.clear();
+        // No SMC: Linux hwmon, which reports nothing where it is missing too
+        openHwmon();
+        hwmon_.updateFans(fanMetrics_);
         return;
     }
 
@@ -863,3 +1072,158 @@ void SystemMetrics::updateFans() {
         }
     }
 }
+#else
+
+void SystemMetrics::updateCPU() {
+}
+
+void SystemMetrics::updateMemory() {
+}
+
+void SystemMetrics::updateSwap() {
+}
+
+void SystemMetrics::updateGPU() {
+}
+
+void SystemMetrics::updateNetwork() {
+}
+
+void SystemMetrics::updateDisk() {
+}
+
+void SystemMetrics::updateSystemInfo() {
+}
+
+void SystemMetrics::updateBattery() {
+}
+
+void SystemMetrics::updateFans() {
+    TRACE_SCOPE("update.fans");
+    openHwmon();
+    hwmon_.updateFans(fanMetrics_);
+}
+
+#endif
+
+void SystemMetrics::openSensors() {
+    if (!smcOpenAttempted_) {
+        openSMC();
+    }
+    openHwmon();
+}
+
+void SystemMetrics::openCgroups() {
+    // The initial hierarchy walk is only paid for once something shows or
+    // records cgroups
+    if (!cgroupOpenAttempted_) {
+        cgroupOpenAttempted_ = true;
+        cgroups_.open();
+    }
+}
+
+void SystemMetrics::updateCgroups() {
+    TRACE_SCOPE("update.cgroups");
+    openCgroups();
+    cgroups_.update(cgroupMetrics_);
+}
+
+void SystemMetrics::updateSched() {
+    TRACE_SCOPE("update.sched");
+    if (!schedOpenAttempted_) {
+        schedOpenAttempted_ = true;
+        sched_.open();
+    }
+    sched_.update(schedMetrics_);
+
+    // Only macOS has a tick source (updateCPU is a stub elsewhere) and only
+    // Linux has schedstat, so there the cpu meter and cpuN.* series come from
+    // the nanosecond run time. It has no user/system split; busy time is
+    // reported as user time.
+    if (!schedMetrics_.valid || !(subsystems_ & SUBSYSTEM_CPU)) {
+        return;
+    }
+    cpuMetrics_.resize(schedMetrics_.cpus.size());
+    for (size_t i = 0; i < cpuMetrics_.size(); ++i) {
+        CPUMetrics& cpu = cpuMetrics_[i];
+        const double busy = schedMetrics_.cpus[i].busyPercent;
+        cpu.user = busy;
+        cpu.system = 0.0;
+        cpu.idle = 100.0 - busy;
+        cpu.total = busy;
+    }
+}
+
+void SystemMetrics::openTcp() {
+    if (!tcpOpenAttempted_) {
+        tcpOpenAttempted_ = true;
+        tcp_.open();
+    }
+}
+
+void SystemMetrics::updateTcp() {
+    TRACE_SCOPE("update.tcp");
+    openTcp();
+    tcp_.update(tcpMetrics_);
+}
+
+void SystemMetrics::openNuma() {
+    if (!numaOpenAttempted_) {
+        numaOpenAttempted_ = true;
+        numa_.open();
+    }
+}
+
+void SystemMetrics::updateNuma() {
+    TRACE_SCOPE("update.numa");
+    openNuma();
+    numa_.update(numaMetrics_);
+}
+
+void SystemMetrics::openCpuFreq() {
+    if (!cpuFreqOpenAttempted_) {
+        cpuFreqOpenAttempted_ = true;
+        cpuFreq_.open();
+    }
+}
+
+void SystemMetrics::updateCpuFreq() {
+    TRACE_SCOPE("update.cpuFreq");
+    openCpuFreq();
+    cpuFreq_.update(cpuFreqMetrics_);
+}
+
+void SystemMetrics::openHwmon() {
+    if (!hwmonOpenAttempted_) {
+        hwmonOpenAttempted_ = true;
+        hwmon_.open();
+    }
+}
+
+void SystemMetrics::updateTemperatures() {
+    TRACE_SCOPE("update.temperatures");
+    openHwmon();
+    hwmon_.updateTemperatures(temperatureMetrics_);
+}
+
+void SystemMetrics::openPerf() {
+    if (!perfOpenAttempted_) {
+        perfOpenAttempted_ = true;
+        perf_.open();
+    }
+}
+
+void SystemMetrics::updatePerf() {
+    TRACE_SCOPE("update.perf");
+    openPerf();
+    perf_.update(perfMetrics_);
+}
+
+void SystemMetrics::updateSelf() {
+    TRACE_SCOPE("update.self");
+    if (!selfOpenAttempted_) {
+        selfOpenAttempted_ = true;
+        self_.open();
+    }
+    self_.update(selfMetrics_);
+}
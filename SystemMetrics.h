@@ -2,16 +2,28 @@
 #define OSXVIEW_SYSTEMMETRICS_H
 
 #include <vector>
+#include <atomic>
 #include <cstdint>
+#include <thread>
 #include <unistd.h>
+#include <chrono>
+#ifdef __APPLE__
 #include <sys/sysctl.h>
 #include <mach/mach.h>
 #include <mach/vm_statistics.h>
-#include <chrono>
 #include <IOKit/IOKitLib.h>
 #include <IOKit/ps/IOPowerSources.h>
 #include <IOKit/ps/IOPSKeys.h>
 #include <CoreFoundation/CoreFoundation.h>
+#endif
+#include "CgroupCollector.h"
+#include "SchedstatCollector.h"
+#include "TcpCollector.h"
+#include "NumaCollector.h"
+#include "CpuFreqCollector.h"
+#include "HwmonCollector.h"
+#include "PerfCollector.h"
+#include "SelfMonitor.h"
 
 struct CPUMetrics {
     double user;
@@ -65,11 +77,51 @@ struct BatteryMetrics {
     int timeRemainingMinutes = -1;
 };
 
-struct FanMetrics {
-    double rpm = 0.0;
-    double minRpm = 0.0;
-    double maxRpm = 0.0;
-    bool valid = false;
+// Collector groups. update() only runs the ones enabled with setSubsystems(),
+// so consumers pay only for what they display or record.
+enum MetricSubsystem : uint32_t {
+    SUBSYSTEM_CPU = 1u << 0,
+    SUBSYSTEM_MEMORY = 1u << 1,
+    SUBSYSTEM_SWAP = 1u << 2,
+    SUBSYSTEM_GPU = 1u << 3,
+    SUBSYSTEM_NETWORK = 1u << 4,
+    SUBSYSTEM_DISK = 1u << 5,
+    SUBSYSTEM_SYSTEM_INFO = 1u << 6,
+    SUBSYSTEM_BATTERY = 1u << 7,
+    SUBSYSTEM_FANS = 1u << 8,
+    SUBSYSTEM_CGROUPS = 1u << 9,
+    SUBSYSTEM_SCHED = 1u << 10,
+    SUBSYSTEM_TCP = 1u << 11,
+    SUBSYSTEM_NUMA = 1u << 12,
+    SUBSYSTEM_CPU_FREQ = 1u << 13,
+    SUBSYSTEM_TEMPERATURE = 1u << 14,
+    SUBSYSTEM_PERF = 1u << 15,
+    SUBSYSTEM_SELF = 1u << 16,
+    SUBSYSTEM_ALL = (1u << 17) - 1
+};
+
+constexpr int SUBSYSTEM_COUNT = 17;
+
+// A full set of metric values for frames that don't come from the
+// collectors (recording replay, benchmarks)
+struct MetricsSnapshot {
+    std::vector<CPUMetrics> cpu;
+    MemoryMetrics memory{};
+    MemoryMetrics swap{};
+    GPUMetrics gpu;
+    NetworkMetrics network{};
+    DiskMetrics disk{};
+    SystemInfo systemInfo{};
+    BatteryMetrics battery;
+    std::vector<FanMetrics> fans;
+    std::vector<CgroupMetrics> cgroups;
+    SchedMetrics sched;
+    TcpMetrics tcp;
+    NumaMetrics numa;
+    CpuFreqMetrics cpuFreq;
+    std::vector<TemperatureMetrics> temperatures;
+    PerfMetrics perf;
+    SelfMetrics self;
 };
 
 class SystemMetrics {
@@ -78,7 +130,22 @@ public:
     ~SystemMetrics();
     
     bool initialize();
+    // Opens the collectors among subsystems whose first open is slow (SMC,
+    // IOKit GPU and disk registry, cgroup walk, perf groups, ...) on a
+    // background thread, so the first samples come from the cheap ones.
+    // update() skips a subsystem until its open has finished.
+    void openInBackground(uint32_t subsystems);
+    // Subsystems whose background open is still running
+    uint32_t pendingSubsystems() const { return opening_.load(std::memory_order_acquire); }
     void update();
+    void setSnapshot(const MetricsSnapshot& snapshot);
+    void setSubsystems(uint32_t subsystems) { subsystems_ = subsystems; }
+    uint32_t subsystems() const { return subsystems_; }
+    // RTT percentiles cost a larger socket dump, so they are opt-in
+    void setTcpRttPercentiles(bool enabled) { tcp_.setRttPercentiles(enabled); }
+    // Incremented by every update() or setSnapshot(), so consumers can tell
+    // a new sample from a repaint of the same one
+    uint64_t sampleCount() const { return sampleCount_; }
     
     std::vector<CPUMetrics> getCPUMetrics() const { return cpuMetrics_; }
     MemoryMetrics getMemoryMetrics() const { return memoryMetrics_; }
@@ -90,6 +157,19 @@ public:
     int getIRQCount() const { return systemInfo_.irqCount; }
     BatteryMetrics getBatteryMetrics() const { return batteryMetrics_; }
     std::vector<FanMetrics> getFanMetrics() const { return fanMetrics_; }
+    const std::vector<TemperatureMetrics>& getTemperatureMetrics() const { return temperatureMetrics_; }
+    const PerfMetrics& getPerfMetrics() const { return perfMetrics_; }
+    // By reference: a busy node has thousands of groups
+    const std::vector<CgroupMetrics>& getCgroupMetrics() const { return cgroupMetrics_; }
+    SchedMetrics getSchedMetrics() const { return schedMetrics_; }
+    TcpMetrics getTcpMetrics() const { return tcpMetrics_; }
+    const NumaMetrics& getNumaMetrics() const { return numaMetrics_; }
+    const CpuFreqMetrics& getCpuFreqMetrics() const { return cpuFreqMetrics_; }
+    const SelfMetrics& getSelfMetrics() const { return selfMetrics_; }
+    
+    // Smoothed wall time of one update of a subsystem (a single
+    // SUBSYSTEM_* bit), 0 until it has run
+    double updateCostMicros(uint32_t subsystem) const;
     
 private:
     void updateCPU();
@@ -101,6 +181,25 @@ private:
     void updateSystemInfo();
     void updateBattery();
     void updateFans();
+    void updateCgroups();
+    void updateSched();
+    void updateTcp();
+    void updateNuma();
+    void updateCpuFreq();
+    void updateTemperatures();
+    void openHwmon();
+    void updatePerf();
+    void updateSelf();
+    void openSMC();
+    void openSensors();
+    void openGPU();
+    void openDisk();
+    void openCgroups();
+    void openTcp();
+    void openNuma();
+    void openCpuFreq();
+    void openPerf();
+    void timedUpdate(uint32_t subsystem, void (SystemMetrics::*update)());
     
     std::vector<CPUMetrics> cpuMetrics_;
     MemoryMetrics memoryMetrics_;
@@ -111,7 +210,33 @@ private:
     SystemInfo systemInfo_;
     BatteryMetrics batteryMetrics_;
     std::vector<FanMetrics> fanMetrics_;
+    std::vector<CgroupMetrics> cgroupMetrics_;
+    SchedMetrics schedMetrics_;
+    TcpMetrics tcpMetrics_;
+    NumaMetrics numaMetrics_;
+    CpuFreqMetrics cpuFreqMetrics_;
+    std::vector<TemperatureMetrics> temperatureMetrics_;
+    PerfMetrics perfMetrics_;
+    SelfMetrics selfMetrics_;
+    double updateCost_[SUBSYSTEM_COUNT] = {};
+    uint64_t updateRuns_[SUBSYSTEM_COUNT] = {};
+    uint64_t sampleCount_ = 0;
+    uint32_t subsystems_ = SUBSYSTEM_ALL;
+    bool smcOpenAttempted_ = false;
+    bool cgroupOpenAttempted_ = false;
+    bool schedOpenAttempted_ = false;
+    bool tcpOpenAttempted_ = false;
+    bool numaOpenAttempted_ = false;
+    bool cpuFreqOpenAttempted_ = false;
+    bool hwmonOpenAttempted_ = false;
+    bool perfOpenAttempted_ = false;
+    bool selfOpenAttempted_ = false;
+    bool gpuOpenAttempted_ = false;
+    bool diskOpenAttempted_ = false;
+    std::atomic<uint32_t> opening_{0};
+    std::thread opener_;
     
+#ifdef __APPLE__
     mach_port_t machPort_;
     processor_cpu_load_info_t prevCpuLoad_;
     unsigned int numCpus_;
@@ -132,6 +257,16 @@ private:
     io_iterator_t networkIter_;
     io_iterator_t diskIter_;
     io_connect_t smcConnection_;
+    io_object_t gpuService_;
+#endif
+    CgroupCollector cgroups_;
+    SchedstatCollector sched_;
+    TcpCollector tcp_;
+    NumaCollector numa_;
+    CpuFreqCollector cpuFreq_;
+    HwmonCollector hwmon_;
+    PerfCollector perf_;
+    SelfMonitor self_;
 };
 
 #endif //OSXVIEW_SYSTEMMETRICS_H
@@ -0,0 +1,303 @@
+#include "TcpCollector.h"
+
+#ifdef __linux__
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <fcntl.h>
+#include <linux/inet_diag.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <linux/sock_diag.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+// Kernel TCP states, as reported in inet_diag_msg::idiag_state
+enum {
+    STATE_ESTABLISHED = 1,
+    STATE_SYN_SENT,
+    STATE_SYN_RECV,
+    STATE_FIN_WAIT1,
+    STATE_FIN_WAIT2,
+    STATE_TIME_WAIT,
+    STATE_CLOSE,
+    STATE_CLOSE_WAIT,
+    STATE_LAST_ACK,
+    STATE_LISTEN,
+    STATE_CLOSING
+};
+
+bool readAll(int fd, std::vector<char>& buffer, size_t& length) {
+    ssize_t result = pread(fd, buffer.data(), buffer.size(), 0);
+    // netstat grows with every kernel release; keep one read per update
+    while (result == static_cast<ssize_t>(buffer.size())) {
+        buffer.resize(buffer.size() * 2);
+        result = pread(fd, buffer.data(), buffer.size(), 0);
+    }
+    if (result <= 0) {
+        return false;
+    }
+    length = static_cast<size_t>(result);
+    return true;
+}
+
+std::string_view nextLine(std::string_view& text) {
+    const size_t end = text.find('\n');
+    const std::string_view line = text.substr(0, end);
+    text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+    return line;
+}
+
+std::string_view nextToken(std::string_view& line) {
+    while (!line.empty() && line.front() == ' ') {
+        line.remove_prefix(1);
+    }
+    const size_t end = std::min(line.find(' '), line.size());
+    const std::string_view token = line.substr(0, end);
+    line.remove_prefix(end);
+    return token;
+}
+
+// The snmp and netstat files pair a "Prefix: Name Name ..." line with a
+// "Prefix: value value ..." line. Fills values[i] for every names[i] found;
+// returns how many were.
+size_t readTable(std::string_view text, std::string_view prefix,
+                 const std::string_view* names, uint64_t* values, size_t count) {
+    while (!text.empty()) {
+        std::string_view header = nextLine(text);
+        if (header.substr(0, prefix.size()) != prefix) {
+            continue;
+        }
+        std::string_view data = nextLine(text);
+        if (data.substr(0, prefix.size()) != prefix) {
+            return 0;
+        }
+        header.remove_prefix(prefix.size());
+        data.remove_prefix(prefix.size());
+
+        size_t found = 0;
+        while (!header.empty()) {
+            const std::string_view name = nextToken(header);
+            const std::string_view value = nextToken(data);
+            for (size_t i = 0; i < count; ++i) {
+                if (name == names[i]) {
+                    // Negative fields (MaxConn) are never among the names
+                    uint64_t number = 0;
+                    for (char c : value) {
+                        number = number * 10 + static_cast<uint64_t>(c - '0');
+                    }
+                    values[i] = number;
+                    ++found;
+                    break;
+                }
+            }
+        }
+        return found;
+    }
+    return 0;
+}
+
+uint32_t percentile(std::vector<uint32_t>& values, double fraction) {
+    const size_t rank = static_cast<size_t>(fraction * static_cast<double>(values.size() - 1));
+    std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(rank), values.end());
+    return values[rank];
+}
+
+} // namespace
+
+TcpCollector::~TcpCollector() {
+    close();
+}
+
+bool TcpCollector::open(const char* procNet) {
+    close();
+    const std::string directory(procNet);
+    snmpFd_ = ::open((directory + "/snmp").c_str(), O_RDONLY | O_CLOEXEC);
+    netstatFd_ = ::open((directory + "/netstat").c_str(), O_RDONLY | O_CLOEXEC);
+
+    diagFd_ = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_SOCK_DIAG);
+    if (diagFd_ >= 0) {
+        sockaddr_nl local{};
+        local.nl_family = AF_NETLINK;
+        if (bind(diagFd_, reinterpret_cast<sockaddr*>(&local), sizeof(local)) != 0) {
+            ::close(diagFd_);
+            diagFd_ = -1;
+        }
+    }
+
+    fileBuffer_.resize(16 * 1024);
+    // The kernel sizes each dump message batch to the reader's buffer, so
+    // a larger one means fewer recv calls per dump
+    receiveBuffer_.resize(64 * 1024);
+    return available();
+}
+
+void TcpCollector::close() {
+    for (int* fd : {&snmpFd_, &netstatFd_, &diagFd_}) {
+        if (*fd >= 0) {
+            ::close(*fd);
+            *fd = -1;
+        }
+    }
+    haveCounters_ = false;
+}
+
+bool TcpCollector::readCounters(uint64_t (&values)[COUNTER_COUNT]) {
+    static const std::string_view tcpNames[] = {"RetransSegs", "OutSegs", "OutRsts", "EstabResets", "AttemptFails"};
+    static const std::string_view extNames[] = {"ListenOverflows", "ListenDrops"};
+
+    size_t length = 0;
+    if (snmpFd_ < 0 || !readAll(snmpFd_, fileBuffer_, length) ||
+        readTable({fileBuffer_.data(), length}, "Tcp:", tcpNames, &values[RETRANS_SEGS], 5) != 5) {
+        return false;
+    }
+    // TcpExt is optional; its counters stay at zero without it
+    if (netstatFd_ >= 0 && readAll(netstatFd_, fileBuffer_, length)) {
+        readTable({fileBuffer_.data(), length}, "TcpExt:", extNames, &values[LISTEN_OVERFLOWS], 2);
+    }
+    return true;
+}
+
+bool TcpCollector::dumpSockets(int family, TcpMetrics& out) {
+    struct {
+        nlmsghdr header;
+        inet_diag_req_v2 request;
+    } message{};
+    message.header.nlmsg_len = sizeof(message);
+    message.header.nlmsg_type = SOCK_DIAG_BY_FAMILY;
+    message.header.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    message.header.nlmsg_seq = ++sequence_;
+    message.request.sdiag_family = static_cast<uint8_t>(family);
+    message.request.sdiag_protocol = IPPROTO_TCP;
+    message.request.idiag_states = ~0u;
+    if (rtt_) {
+        message.request.idiag_ext = 1 << (INET_DIAG_INFO - 1);
+    }
+
+    sockaddr_nl kernel{};
+    kernel.nl_family = AF_NETLINK;
+    if (sendto(diagFd_, &message, sizeof(message), 0, reinterpret_cast<sockaddr*>(&kernel), sizeof(kernel)) < 0) {
+        return false;
+    }
+
+    for (;;) {
+        const ssize_t received = recv(diagFd_, receiveBuffer_.data(), receiveBuffer_.size(), 0);
+        if (received <= 0) {
+            return false;
+        }
+        int remaining = static_cast<int>(received);
+        for (const nlmsghdr* header = reinterpret_cast<const nlmsghdr*>(receiveBuffer_.data());
+             NLMSG_OK(header, remaining);
+             header = NLMSG_NEXT(header, remaining)) {
+            if (header->nlmsg_seq != sequence_) {
+                continue;
+            }
+            if (header->nlmsg_type == NLMSG_DONE) {
+                return true;
+            }
+            if (header->nlmsg_type == NLMSG_ERROR) {
+                return false;
+            }
+            if (header->nlmsg_len < NLMSG_LENGTH(sizeof(inet_diag_msg))) {
+                continue;
+            }
+            const auto* socket = static_cast<const inet_diag_msg*>(NLMSG_DATA(header));
+            switch (socket->idiag_state) {
+                case STATE_ESTABLISHED: ++out.established; break;
+                case STATE_SYN_SENT: ++out.synSent; break;
+                case STATE_SYN_RECV: ++out.synRecv; break;
+                case STATE_FIN_WAIT1:
+                case STATE_FIN_WAIT2: ++out.finWait; break;
+                case STATE_TIME_WAIT: ++out.timeWait; break;
+                case STATE_CLOSE_WAIT: ++out.closeWait; break;
+                case STATE_CLOSE:
+                case STATE_LAST_ACK:
+                case STATE_CLOSING: ++out.closing; break;
+                case STATE_LISTEN: ++out.listen; break;
+                default: break;
+            }
+            ++out.total;
+
+            if (!rtt_ || socket->idiag_state != STATE_ESTABLISHED) {
+                continue;
+            }
+            int attributeLength = static_cast<int>(header->nlmsg_len - NLMSG_LENGTH(sizeof(inet_diag_msg)));
+            for (const rtattr* attribute = reinterpret_cast<const rtattr*>(socket + 1);
+                 RTA_OK(attribute, attributeLength);
+                 attribute = RTA_NEXT(attribute, attributeLength)) {
+                // Older kernels send a shorter tcp_info; tcpi_rtt is in all of them
+                if (attribute->rta_type == INET_DIAG_INFO &&
+                    RTA_PAYLOAD(attribute) >= offsetof(tcp_info, tcpi_rtt) + sizeof(uint32_t)) {
+                    uint32_t rtt;
+                    std::memcpy(&rtt, static_cast<const char*>(RTA_DATA(attribute)) + offsetof(tcp_info, tcpi_rtt), sizeof(rtt));
+                    rtts_.push_back(rtt);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+void TcpCollector::update(TcpMetrics& out) {
+    uint64_t current[COUNTER_COUNT] = {};
+    const auto now = std::chrono::steady_clock::now();
+    out.countersValid = false;
+    if (readCounters(current)) {
+        const double elapsed = std::chrono::duration<double>(now - previousTime_).count();
+        if (haveCounters_ && elapsed > 0.0) {
+            auto rate = [&](Counter counter) {
+                const uint64_t delta = current[counter] >= previous_[counter] ? current[counter] - previous_[counter] : 0;
+                return static_cast<double>(delta) / elapsed;
+            };
+            out.retransSegs = rate(RETRANS_SEGS);
+            out.outSegs = rate(OUT_SEGS);
+            out.retransPercent = out.outSegs > 0.0 ? std::min(100.0, out.retransSegs / out.outSegs * 100.0) : 0.0;
+            out.listenOverflows = rate(LISTEN_OVERFLOWS);
+            out.listenDrops = rate(LISTEN_DROPS);
+            out.resetsSent = rate(OUT_RSTS);
+            out.establishedResets = rate(ESTAB_RESETS);
+            out.attemptFails = rate(ATTEMPT_FAILS);
+            out.countersValid = true;
+        }
+        std::copy(std::begin(current), std::end(current), std::begin(previous_));
+        previousTime_ = now;
+        haveCounters_ = true;
+    }
+
+    out.established = out.synSent = out.synRecv = out.finWait = out.timeWait = 0;
+    out.closeWait = out.closing = out.listen = out.total = 0;
+    rtts_.clear();
+    out.socketsValid = diagFd_ >= 0 && dumpSockets(AF_INET, out) && dumpSockets(AF_INET6, out);
+
+    out.rttValid = out.socketsValid && !rtts_.empty();
+    if (out.rttValid) {
+        out.rttP50Us = percentile(rtts_, 0.50);
+        out.rttP90Us = percentile(rtts_, 0.90);
+        out.rttP99Us = percentile(rtts_, 0.99);
+    }
+}
+
+#else
+
+TcpCollector::~TcpCollector() = default;
+
+bool TcpCollector::open(const char* /* procNet */) {
+    return false;
+}
+
+void TcpCollector::close() {
+}
+
+void TcpCollector::update(TcpMetrics& out) {
+    out.countersValid = false;
+    out.socketsValid = false;
+    out.rttValid = false;
+}
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef OSXVIEW_TCPCOLLECTOR_H
+#define OSXVIEW_TCPCOLLECTOR_H
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+struct TcpMetrics {
+    // Per second, from the kernel's protocol counters
+    double retransSegs = 0.0;
+    double outSegs = 0.0;
+    double retransPercent = 0.0;    // of segments sent
+    double listenOverflows = 0.0;   // accept queue full
+    double listenDrops = 0.0;
+    double resetsSent = 0.0;
+    double establishedResets = 0.0;
+    double attemptFails = 0.0;
+    bool countersValid = false;
+
+    // IPv4 and IPv6 sockets by state
+    uint32_t established = 0;
+    uint32_t synSent = 0;
+    uint32_t synRecv = 0;
+    uint32_t finWait = 0;           // FIN_WAIT1 and FIN_WAIT2
+    uint32_t timeWait = 0;
+    uint32_t closeWait = 0;
+    uint32_t closing = 0;           // CLOSING, LAST_ACK and CLOSE
+    uint32_t listen = 0;
+    uint32_t total = 0;
+    bool socketsValid = false;
+
+    // Smoothed RTT across established connections, when enabled
+    double rttP50Us = 0.0;
+    double rttP90Us = 0.0;
+    double rttP99Us = 0.0;
+    bool rttValid = false;
+};
+
+// TCP health on Linux: retransmit, reset and listen-queue counters from
+// /proc/net/snmp and /proc/net/netstat, and socket counts by state from a
+// NETLINK_SOCK_DIAG dump. The proc files and the netlink socket stay open;
+// dump replies are decoded in place in one receive buffer. On other
+// platforms open() fails.
+class TcpCollector {
+public:
+    TcpCollector() = default;
+    ~TcpCollector();
+
+    TcpCollector(const TcpCollector&) = delete;
+    TcpCollector& operator=(const TcpCollector&) = delete;
+
+    // procNet is the directory holding snmp and netstat
+    bool open(const char* procNet = "/proc/net");
+    void close();
+    bool available() const { return snmpFd_ >= 0 || diagFd_ >= 0; }
+
+    // Asks the kernel for tcp_info with every socket, which makes the dump
+    // roughly four times larger
+    void setRttPercentiles(bool enabled) { rtt_ = enabled; }
+
+    // Rates need two reads; the first update leaves countersValid false
+    void update(TcpMetrics& out);
+
+private:
+    enum Counter {
+        RETRANS_SEGS,
+        OUT_SEGS,
+        OUT_RSTS,
+        ESTAB_RESETS,
+        ATTEMPT_FAILS,
+        LISTEN_OVERFLOWS,
+        LISTEN_DROPS,
+        COUNTER_COUNT
+    };
+
+    bool readCounters(uint64_t (&values)[COUNTER_COUNT]);
+    bool dumpSockets(int family, TcpMetrics& out);
+
+    int snmpFd_ = -1;
+    int netstatFd_ = -1;
+    int diagFd_ = -1;
+    bool rtt_ = false;
+    uint32_t sequence_ = 0;
+    std::vector<char> fileBuffer_;
+    std::vector<char> receiveBuffer_;
+    std::vector<uint32_t> rtts_;
+    uint64_t previous_[COUNTER_COUNT] = {};
+    std::chrono::steady_clock::time_point previousTime_;
+    bool haveCounters_ = false;
+};
+
+#endif //OSXVIEW_TCPCOLLECTOR_H
@@ -0,0 +1,253 @@
+#include "Trace.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string_view>
+
+std::atomic<bool> Trace::enabled_{false};
+
+namespace {
+
+const int MAX_POINTS = 128;
+const size_t RING_SIZE = 16384;
+
+// Log-linear buckets: exact below 8 ns, then 8 per power of two, so a
+// bucket's bounds are within 1/8 of each other up to the 4.3 s cap
+const int SUB_BUCKET_BITS = 3;
+const int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+const int BUCKETS = SUB_BUCKETS + (32 - SUB_BUCKET_BITS) * SUB_BUCKETS;
+
+int bucketFor(uint32_t ns) {
+    if (ns < SUB_BUCKETS) {
+        return static_cast<int>(ns);
+    }
+    const int exponent = 31 - __builtin_clz(ns);
+    const int sub = static_cast<int>(ns >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+    return SUB_BUCKETS + (exponent - SUB_BUCKET_BITS) * SUB_BUCKETS + sub;
+}
+
+uint64_t bucketUpperBound(int bucket) {
+    if (bucket < SUB_BUCKETS) {
+        return static_cast<uint64_t>(bucket);
+    }
+    const int shift = (bucket - SUB_BUCKETS) / SUB_BUCKETS;
+    const uint64_t lower = static_cast<uint64_t>(SUB_BUCKETS + (bucket - SUB_BUCKETS) % SUB_BUCKETS) << shift;
+    return lower + (1ull << shift) - 1;
+}
+
+// Only the owning thread writes; exporters read concurrently, so the
+// fields are atomics used with relaxed ordering (plain moves on x86 and ARM)
+template <typename T, typename V>
+void add(std::atomic<T>& counter, V value) {
+    counter.store(counter.load(std::memory_order_relaxed) + static_cast<T>(value), std::memory_order_relaxed);
+}
+
+struct Event {
+    std::atomic<uint64_t> startNs;
+    std::atomic<uint64_t> pointAndDuration;     // point << 32 | duration ns
+};
+
+struct PointHistogram {
+    std::atomic<uint32_t> buckets[BUCKETS];
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> totalNs;
+    std::atomic<uint32_t> maxNs;
+};
+
+struct ThreadBuffer {
+    uint32_t thread = 0;
+    std::atomic<uint64_t> head{0};              // events ever written
+    Event events[RING_SIZE];
+    PointHistogram points[MAX_POINTS];
+};
+
+// Registration is the only locked path: once per trace point and once per
+// tracing thread. Buffers outlive their threads so their events can still
+// be exported.
+struct Registry {
+    std::mutex mutex;
+    std::vector<const char*> names;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+thread_local ThreadBuffer* localBuffer = nullptr;
+
+ThreadBuffer* registerThread() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.buffers.push_back(std::make_unique<ThreadBuffer>());
+    r.buffers.back()->thread = static_cast<uint32_t>(r.buffers.size());
+    return r.buffers.back().get();
+}
+
+void writeEscaped(std::FILE* file, const char* text) {
+    for (const char* c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            std::fputc('\\', file);
+        }
+        std::fputc(*c, file);
+    }
+}
+
+} // namespace
+
+TracePoint::TracePoint(const char* name) {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    // Points past the limit are never recorded
+    id_ = r.names.size() < MAX_POINTS ? static_cast<int>(r.names.size()) : -1;
+    if (id_ >= 0) {
+        r.names.push_back(name);
+    }
+}
+
+void Trace::record(int point, uint64_t startNs, uint64_t endNs) {
+    if (point < 0) {
+        return;
+    }
+    ThreadBuffer* buffer = localBuffer;
+    if (!buffer) {
+        buffer = localBuffer = registerThread();
+    }
+    const uint32_t duration = static_cast<uint32_t>(std::min<uint64_t>(endNs - startNs, UINT32_MAX));
+
+    const uint64_t head = buffer->head.load(std::memory_order_relaxed);
+    Event& event = buffer->events[head % RING_SIZE];
+    event.startNs.store(startNs, std::memory_order_relaxed);
+    event.pointAndDuration.store(static_cast<uint64_t>(point) << 32 | duration, std::memory_order_relaxed);
+    buffer->head.store(head + 1, std::memory_order_release);
+
+    PointHistogram& histogram = buffer->points[point];
+    add(histogram.buckets[bucketFor(duration)], 1);
+    add(histogram.count, 1);
+    add(histogram.totalNs, duration);
+    if (duration > histogram.maxNs.load(std::memory_order_relaxed)) {
+        histogram.maxNs.store(duration, std::memory_order_relaxed);
+    }
+}
+
+bool Trace::writeChromeJson(const std::string& path) {
+    struct Copied {
+        uint32_t thread;
+        uint64_t startNs;
+        uint64_t pointAndDuration;
+    };
+    std::vector<Copied> copied;
+    std::vector<const char*> names;
+    {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        names = r.names;
+        for (const auto& buffer : r.buffers) {
+            const uint64_t head = buffer->head.load(std::memory_order_acquire);
+            const uint64_t first = head > RING_SIZE ? head - RING_SIZE : 0;
+            const size_t base = copied.size();
+            for (uint64_t i = first; i < head; ++i) {
+                const Event& event = buffer->events[i % RING_SIZE];
+                copied.push_back({buffer->thread, event.startNs.load(std::memory_order_relaxed),
+                                  event.pointAndDuration.load(std::memory_order_relaxed)});
+            }
+            // Drop the oldest slots if the thread wrapped over them meanwhile
+            const uint64_t after = buffer->head.load(std::memory_order_acquire);
+            const uint64_t valid = after > RING_SIZE ? after - RING_SIZE : 0;
+            if (valid > first) {
+                const size_t stale = static_cast<size_t>(std::min(valid, head) - first);
+                copied.erase(copied.begin() + static_cast<std::ptrdiff_t>(base),
+                             copied.begin() + static_cast<std::ptrdiff_t>(base + stale));
+            }
+        }
+    }
+
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        return false;
+    }
+    uint64_t origin = UINT64_MAX;
+    for (const Copied& event : copied) {
+        origin = std::min(origin, event.startNs);
+    }
+    std::fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", file);
+    for (size_t i = 0; i < copied.size(); ++i) {
+        const Copied& event = copied[i];
+        const uint32_t point = static_cast<uint32_t>(event.pointAndDuration >> 32);
+        const uint32_t duration = static_cast<uint32_t>(event.pointAndDuration);
+        std::fputs(i > 0 ? ",\n{\"name\":\"" : "\n{\"name\":\"", file);
+        writeEscaped(file, point < names.size() ? names[point] : "?");
+        std::fprintf(file, "\",\"cat\":\"osxview\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                     event.thread, static_cast<double>(event.startNs - origin) / 1000.0,
+                     static_cast<double>(duration) / 1000.0);
+    }
+    std::fputs("\n]}\n", file);
+    return std::fclose(file) == 0;
+}
+
+std::vector<TraceSpanStats> Trace::spanStats() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+
+    // Points sharing a name (the same span traced in two places) merge
+    struct Merged {
+        const char* name;
+        uint64_t buckets[BUCKETS] = {};
+        uint64_t count = 0;
+        uint64_t totalNs = 0;
+        uint32_t maxNs = 0;
+    };
+    std::vector<Merged> merged;
+    for (size_t point = 0; point < r.names.size(); ++point) {
+        auto it = std::find_if(merged.begin(), merged.end(), [&](const Merged& m) {
+            return std::string_view(m.name) == r.names[point];
+        });
+        if (it == merged.end()) {
+            merged.push_back(Merged{r.names[point]});
+            it = merged.end() - 1;
+        }
+        for (const auto& buffer : r.buffers) {
+            const PointHistogram& histogram = buffer->points[point];
+            for (int b = 0; b < BUCKETS; ++b) {
+                it->buckets[b] += histogram.buckets[b].load(std::memory_order_relaxed);
+            }
+            it->count += histogram.count.load(std::memory_order_relaxed);
+            it->totalNs += histogram.totalNs.load(std::memory_order_relaxed);
+            it->maxNs = std::max(it->maxNs, histogram.maxNs.load(std::memory_order_relaxed));
+        }
+    }
+    std::sort(merged.begin(), merged.end(), [](const Merged& a, const Merged& b) {
+        return a.totalNs > b.totalNs;
+    });
+
+    std::vector<TraceSpanStats> stats;
+    for (const Merged& m : merged) {
+        if (m.count == 0) {
+            continue;
+        }
+        auto percentile = [&](double p) {
+            const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(p / 100.0 * static_cast<double>(m.count) + 0.5));
+            uint64_t seen = 0;
+            for (int b = 0; b < BUCKETS; ++b) {
+                seen += m.buckets[b];
+                if (seen >= rank) {
+                    return static_cast<double>(std::min<uint64_t>(bucketUpperBound(b), m.maxNs)) / 1000.0;
+                }
+            }
+            return static_cast<double>(m.maxNs) / 1000.0;
+        };
+        TraceSpanStats span;
+        span.name = m.name;
+        span.count = m.count;
+        span.meanUs = static_cast<double>(m.totalNs) / static_cast<double>(m.count) / 1000.0;
+        span.p50Us = percentile(50.0);
+        span.p90Us = percentile(90.0);
+        span.p99Us = percentile(99.0);
+        span.maxUs = static_cast<double>(m.maxNs) / 1000.0;
+        stats.push_back(std::move(span));
+    }
+    return stats;
+}
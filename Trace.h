@@ -0,0 +1,95 @@
+#ifndef OSXVIEW_TRACE_H
+#define OSXVIEW_TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Scoped trace points:
+//
+//   void SystemMetrics::updateCPU() {
+//       TRACE_SCOPE("update.cpu");
+//       ...
+//
+// While tracing is off a trace point costs one relaxed load and a branch.
+// While it is on, each scope writes {point, start, duration} into a ring of
+// the calling thread (no locks; the ring and its histograms are allocated
+// on the thread's first event) and adds the duration to that point's
+// latency histogram. The rings keep the most recent events for export as
+// Chrome trace-event JSON, which chrome://tracing and ui.perfetto.dev open;
+// the histograms cover every event since tracing was enabled.
+//
+// Built without OSXVIEW_TRACE (cmake -DOSXVIEW_TRACE=OFF) the macro expands
+// to nothing.
+
+struct TraceSpanStats {
+    std::string name;
+    uint64_t count = 0;
+    double meanUs = 0.0;
+    double p50Us = 0.0;     // histogram bucket bounds, within 1/8 of the value
+    double p90Us = 0.0;
+    double p99Us = 0.0;
+    double maxUs = 0.0;
+};
+
+class TracePoint {
+public:
+    explicit TracePoint(const char* name);
+    int id() const { return id_; }
+
+private:
+    int id_;
+};
+
+class Trace {
+public:
+    static void setEnabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+    static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    static uint64_t now() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+    static void record(int point, uint64_t startNs, uint64_t endNs);
+
+    // Events still in the rings, oldest first per thread
+    static bool writeChromeJson(const std::string& path);
+    // Every point with at least one event, busiest total time first
+    static std::vector<TraceSpanStats> spanStats();
+
+private:
+    static std::atomic<bool> enabled_;
+};
+
+class TraceScope {
+public:
+    explicit TraceScope(const TracePoint& point)
+        : point_(point.id()), start_(Trace::enabled() ? Trace::now() : 0) {}
+    ~TraceScope() {
+        if (start_ != 0) {
+            Trace::record(point_, start_, Trace::now());
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    int point_;
+    uint64_t start_;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#ifdef OSXVIEW_TRACE
+#define TRACE_SCOPE(name)                                                       \
+    static const TracePoint TRACE_CONCAT(tracePoint_, __LINE__)(name);          \
+    const TraceScope TRACE_CONCAT(traceScope_, __LINE__)(TRACE_CONCAT(tracePoint_, __LINE__))
+#else
+#define TRACE_SCOPE(name) static_cast<void>(0)
+#endif
+
+#endif //OSXVIEW_TRACE_H
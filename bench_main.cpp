@@ -0,0 +1,735 @@
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "CgroupCollector.h"
+#include "CpuFreqCollector.h"
+#include "Display.h"
+#include "GlyphAtlas.h"
+#include "HwmonCollector.h"
+#include "MeterRegistry.h"
+#include "MetricStream.h"
+#include "NumaCollector.h"
+#include "PerfCollector.h"
+#include "RecordingFormat.h"
+#include "SchedstatCollector.h"
+#include "SystemMetrics.h"
+#include "TcpCollector.h"
+
+// Microbenchmarks for the collectors, the recording and stream codecs, the
+// display's history/average and text paths, and whole headless frames:
+//
+//   osxview-bench [--filter TEXT] [--format text|json|csv] [--time MS] [--cpus N] [--size WxH]
+//
+// Collectors read fixture trees written to a temporary directory (sized by
+// --cpus), so results do not depend on the machine's own /proc and /sys;
+// only the TCP socket dump and perf counters are live. Rendering uses the
+// software renderer into a CPU surface, so no display or video driver is
+// needed. Every benchmark repeats its body for --time milliseconds and
+// reports per-call times in microseconds; the recording size checks report
+// bytes per value instead.
+
+namespace fs = std::filesystem;
+
+namespace {
+
+struct Result {
+    std::string name;
+    size_t iterations = 0;
+    double mean = 0.0;
+    double p50 = 0.0;
+    double p99 = 0.0;
+    double min = 0.0;
+};
+
+// A size rather than a time, e.g. recorded bytes per value
+struct Measure {
+    std::string name;
+    double value = 0.0;
+    std::string unit;
+};
+
+double percentile(const std::vector<double>& sorted, double p) {
+    const size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * static_cast<double>(sorted.size())));
+    return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+}
+
+class Runner {
+public:
+    Runner(std::string filter, std::chrono::milliseconds duration)
+        : filter_(std::move(filter)), duration_(duration) {}
+
+    bool selected(const std::string& name) const {
+        return filter_.empty() || name.find(filter_) != std::string::npos;
+    }
+
+    // Whether shared setup for these benchmarks is worth doing
+    bool selectedAny(std::initializer_list<const char*> names) const {
+        return std::any_of(names.begin(), names.end(), [&](const char* name) { return selected(name); });
+    }
+
+    template <typename Fn>
+    void run(const std::string& name, Fn&& fn) {
+        if (!selected(name)) {
+            return;
+        }
+        for (int i = 0; i < 3; ++i) {
+            fn();
+        }
+
+        samples_.clear();
+        const auto start = std::chrono::steady_clock::now();
+        while (samples_.size() < MAX_ITERATIONS && std::chrono::steady_clock::now() - start < duration_) {
+            const auto begin = std::chrono::steady_clock::now();
+            fn();
+            samples_.push_back(std::chrono::duration<double, std::micro>(
+                std::chrono::steady_clock::now() - begin).count());
+        }
+
+        Result result;
+        result.name = name;
+        result.iterations = samples_.size();
+        double total = 0.0;
+        for (double sample : samples_) {
+            total += sample;
+        }
+        std::sort(samples_.begin(), samples_.end());
+        result.mean = total / static_cast<double>(samples_.size());
+        result.p50 = percentile(samples_, 50.0);
+        result.p99 = percentile(samples_, 99.0);
+        result.min = samples_.front();
+        results_.push_back(result);
+    }
+
+    void measure(const std::string& name, double value, const std::string& unit) {
+        if (selected(name)) {
+            measures_.push_back({name, value, unit});
+        }
+    }
+
+    void skip(const std::string& name, const std::string& reason) {
+        if (selected(name)) {
+            skipped_.push_back(name + ": " + reason);
+        }
+    }
+
+    const std::vector<Result>& results() const { return results_; }
+    const std::vector<Measure>& measures() const { return measures_; }
+    const std::vector<std::string>& skipped() const { return skipped_; }
+
+private:
+    static const size_t MAX_ITERATIONS = 1000000;
+
+    std::string filter_;
+    std::chrono::milliseconds duration_;
+    std::vector<double> samples_;
+    std::vector<Result> results_;
+    std::vector<Measure> measures_;
+    std::vector<std::string> skipped_;
+};
+
+void writeFile(const fs::path& path, const std::string& text) {
+    fs::create_directories(path.parent_path());
+    std::ofstream(path, std::ios::binary) << text;
+}
+
+// The fixture trees mirror the kernel's file layouts at the given size
+
+void writeSchedstat(const fs::path& path, int cpus) {
+    std::string text = "version 15\ntimestamp 4295123456\n";
+    char line[256];
+    for (int cpu = 0; cpu < cpus; ++cpu) {
+        std::snprintf(line, sizeof(line), "cpu%d 0 0 0 0 0 0 %llu %llu %llu\n", cpu,
+                      123456789012ull + cpu * 1000003ull, 4567890123ull + cpu * 7919ull, 98765432ull + cpu);
+        text += line;
+        for (int domain = 0; domain < 3; ++domain) {
+            std::snprintf(line, sizeof(line), "domain%d %08x", domain, 0xffu << (domain * 8));
+            text += line;
+            for (int field = 0; field < 45; ++field) {
+                text += " " + std::to_string((field * 37 + cpu) % 1000);
+            }
+            text += "\n";
+        }
+    }
+    writeFile(path, text);
+}
+
+void writeCgroups(const fs::path& root, int groups) {
+    writeFile(root / "cgroup.controllers", "cpuset cpu io memory hugetlb pids rdma misc\n");
+    for (int i = 0; i < groups; ++i) {
+        const fs::path group = root / "system.slice" / ("service" + std::to_string(i) + ".service");
+        writeFile(group / "cpu.stat", "usage_usec 12345678\nuser_usec 10000000\nsystem_usec 2345678\n"
+                                      "nr_periods 1000\nnr_throttled 12\nthrottled_usec 34567\n"
+                                      "nr_bursts 0\nburst_usec 0\n");
+        writeFile(group / "cpu.max", i % 4 == 0 ? "200000 100000\n" : "max 100000\n");
+        writeFile(group / "memory.current", std::to_string(104857600 + i * 4096) + "\n");
+        writeFile(group / "memory.max", i % 4 == 0 ? "536870912\n" : "max\n");
+        writeFile(group / "io.stat", "259:0 rbytes=1048576 wbytes=2097152 rios=10 wios=20 dbytes=0 dios=0\n"
+                                     "8:0 rbytes=4096 wbytes=8192 rios=1 wios=2 dbytes=0 dios=0\n");
+        const std::string pressure = "some avg10=0.52 avg60=0.21 avg300=0.08 total=1234567\n"
+                                     "full avg10=0.10 avg60=0.04 avg300=0.01 total=234567\n";
+        writeFile(group / "cpu.pressure", pressure);
+        writeFile(group / "memory.pressure", pressure);
+        writeFile(group / "io.pressure", pressure);
+    }
+}
+
+void writeNuma(const fs::path& root, int nodes) {
+    const char* const meminfoKeys[] = {
+        "MemTotal", "MemFree", "MemUsed", "SwapCached", "Active", "Inactive", "Active(anon)",
+        "Inactive(anon)", "Active(file)", "Inactive(file)", "Unevictable", "Mlocked", "Dirty",
+        "Writeback", "FilePages", "Mapped", "AnonPages", "Shmem", "KernelStack", "PageTables",
+        "Slab", "SReclaimable", "SUnreclaim", "AnonHugePages", "HugePages_Total", "HugePages_Free",
+    };
+    for (int node = 0; node < nodes; ++node) {
+        std::string meminfo;
+        char line[128];
+        uint64_t value = 33554432;
+        for (const char* key : meminfoKeys) {
+            std::snprintf(line, sizeof(line), "Node %d %-16s%10llu kB\n", node, (std::string(key) + ":").c_str(),
+                          static_cast<unsigned long long>(value));
+            meminfo += line;
+            value = value / 2 + 1024;
+        }
+        const fs::path path = root / ("node" + std::to_string(node));
+        writeFile(path / "meminfo", meminfo);
+        writeFile(path / "numastat", "numa_hit 987654321\nnuma_miss 12345\nnuma_foreign 23456\n"
+                                     "interleave_hit 4567\nlocal_node 987000000\nother_node 654321\n");
+    }
+}
+
+void writeCpuFreq(const fs::path& root, int cpus) {
+    for (int cpu = 0; cpu < cpus; ++cpu) {
+        const fs::path path = root / ("cpu" + std::to_string(cpu));
+        writeFile(path / "cpufreq" / "scaling_cur_freq", std::to_string(2400000 + cpu * 1000) + "\n");
+        writeFile(path / "cpufreq" / "cpuinfo_max_freq", "4800000\n");
+        writeFile(path / "thermal_throttle" / "core_throttle_count", "3\n");
+        writeFile(path / "thermal_throttle" / "package_throttle_count", "17\n");
+    }
+}
+
+void writeHwmon(const fs::path& hwmonRoot, const fs::path& thermalRoot) {
+    const char* const chips[] = {"coretemp", "nvme", "nct6775", "acpitz"};
+    for (int chip = 0; chip < 4; ++chip) {
+        const fs::path path = hwmonRoot / ("hwmon" + std::to_string(chip));
+        writeFile(path / "name", std::string(chips[chip]) + "\n");
+        for (int index = 1; index <= 4; ++index) {
+            const std::string base = "temp" + std::to_string(index);
+            writeFile(path / (base + "_input"), std::to_string(40000 + index * 1500) + "\n");
+            writeFile(path / (base + "_label"), "Core " + std::to_string(index - 1) + "\n");
+            writeFile(path / (base + "_max"), "90000\n");
+        }
+        if (chip == 2) {
+            for (int index = 1; index <= 3; ++index) {
+                const std::string base = "fan" + std::to_string(index);
+                writeFile(path / (base + "_input"), std::to_string(900 + index * 150) + "\n");
+                writeFile(path / (base + "_min"), "300\n");
+                writeFile(path / (base + "_max"), "2200\n");
+            }
+        }
+    }
+    // One zone shadowed by the acpitz chip, one of its own
+    const char* const zones[] = {"acpitz", "x86_pkg_temp"};
+    for (int zone = 0; zone < 2; ++zone) {
+        const fs::path path = thermalRoot / ("thermal_zone" + std::to_string(zone));
+        writeFile(path / "type", std::string(zones[zone]) + "\n");
+        writeFile(path / "temp", "51000\n");
+        writeFile(path / "trip_point_0_type", "passive\n");
+        writeFile(path / "trip_point_0_temp", "85000\n");
+        writeFile(path / "trip_point_1_type", "critical\n");
+        writeFile(path / "trip_point_1_temp", "105000\n");
+    }
+}
+
+void writeProcNet(const fs::path& root) {
+    writeFile(root / "snmp",
+              "Ip: Forwarding DefaultTTL InReceives InHdrErrors InAddrErrors ForwDatagrams OutRequests\n"
+              "Ip: 1 64 13440712 0 2 0 13440601\n"
+              "Tcp: RtoAlgorithm RtoMin RtoMax MaxConn ActiveOpens PassiveOpens AttemptFails EstabResets "
+              "CurrEstab InSegs OutSegs RetransSegs InErrs OutRsts InCsumErrors\n"
+              "Tcp: 1 200 120000 -1 18611 18612 1 12 6 134407 134406 1 0 6 0\n"
+              "Udp: InDatagrams NoPorts InErrors OutDatagrams RcvbufErrors SndbufErrors InCsumErrors\n"
+              "Udp: 5021 3 0 5030 0 0 0\n");
+    std::string names = "TcpExt:";
+    std::string values = "TcpExt:";
+    for (int i = 0; i < 120; ++i) {
+        names += i == 20 ? " ListenOverflows" : i == 21 ? " ListenDrops" : " Field" + std::to_string(i);
+        values += " " + std::to_string(i * 13);
+    }
+    writeFile(root / "netstat", names + "\n" + values + "\nIpExt: InNoRoutes InTruncatedPkts\nIpExt: 0 0\n");
+}
+
+// Values vary with the frame so damage tracking repaints every meter
+MetricsSnapshot syntheticSnapshot(int frame, int cpus, const MetricsSnapshot& collected) {
+    MetricsSnapshot snapshot = collected;
+    const double t = frame * 0.05;
+    snapshot.cpu.clear();
+    for (int c = 0; c < cpus; ++c) {
+        const double user = 30.0 + 25.0 * std::sin(t + c * 0.7);
+        const double system = 10.0 + 8.0 * std::cos(t * 1.3 + c);
+        snapshot.cpu.push_back({user, system, 100.0 - user - system, user + system});
+    }
+
+    const uint64_t gib = 1024ull * 1024 * 1024;
+    snapshot.memory.total = 64 * gib;
+    snapshot.memory.used = static_cast<uint64_t>((32.0 + 8.0 * std::sin(t * 0.2)) * gib);
+    snapshot.memory.free = snapshot.memory.total - snapshot.memory.used;
+    snapshot.memory.active = snapshot.memory.used / 2;
+    snapshot.memory.inactive = snapshot.memory.used / 4;
+    snapshot.memory.wired = snapshot.memory.used / 4;
+    snapshot.swap.total = 8 * gib;
+    snapshot.swap.used = gib;
+    snapshot.swap.free = snapshot.swap.total - snapshot.swap.used;
+
+    const auto wave = [&](double scale, double speed) {
+        return static_cast<uint64_t>(scale * (1.0 + std::sin(t * speed)));
+    };
+    snapshot.network = {wave(4e6, 0.8), wave(1e6, 1.1), wave(3e3, 0.8), wave(1e3, 1.1)};
+    snapshot.disk = {wave(2e7, 0.4), wave(8e6, 0.3), wave(400, 0.4), wave(150, 0.3)};
+    snapshot.systemInfo.loadAverage[0] = 2.5 + std::sin(t);
+    snapshot.systemInfo.loadAverage[1] = 2.1;
+    snapshot.systemInfo.loadAverage[2] = 1.8;
+    snapshot.systemInfo.processCount = 420;
+    snapshot.systemInfo.cpuCount = cpus;
+
+    for (size_t c = 0; c < snapshot.sched.cpus.size(); ++c) {
+        snapshot.sched.cpus[c].busyPercent = 50.0 + 40.0 * std::sin(t + static_cast<double>(c));
+    }
+    for (TemperatureMetrics& temperature : snapshot.temperatures) {
+        temperature.celsius += 5.0 * std::sin(t);
+    }
+    snapshot.tcp.retransPercent = 0.5 + 0.5 * std::sin(t);
+    snapshot.perf.total.ipc = 1.5 + std::sin(t);
+    return snapshot;
+}
+
+std::string jsonEscape(const std::string& text) {
+    std::string out;
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+        }
+        out += c;
+    }
+    return out;
+}
+
+void printResults(const Runner& runner, const std::string& format) {
+    char line[256];
+    if (format == "json") {
+        std::cout << "{\"unit\": \"us\", \"benchmarks\": [";
+        for (size_t i = 0; i < runner.results().size(); ++i) {
+            const Result& r = runner.results()[i];
+            std::snprintf(line, sizeof(line),
+                          "%s\n  {\"name\": \"%s\", \"iterations\": %zu, \"mean\": %.3f, \"p50\": %.3f, "
+                          "\"p99\": %.3f, \"min\": %.3f}",
+                          i > 0 ? "," : "", jsonEscape(r.name).c_str(), r.iterations, r.mean, r.p50, r.p99, r.min);
+            std::cout << line;
+        }
+        std::cout << "\n], \"measures\": [";
+        for (size_t i = 0; i < runner.measures().size(); ++i) {
+            const Measure& m = runner.measures()[i];
+            std::snprintf(line, sizeof(line), "%s\n  {\"name\": \"%s\", \"value\": %.3f, \"unit\": \"%s\"}",
+                          i > 0 ? "," : "", jsonEscape(m.name).c_str(), m.value, jsonEscape(m.unit).c_str());
+            std::cout << line;
+        }
+        std::cout << "\n], \"skipped\": [";
+        for (size_t i = 0; i < runner.skipped().size(); ++i) {
+            std::cout << (i > 0 ? ", " : "") << "\"" << jsonEscape(runner.skipped()[i]) << "\"";
+        }
+        std::cout << "]}" << std::endl;
+    } else if (format == "csv") {
+        std::cout << "name,iterations,mean_us,p50_us,p99_us,min_us\n";
+        for (const Result& r : runner.results()) {
+            std::snprintf(line, sizeof(line), "%s,%zu,%.3f,%.3f,%.3f,%.3f\n",
+                          r.name.c_str(), r.iterations, r.mean, r.p50, r.p99, r.min);
+            std::cout << line;
+        }
+        if (!runner.measures().empty()) {
+            std::cout << "\nname,value,unit\n";
+            for (const Measure& m : runner.measures()) {
+                std::snprintf(line, sizeof(line), "%s,%.3f,%s\n", m.name.c_str(), m.value, m.unit.c_str());
+                std::cout << line;
+            }
+        }
+    } else {
+        std::snprintf(line, sizeof(line), "%-28s %10s %10s %10s %10s %10s\n", "benchmark", "iterations", "mean us",
+                      "p50 us", "p99 us", "min us");
+        std::cout << line;
+        for (const Result& r : runner.results()) {
+            std::snprintf(line, sizeof(line), "%-28s %10zu %10.2f %10.2f %10.2f %10.2f\n",
+                          r.name.c_str(), r.iterations, r.mean, r.p50, r.p99, r.min);
+            std::cout << line;
+        }
+        for (const Measure& m : runner.measures()) {
+            std::snprintf(line, sizeof(line), "%-28s %10.3f %s\n", m.name.c_str(), m.value, m.unit.c_str());
+            std::cout << line;
+        }
+        for (const std::string& skipped : runner.skipped()) {
+            std::cout << "skipped " << skipped << "\n";
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string filter;
+    std::string format = "text";
+    int milliseconds = 200;
+    int cpus = 64;
+    int width = 1200;
+    int height = 800;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (std::strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            format = argv[++i];
+        } else if (std::strcmp(argv[i], "--time") == 0 && i + 1 < argc) {
+            milliseconds = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--cpus") == 0 && i + 1 < argc) {
+            cpus = std::clamp(std::atoi(argv[++i]), 1, 4096);
+        } else if (std::strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+            if (std::sscanf(argv[++i], "%dx%d", &width, &height) != 2 || width <= 0 || height <= 0) {
+                std::cerr << "Invalid --size, expected WxH" << std::endl;
+                return 1;
+            }
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--filter TEXT] [--format text|json|csv] [--time MS] [--cpus N] [--size WxH]" << std::endl;
+            return 1;
+        }
+    }
+    if (format != "text" && format != "json" && format != "csv") {
+        std::cerr << "Unknown --format " << format << std::endl;
+        return 1;
+    }
+
+    std::string pattern = (fs::temp_directory_path() / "osxview-bench-XXXXXX").string();
+    if (!mkdtemp(pattern.data())) {
+        std::cerr << "Failed to create a fixture directory" << std::endl;
+        return 1;
+    }
+    const fs::path fixtures = pattern;
+    writeSchedstat(fixtures / "schedstat", cpus);
+    writeCgroups(fixtures / "cgroup", 64);
+    writeNuma(fixtures / "node", 4);
+    writeCpuFreq(fixtures / "cpu", cpus);
+    writeHwmon(fixtures / "hwmon", fixtures / "thermal");
+    writeProcNet(fixtures / "net");
+
+    Runner runner(filter, std::chrono::milliseconds(milliseconds));
+    MetricsSnapshot collected;
+
+    // Collectors: steady-state updates on open files, plus the cgroup walk
+    {
+        CgroupCollector cgroups;
+        runner.run("collector.cgroup.open", [&] { cgroups.open((fixtures / "cgroup").string()); });
+        if (cgroups.open((fixtures / "cgroup").string())) {
+            runner.run("collector.cgroup.update", [&] { cgroups.update(collected.cgroups); });
+        } else {
+            runner.skip("collector.cgroup.update", "open failed");
+        }
+    }
+    {
+        SchedstatCollector sched;
+        if (sched.open((fixtures / "schedstat").c_str())) {
+            runner.run("collector.schedstat", [&] { sched.update(collected.sched); });
+        } else {
+            runner.skip("collector.schedstat", "open failed");
+        }
+    }
+    {
+        NumaCollector numa;
+        if (numa.open((fixtures / "node").string())) {
+            runner.run("collector.numa", [&] { numa.update(collected.numa); });
+        } else {
+            runner.skip("collector.numa", "open failed");
+        }
+    }
+    {
+        CpuFreqCollector cpuFreq;
+        if (cpuFreq.open((fixtures / "cpu").string())) {
+            runner.run("collector.cpufreq", [&] { cpuFreq.update(collected.cpuFreq); });
+        } else {
+            runner.skip("collector.cpufreq", "open failed");
+        }
+    }
+    {
+        HwmonCollector hwmon;
+        if (hwmon.open((fixtures / "hwmon").string(), (fixtures / "thermal").string())) {
+            runner.run("collector.hwmon", [&] {
+                hwmon.updateFans(collected.fans);
+                hwmon.updateTemperatures(collected.temperatures);
+            });
+            runner.run("collector.hwmon.rescan", [&] {
+                hwmon.rescan();
+                hwmon.updateTemperatures(collected.temperatures);
+            });
+        } else {
+            runner.skip("collector.hwmon", "open failed");
+        }
+    }
+    {
+        TcpCollector tcp;
+        if (tcp.open((fixtures / "net").c_str())) {
+            runner.run("collector.tcp", [&] { tcp.update(collected.tcp); });
+            tcp.setRttPercentiles(true);
+            runner.run("collector.tcp.rtt", [&] { tcp.update(collected.tcp); });
+        } else {
+            runner.skip("collector.tcp", "open failed");
+        }
+    }
+    {
+        PerfCollector perf;
+        if (runner.selected("collector.perf") && perf.open()) {
+            runner.run("collector.perf", [&] { perf.update(collected.perf); });
+        } else {
+            runner.skip("collector.perf", "perf_event_open not permitted");
+        }
+    }
+
+    // Recording and stream codecs over one sample of a many-series schema
+    {
+        std::vector<SeriesInfo> series;
+        for (int c = 0; c < cpus; ++c) {
+            for (const char* field : {".user", ".system", ".idle"}) {
+                series.push_back({"cpu" + std::to_string(c) + field, SeriesKind::Gauge});
+            }
+        }
+        for (int i = 0; i < 64; ++i) {
+            series.push_back({"net" + std::to_string(i) + ".bytesIn", SeriesKind::Counter});
+        }
+        std::vector<double> values(series.size());
+        int64_t timestamp = 1700000000000;
+        auto nextSample = [&] {
+            timestamp += 1000;
+            for (size_t i = 0; i < values.size(); ++i) {
+                values[i] = series[i].kind == SeriesKind::Counter
+                    ? static_cast<double>(timestamp / 1000 * static_cast<int64_t>(i + 1))
+                    : std::round(500.0 + 400.0 * std::sin(static_cast<double>(timestamp) * 1e-4 + static_cast<double>(i))) / 10.0;
+            }
+        };
+
+        const std::string recordingPath = (fixtures / "bench.oxv").string();
+        std::error_code error;
+        {
+            RecordingWriter writer;
+            fs::remove(recordingPath, error);
+            if (writer.open(recordingPath, series)) {
+                runner.run("recording.append", [&] {
+                    nextSample();
+                    writer.append(timestamp, values.data(), values.size());
+                });
+                writer.close();
+            } else {
+                runner.skip("recording.append", "cannot write " + recordingPath);
+            }
+        }
+        if (runner.selected("recording.decode")) {
+            RecordingWriter writer(1200);
+            fs::remove(recordingPath, error);
+            writer.open(recordingPath, series);
+            for (int i = 0; i < 1200; ++i) {
+                nextSample();
+                writer.append(timestamp, values.data(), values.size());
+            }
+            writer.close();
+            std::ifstream file(recordingPath, std::ios::binary);
+            const std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            RecordingReader reader;
+            if (reader.open(data.data(), data.size()) && !reader.blocks().empty()) {
+                std::vector<double> column;
+                runner.run("recording.decode", [&] {
+                    for (size_t s = 0; s < reader.series().size(); ++s) {
+                        reader.decodeColumn(0, s, column);
+                    }
+                });
+            } else {
+                runner.skip("recording.decode", "cannot read " + recordingPath);
+            }
+        }
+
+        std::vector<uint8_t> frame;
+        std::vector<uint64_t> previousBits(series.size(), kUnsentValueBits);
+        uint64_t sequence = 0;
+        runner.run("stream.encode", [&] {
+            nextSample();
+            frame.clear();
+            encodeDeltaFrame(++sequence, timestamp, values, previousBits, frame);
+        });
+        MetricStreamDecoder decoder;
+        std::vector<uint8_t> schema;
+        encodeSchemaFrame(series, schema);
+        decoder.feed(schema.data(), schema.size());
+        runner.run("stream.decode", [&] {
+            nextSample();
+            frame.clear();
+            encodeDeltaFrame(++sequence, timestamp, values, previousBits, frame);
+            decoder.feed(frame.data(), frame.size());
+            decoder.takeUpdate();
+        });
+    }
+
+    // Recorded size of the per-CPU shares, the widest group of series: the
+    // same tick-derived percentages stored as plain gauges and as fixed-point
+    if (runner.selectedAny({"recording.cpu.gauge", "recording.cpu.fixed"})) {
+        const int samples = 3600;
+        std::mt19937 random(1);
+        std::normal_distribution<double> step(0.0, 0.04);
+        std::uniform_int_distribution<int> jitter(-2, 2);
+        std::uniform_real_distribution<double> start(0.0, 0.9);
+        std::vector<double> load(static_cast<size_t>(cpus));
+        for (double& share : load) {
+            share = start(random);
+        }
+        std::vector<std::vector<double>> rows(samples);
+        for (auto& row : rows) {
+            for (int c = 0; c < cpus; ++c) {
+                double& share = load[static_cast<size_t>(c)];
+                share = std::clamp(share + step(random), 0.0, 1.0);
+                const int ticks = 100 + jitter(random);
+                const int busy = static_cast<int>(std::lround(share * ticks));
+                const int system = busy / 4;
+                row.push_back((busy - system) * 100.0 / ticks);
+                row.push_back(system * 100.0 / ticks);
+                row.push_back((ticks - busy) * 100.0 / ticks);
+            }
+        }
+
+        const std::string sizePath = (fixtures / "size.oxv").string();
+        std::error_code error;
+        for (SeriesKind kind : {SeriesKind::Gauge, SeriesKind::Fixed}) {
+            const std::string name = kind == SeriesKind::Fixed ? "recording.cpu.fixed" : "recording.cpu.gauge";
+            std::vector<SeriesInfo> series;
+            for (int c = 0; c < cpus; ++c) {
+                for (const char* field : {".user", ".system", ".idle"}) {
+                    series.push_back({"cpu" + std::to_string(c) + field, kind});
+                }
+            }
+            RecordingWriter writer;
+            fs::remove(sizePath, error);
+            if (!writer.open(sizePath, series)) {
+                runner.skip(name, "cannot write " + sizePath);
+                continue;
+            }
+            int64_t timestampMs = 1700000000000;
+            for (const auto& row : rows) {
+                writer.append(timestampMs, row.data(), row.size());
+                timestampMs += 1000;
+            }
+            writer.close();
+            runner.measure(name, static_cast<double>(writer.bytesWritten()) / static_cast<double>(writer.valuesWritten()),
+                           "bytes/value");
+        }
+    }
+
+    // Text caching: atlas rasterization against loading it from the startup
+    // cache, cached size switches, queued text
+    if (runner.selectedAny({"text.atlas.build", "text.atlas.load", "text.atlas.select", "text.draw.200"})) {
+        SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_ARGB8888);
+        SDL_Renderer* renderer = surface ? SDL_CreateSoftwareRenderer(surface) : nullptr;
+        TTF_Font* font = renderer && TTF_Init() == 0 ? Display::openDefaultFont(19) : nullptr;
+        if (font) {
+            runner.run("text.atlas.build", [&] {
+                GlyphAtlas atlas;
+                atlas.build(renderer, font, 19);
+            });
+
+            const std::string cacheDirectory = (fixtures / "cache").string();
+            GlyphAtlas stored;
+            stored.setDiskCache(cacheDirectory, "bench");
+            stored.build(renderer, font, 19);
+            runner.run("text.atlas.load", [&] {
+                GlyphAtlas atlas;
+                atlas.setDiskCache(cacheDirectory, "bench");
+                atlas.loadCached(renderer, 19);
+            });
+
+            GlyphAtlas atlas;
+            TTF_SetFontSize(font, 24);
+            atlas.build(renderer, font, 24);
+            TTF_SetFontSize(font, 19);
+            atlas.build(renderer, font, 19);
+            int size = 19;
+            runner.run("text.atlas.select", [&] {
+                size = size == 19 ? 24 : 19;
+                atlas.select(size);
+            });
+
+            const SDL_Color color = {220, 220, 220, 255};
+            char label[32];
+            runner.run("text.draw.200", [&] {
+                for (int i = 0; i < 200; ++i) {
+                    std::snprintf(label, sizeof(label), "CPU%-3d %5.1f%%", i, i * 0.37);
+                    atlas.draw(10 + (i % 4) * 280, 20 * (i / 4), label, color);
+                }
+                atlas.flush(renderer);
+            });
+            atlas.release();
+            TTF_CloseFont(font);
+            TTF_Quit();
+        } else {
+            runner.skip("text.*", "no renderer or monospace font");
+        }
+        if (renderer) {
+            SDL_DestroyRenderer(renderer);
+        }
+        if (surface) {
+            SDL_FreeSurface(surface);
+        }
+    }
+
+    // Display: the per-meter history and 15 s averages against the graph
+    // mode strip charts, then whole frames
+    if (runner.selectedAny({"display.cpu.average", "display.cpu.graph", "frame.default", "frame.all", "frame.all.graph"})) {
+        Display display(width, height);
+        if (display.initializeOffscreen()) {
+            SystemMetrics metrics;
+            int frameNumber = 0;
+            auto renderFrame = [&] {
+                metrics.setSnapshot(syntheticSnapshot(++frameNumber, cpus, collected));
+                display.beginFrame();
+                display.draw(metrics);
+                display.endFrame();
+            };
+
+            display.setMeters({{MeterKind::CPU, 1}});
+            runner.run("display.cpu.average", renderFrame);
+            display.setGraphMode(true);
+            runner.run("display.cpu.graph", renderFrame);
+            display.setGraphMode(false);
+
+            display.setMeters(defaultMeterLayout());
+            runner.run("frame.default", renderFrame);
+            std::vector<MeterSpec> everything;
+            for (const MeterInfo& info : meterCatalog()) {
+                everything.push_back({info.kind, 1});
+            }
+            display.setMeters(everything);
+            runner.run("frame.all", renderFrame);
+            display.setGraphMode(true);
+            runner.run("frame.all.graph", renderFrame);
+        } else {
+            runner.skip("display.*", std::string("offscreen renderer failed: ") + SDL_GetError());
+        }
+    }
+
+    std::error_code error;
+    fs::remove_all(fixtures, error);
+
+    printResults(runner, format);
+    return 0;
+}
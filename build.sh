@@ -3,7 +3,7 @@ set -euo pipefail
 
 PROJECT_ROOT="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
 BUILD_DIR="${PROJECT_ROOT}/build"
-PROFILE_OPTION="${OSXVIEW_PROFILE:-OFF}"
+TRACE_OPTION="${OSXVIEW_TRACE:-ON}"
 
 echo "=== OSXview bundler ==="
 
@@ -22,10 +22,10 @@ if ! brew list sdl2_ttf &> /dev/null; then
     brew install sdl2_ttf
 fi
 
-echo "Configuring CMake project (OSXVIEW_PROFILE=${PROFILE_OPTION})..."
+echo "Configuring CMake project (OSXVIEW_TRACE=${TRACE_OPTION})..."
 cmake -S "${PROJECT_ROOT}" -B "${BUILD_DIR}" \
     -DCMAKE_BUILD_TYPE=Release \
-    -DOSXVIEW_PROFILE="${PROFILE_OPTION}"
+    -DOSXVIEW_TRACE="${TRACE_OPTION}"
 
 echo "Preparing bundle resources..."
 cp "${PROJECT_ROOT}/Info.plist" "${BUILD_DIR}/Info.plist"
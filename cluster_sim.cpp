@@ -0,0 +1,170 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/resource.h>
+#include "ClusterAgent.h"
+#include "ClusterReceiver.h"
+
+// Simulated cluster agents for exercising the receiver on loopback:
+//
+//   osxview-cluster-sim [--hosts N] [--rate HZ] [--udp] [--duration S] --port P [--host H]
+//   osxview-cluster-sim [--hosts N] [--rate HZ] [--udp] [--duration S] --loopback-check
+//
+// The first form streams to a running `OSXview --receive P`. The second runs
+// a ClusterReceiver in the same thread on a free port and reports how many
+// hosts arrived and how much time the receiver spent per second.
+
+namespace {
+
+struct SimulatedHost {
+    HostSnapshot snapshot;
+    std::unique_ptr<ClusterAgent> agent;
+    double cpuTarget = 0.0;
+};
+
+double walk(std::mt19937& rng, double value, double step, double low, double high) {
+    std::uniform_real_distribution<double> delta(-step, step);
+    return std::clamp(value + delta(rng), low, high);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int hostCount = 500;
+    double rate = 3.0;
+    double duration = 10.0;
+    bool udp = false;
+    bool loopbackCheck = false;
+    std::string host = "127.0.0.1";
+    int port = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--hosts") == 0 && i + 1 < argc) {
+            hostCount = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--rate") == 0 && i + 1 < argc) {
+            rate = std::max(0.1, std::atof(argv[++i]));
+        } else if (std::strcmp(argv[i], "--duration") == 0 && i + 1 < argc) {
+            duration = std::max(0.0, std::atof(argv[++i]));
+        } else if (std::strcmp(argv[i], "--udp") == 0) {
+            udp = true;
+        } else if (std::strcmp(argv[i], "--host") == 0 && i + 1 < argc) {
+            host = argv[++i];
+        } else if (std::strcmp(argv[i], "--port") == 0 && i + 1 < argc) {
+            port = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--loopback-check") == 0) {
+            loopbackCheck = true;
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--hosts N] [--rate HZ] [--udp] [--duration S]"
+                      << " (--port P [--host H] | --loopback-check)" << std::endl;
+            return 1;
+        }
+    }
+
+    ClusterReceiver receiver;
+    if (loopbackCheck) {
+        if (!receiver.listen(0)) {
+            std::cerr << "Failed to listen on loopback" << std::endl;
+            return 1;
+        }
+        port = receiver.port();
+        host = "127.0.0.1";
+    } else if (port <= 0 || port > 65535) {
+        std::cerr << "--port is required" << std::endl;
+        return 1;
+    }
+
+    // Each TCP agent holds a socket (and the in-process receiver its peer)
+    rlimit limit{};
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+        limit.rlim_cur = std::min<rlim_t>(limit.rlim_max, static_cast<rlim_t>(hostCount) * 2 + 256);
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    std::mt19937 rng(42);
+    std::vector<SimulatedHost> hosts(static_cast<size_t>(hostCount));
+    for (int i = 0; i < hostCount; ++i) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "sim-%04d", i);
+        SimulatedHost& sim = hosts[static_cast<size_t>(i)];
+        sim.snapshot.name = name;
+        sim.snapshot.memUsed = 30.0 + (i * 7) % 60;
+        sim.cpuTarget = (i * 13) % 100;
+        sim.agent = std::make_unique<ClusterAgent>(host, static_cast<uint16_t>(port),
+                                                   udp ? ClusterTransport::UDP : ClusterTransport::TCP);
+    }
+
+    const auto tick = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(1.0 / rate));
+    const auto start = std::chrono::steady_clock::now();
+    const auto end = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(duration));
+    auto nextTick = start;
+    double receiverSeconds = 0.0;
+    uint64_t ticks = 0;
+
+    while (std::chrono::steady_clock::now() < end || duration == 0.0) {
+        for (SimulatedHost& sim : hosts) {
+            HostSnapshot& s = sim.snapshot;
+            sim.cpuTarget = walk(rng, sim.cpuTarget, 5.0, 0.0, 100.0);
+            s.cpuUser = sim.cpuTarget * 0.75;
+            s.cpuSystem = sim.cpuTarget * 0.25;
+            s.memUsed = walk(rng, s.memUsed, 0.5, 5.0, 98.0);
+            s.swapUsed = walk(rng, s.swapUsed, 0.2, 0.0, 50.0);
+            s.netIn = walk(rng, s.netIn, 2e6, 0.0, 1e8);
+            s.netOut = walk(rng, s.netOut, 1e6, 0.0, 5e7);
+            s.diskRead = walk(rng, s.diskRead, 4e6, 0.0, 2e8);
+            s.diskWrite = walk(rng, s.diskWrite, 2e6, 0.0, 1e8);
+            sim.agent->send(s);
+        }
+        ticks++;
+        nextTick += tick;
+
+        // Until the next tick, either let the in-process receiver drain or sleep
+        while (std::chrono::steady_clock::now() < nextTick) {
+            if (loopbackCheck) {
+                const auto pollStart = std::chrono::steady_clock::now();
+                receiver.poll(0);
+                receiverSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - pollStart).count();
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            } else {
+                std::this_thread::sleep_until(nextTick);
+            }
+        }
+    }
+
+    uint64_t sent = 0;
+    uint64_t dropped = 0;
+    for (const SimulatedHost& sim : hosts) {
+        sent += sim.agent->sent();
+        dropped += sim.agent->dropped();
+    }
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << hostCount << " hosts over " << (udp ? "UDP" : "TCP") << " at " << rate << " Hz, "
+              << ticks << " ticks in " << elapsed << " s: " << sent << " sent, " << dropped << " dropped"
+              << std::endl;
+
+    if (loopbackCheck) {
+        size_t current = 0;
+        const auto now = std::chrono::steady_clock::now();
+        for (const HostState& state : receiver.hosts()) {
+            if (now - state.lastSeen < std::chrono::seconds(2)) {
+                current++;
+            }
+        }
+        std::cout << "receiver: " << receiver.hosts().size() << " hosts known, " << current << " current, "
+                  << receiver.messagesReceived() << " messages, " << receiver.messagesRejected()
+                  << " rejected, " << receiver.connectionCount() << " connections" << std::endl;
+        std::cout << "receiver time: " << receiverSeconds / elapsed * 1000.0 << " ms per second ("
+                  << receiverSeconds / elapsed * 100.0 << "% of one core)" << std::endl;
+        return receiver.hosts().size() == hosts.size() ? 0 : 1;
+    }
+    return 0;
+}
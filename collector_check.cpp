@@ -0,0 +1,324 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "HwmonCollector.h"
+#include "TcpCollector.h"
+
+// End-to-end checks of the Linux collectors against state this process
+// creates itself:
+//
+//   osxview-collector-check [--tcp-loopback [--connections N]] [--hwmon-fixture]
+//
+// --tcp-loopback opens N loopback connections and expects the sock_diag dump
+// to see them: established and listen sockets rise by at least what was
+// opened, RTTs are reported, and the counts fall again once they are closed.
+// Sockets of other processes come and go meanwhile, so the counts are checked
+// as bounds; a busy server can still fail them.
+//
+// --hwmon-fixture builds a hwmon and thermal tree in a temporary directory
+// and checks the fans, sensor names, readings and limits found in it, that a
+// thermal zone with its own hwmon chip is listed once, and that chips added
+// or removed later are picked up by a rescan. Exits non-zero if any check
+// fails.
+
+namespace fs = std::filesystem;
+
+namespace {
+
+class Checker {
+public:
+    void expect(bool ok, const std::string& what) {
+        std::cout << (ok ? "ok    " : "FAIL  ") << what << std::endl;
+        failures_ += ok ? 0 : 1;
+    }
+
+    int failures() const { return failures_; }
+
+private:
+    int failures_ = 0;
+};
+
+void closeAll(std::vector<int>& sockets) {
+    for (int fd : sockets) {
+        ::close(fd);
+    }
+    sockets.clear();
+}
+
+std::string delta(uint32_t before, uint32_t after) {
+    const long change = static_cast<long>(after) - static_cast<long>(before);
+    return (change >= 0 ? "+" : "") + std::to_string(change);
+}
+
+void checkTcpLoopback(Checker& check, int connections) {
+    TcpCollector tcp;
+    if (!tcp.open()) {
+        check.expect(false, "open TCP collector (needs /proc/net and NETLINK_SOCK_DIAG)");
+        return;
+    }
+    tcp.setRttPercentiles(true);
+
+    TcpMetrics before;
+    tcp.update(before);
+    check.expect(before.socketsValid, "socket dump before connecting");
+
+    // Each connection is two sockets in this process, plus the listener
+    rlimit limit{};
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+        limit.rlim_cur = std::min<rlim_t>(limit.rlim_max, static_cast<rlim_t>(connections) * 2 + 64);
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    const int listener = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t length = sizeof(address);
+    if (listener < 0 || bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(listener, connections) != 0 ||
+        getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+        check.expect(false, "listen on loopback");
+        if (listener >= 0) {
+            ::close(listener);
+        }
+        return;
+    }
+
+    // A loopback connect completes into the backlog; one byte each way then
+    // gives the kernel an RTT sample on both ends
+    std::vector<int> sockets;
+    int opened = 0;
+    for (int i = 0; i < connections; ++i) {
+        const int client = socket(AF_INET, SOCK_STREAM, 0);
+        if (client < 0) {
+            break;
+        }
+        if (connect(client, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            ::close(client);
+            break;
+        }
+        const int server = accept(listener, nullptr, nullptr);
+        if (server < 0) {
+            ::close(client);
+            break;
+        }
+        char byte = 'x';
+        const bool exchanged = write(client, &byte, 1) == 1 && read(server, &byte, 1) == 1 &&
+                               write(server, &byte, 1) == 1 && read(client, &byte, 1) == 1;
+        sockets.push_back(client);
+        sockets.push_back(server);
+        if (!exchanged) {
+            break;
+        }
+        opened++;
+    }
+    check.expect(opened == connections, "open " + std::to_string(connections) + " loopback connections (opened " +
+                                            std::to_string(opened) + ")");
+
+    TcpMetrics during;
+    tcp.update(during);
+    const uint32_t pairs = static_cast<uint32_t>(opened) * 2;
+    check.expect(during.socketsValid && during.established >= before.established + pairs,
+                 "established " + delta(before.established, during.established) + ", expected at least +" +
+                     std::to_string(pairs));
+    check.expect(during.socketsValid && during.listen >= before.listen + 1,
+                 "listen " + delta(before.listen, during.listen) + ", expected at least +1");
+    check.expect(during.rttValid && during.rttP50Us > 0.0 && during.rttP99Us >= during.rttP50Us,
+                 "rttValid with p50 " + std::to_string(std::lround(during.rttP50Us)) + " us, p99 " +
+                     std::to_string(std::lround(during.rttP99Us)) + " us");
+    check.expect(during.countersValid, "protocol counter rates on the second update");
+
+    closeAll(sockets);
+    ::close(listener);
+
+    TcpMetrics after;
+    tcp.update(after);
+    check.expect(after.socketsValid && after.established + pairs <= during.established,
+                 "established " + delta(during.established, after.established) + " after closing, expected at most -" +
+                     std::to_string(pairs));
+    check.expect(after.socketsValid && after.listen < during.listen,
+                 "listen " + delta(during.listen, after.listen) + " after closing");
+}
+
+void writeFile(const fs::path& path, const std::string& text) {
+    fs::create_directories(path.parent_path());
+    std::ofstream(path) << text;
+}
+
+std::string celsius(double value) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.2fC", value);
+    return text;
+}
+
+const TemperatureMetrics* findSensor(const std::vector<TemperatureMetrics>& sensors, const std::string& name) {
+    for (const TemperatureMetrics& sensor : sensors) {
+        if (sensor.name == name) {
+            return &sensor;
+        }
+    }
+    return nullptr;
+}
+
+void expectSensor(Checker& check, const std::vector<TemperatureMetrics>& sensors, const std::string& name,
+                  double celsiusValue, double maxCelsius) {
+    const TemperatureMetrics* sensor = findSensor(sensors, name);
+    check.expect(sensor && sensor->valid && std::fabs(sensor->celsius - celsiusValue) < 1e-9 &&
+                     std::fabs(sensor->maxCelsius - maxCelsius) < 1e-9,
+                 "sensor " + name + " " + (sensor ? celsius(sensor->celsius) + " max " + celsius(sensor->maxCelsius)
+                                                  : std::string("missing")) +
+                     ", expected " + celsius(celsiusValue) + " max " + celsius(maxCelsius));
+}
+
+void expectFan(Checker& check, const std::vector<FanMetrics>& fans, size_t index, double rpm, double minRpm,
+               double maxRpm) {
+    const bool present = index < fans.size();
+    const FanMetrics fan = present ? fans[index] : FanMetrics{};
+    check.expect(present && fan.valid && fan.rpm == rpm && fan.minRpm == minRpm && fan.maxRpm == maxRpm,
+                 "fan " + std::to_string(index) + " " +
+                     (present ? std::to_string(std::lround(fan.rpm)) + " rpm (" + std::to_string(std::lround(fan.minRpm)) +
+                                    ".." + std::to_string(std::lround(fan.maxRpm)) + ")"
+                              : std::string("missing")) +
+                     ", expected " + std::to_string(std::lround(rpm)) + " rpm (" + std::to_string(std::lround(minRpm)) +
+                     ".." + std::to_string(std::lround(maxRpm)) + ")");
+}
+
+void checkHwmonFixture(Checker& check) {
+    std::string pattern = (fs::temp_directory_path() / "osxview-check-XXXXXX").string();
+    if (!mkdtemp(pattern.data())) {
+        check.expect(false, "create a fixture directory");
+        return;
+    }
+    const fs::path root = pattern;
+    const fs::path hwmon = root / "hwmon";
+    const fs::path thermal = root / "thermal";
+
+    // coretemp: a max and a crit-only threshold; nct6775: two fans, one
+    // without limits, and an unlabelled sensor; acpitz: the hwmon side of
+    // thermal_zone0, which must not be listed twice
+    writeFile(hwmon / "hwmon0" / "name", "coretemp\n");
+    writeFile(hwmon / "hwmon0" / "temp1_input", "45000\n");
+    writeFile(hwmon / "hwmon0" / "temp1_label", "Package id 0\n");
+    writeFile(hwmon / "hwmon0" / "temp1_max", "90000\n");
+    writeFile(hwmon / "hwmon0" / "temp2_input", "47500\n");
+    writeFile(hwmon / "hwmon0" / "temp2_label", "Core 0\n");
+    writeFile(hwmon / "hwmon0" / "temp2_crit", "100000\n");
+    writeFile(hwmon / "hwmon1" / "name", "nct6775\n");
+    writeFile(hwmon / "hwmon1" / "fan1_input", "1200\n");
+    writeFile(hwmon / "hwmon1" / "fan1_min", "300\n");
+    writeFile(hwmon / "hwmon1" / "fan1_max", "2200\n");
+    writeFile(hwmon / "hwmon1" / "fan2_input", "800\n");
+    writeFile(hwmon / "hwmon1" / "temp1_input", "38000\n");
+    writeFile(hwmon / "hwmon2" / "name", "acpitz\n");
+    writeFile(hwmon / "hwmon2" / "temp1_input", "27800\n");
+    writeFile(thermal / "thermal_zone0" / "type", "acpitz\n");
+    writeFile(thermal / "thermal_zone0" / "temp", "27800\n");
+    writeFile(thermal / "thermal_zone0" / "trip_point_0_type", "critical\n");
+    writeFile(thermal / "thermal_zone0" / "trip_point_0_temp", "105000\n");
+    writeFile(thermal / "thermal_zone1" / "type", "x86_pkg_temp\n");
+    writeFile(thermal / "thermal_zone1" / "temp", "52000\n");
+    writeFile(thermal / "thermal_zone1" / "trip_point_0_type", "passive\n");
+    writeFile(thermal / "thermal_zone1" / "trip_point_0_temp", "80000\n");
+    writeFile(thermal / "thermal_zone1" / "trip_point_1_type", "hot\n");
+    writeFile(thermal / "thermal_zone1" / "trip_point_1_temp", "95000\n");
+
+    HwmonCollector collector;
+    check.expect(collector.open(hwmon.string(), thermal.string()), "open the fixture tree");
+
+    std::vector<FanMetrics> fans;
+    std::vector<TemperatureMetrics> sensors;
+    collector.updateFans(fans);
+    collector.updateTemperatures(sensors);
+    check.expect(fans.size() == 2, "2 fans, found " + std::to_string(fans.size()));
+    expectFan(check, fans, 0, 1200.0, 300.0, 2200.0);
+    expectFan(check, fans, 1, 800.0, 0.0, 0.0);
+    check.expect(sensors.size() == 5, "5 sensors, found " + std::to_string(sensors.size()));
+    expectSensor(check, sensors, "coretemp/Package id 0", 45.0, 90.0);
+    expectSensor(check, sensors, "coretemp/Core 0", 47.5, 100.0);
+    expectSensor(check, sensors, "nct6775/temp1", 38.0, 0.0);
+    expectSensor(check, sensors, "acpitz/temp1", 27.8, 0.0);
+    expectSensor(check, sensors, "thermal/x86_pkg_temp", 52.0, 95.0);
+    check.expect(!findSensor(sensors, "thermal/acpitz"), "thermal zone acpitz skipped, its hwmon chip is listed");
+
+    // Readings come from the cached fds; discovery does not run again
+    writeFile(hwmon / "hwmon1" / "fan1_input", "1500\n");
+    writeFile(hwmon / "hwmon0" / "temp1_input", "61250\n");
+    writeFile(hwmon / "hwmon3" / "name", "amdgpu\n");
+    writeFile(hwmon / "hwmon3" / "fan1_input", "2000\n");
+    writeFile(hwmon / "hwmon3" / "fan1_max", "3300\n");
+    writeFile(hwmon / "hwmon3" / "temp1_input", "61000\n");
+    writeFile(hwmon / "hwmon3" / "temp1_label", "edge\n");
+    writeFile(hwmon / "hwmon3" / "temp1_crit", "110000\n");
+    collector.updateFans(fans);
+    collector.updateTemperatures(sensors);
+    expectFan(check, fans, 0, 1500.0, 300.0, 2200.0);
+    expectSensor(check, sensors, "coretemp/Package id 0", 61.25, 90.0);
+    check.expect(fans.size() == 2 && sensors.size() == 5, "a new chip is not seen before a hotplug event");
+
+    // Fixture trees raise no uevent; rescan() stands in for the hotplug
+    collector.rescan();
+    collector.updateFans(fans);
+    collector.updateTemperatures(sensors);
+    check.expect(fans.size() == 3, "3 fans after the amdgpu chip is added, found " + std::to_string(fans.size()));
+    expectFan(check, fans, 2, 2000.0, 0.0, 3300.0);
+    check.expect(sensors.size() == 6, "6 sensors after the amdgpu chip is added, found " + std::to_string(sensors.size()));
+    expectSensor(check, sensors, "amdgpu/edge", 61.0, 110.0);
+
+    fs::remove_all(hwmon / "hwmon1");
+    collector.rescan();
+    collector.updateFans(fans);
+    collector.updateTemperatures(sensors);
+    check.expect(fans.size() == 1 && sensors.size() == 5 && !findSensor(sensors, "nct6775/temp1"),
+                 "nct6775 fans and sensor gone after the chip is removed");
+    expectFan(check, fans, 0, 2000.0, 0.0, 3300.0);
+
+    collector.close();
+    std::error_code error;
+    fs::remove_all(root, error);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    bool tcpLoopback = false;
+    bool hwmonFixture = false;
+    int connections = 64;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--tcp-loopback") == 0) {
+            tcpLoopback = true;
+        } else if (std::strcmp(argv[i], "--connections") == 0 && i + 1 < argc) {
+            connections = std::clamp(std::atoi(argv[++i]), 1, 10000);
+        } else if (std::strcmp(argv[i], "--hwmon-fixture") == 0) {
+            hwmonFixture = true;
+        } else {
+            tcpLoopback = hwmonFixture = false;
+            break;
+        }
+    }
+    if (!tcpLoopback && !hwmonFixture) {
+        std::cerr << "Usage: " << argv[0] << " [--tcp-loopback [--connections N]] [--hwmon-fixture]" << std::endl;
+        return 1;
+    }
+
+    Checker check;
+    if (tcpLoopback) {
+        checkTcpLoopback(check, connections);
+    }
+    if (hwmonFixture) {
+        checkHwmonFixture(check);
+    }
+    return check.failures() == 0 ? 0 : 1;
+}
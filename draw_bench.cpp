@@ -0,0 +1,184 @@
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include "DrawList.h"
+
+// Frame-time benchmark for the meter draw path: the same synthetic meter
+// layout (border + two rows of segments per meter, as drawHorizontalMeter
+// produces) is drawn through DrawList in immediate and batched mode.
+//
+//   osxview-draw-bench [--meters N] [--frames N] [--window]
+//
+// Without --window the frames go to an offscreen software renderer so the
+// benchmark runs on machines without a display; --window uses a hidden
+// window with the accelerated renderer, where per-call overhead dominates.
+
+namespace {
+
+struct FrameStats {
+    double meanMs = 0.0;
+    double p50Ms = 0.0;
+    double p99Ms = 0.0;
+    double maxMs = 0.0;
+    size_t callsPerFrame = 0;
+    size_t rectsPerFrame = 0;
+};
+
+const SDL_Color kBorderColor{255, 255, 0, 255};
+const SDL_Color kSegmentColors[] = {
+    {74, 137, 92, 255},
+    {255, 165, 0, 255},
+    {0, 100, 255, 255},
+    {0, 0, 0, 255}
+};
+
+void drawMeters(DrawList& list, int meterCount, int frame, int width, int height) {
+    const int spacing = 8;
+    const int meterHeight = std::max(6, (height - (meterCount + 1) * spacing) / meterCount);
+    const int meterX = width / 4;
+    const int meterWidth = width - meterX - spacing;
+
+    for (int m = 0; m < meterCount; ++m) {
+        const int y = spacing + m * (meterHeight + spacing);
+        list.strokeRect(SDL_Rect{meterX, y, meterWidth, meterHeight}, kBorderColor);
+
+        const int innerLeft = meterX + 2;
+        const int innerWidth = meterWidth - 6;
+        const int halfHeight = (meterHeight - 4) / 2;
+        for (int row = 0; row < 2; ++row) {
+            const double phase = frame * 0.05 + m * 0.7 + row;
+            double values[4] = {
+                30.0 + 25.0 * std::sin(phase),
+                10.0 + 8.0 * std::cos(phase * 1.3),
+                5.0 + 4.0 * std::sin(phase * 0.7),
+                0.0
+            };
+            values[3] = std::max(0.0, 100.0 - values[0] - values[1] - values[2]);
+
+            int x = innerLeft;
+            for (int s = 0; s < 4; ++s) {
+                const int segmentWidth = std::min(static_cast<int>(values[s] / 100.0 * innerWidth),
+                                                  innerLeft + innerWidth - x);
+                list.fillRect(SDL_Rect{x, y + 2 + row * halfHeight, segmentWidth, halfHeight},
+                              kSegmentColors[s]);
+                x += std::max(0, segmentWidth);
+            }
+        }
+    }
+}
+
+FrameStats runFrames(SDL_Renderer* renderer, DrawList::Mode mode, int meterCount, int frames,
+                     int width, int height) {
+    DrawList list(mode);
+    std::vector<double> samples;
+    samples.reserve(static_cast<size_t>(frames));
+    FrameStats stats;
+
+    for (int frame = 0; frame < frames; ++frame) {
+        const auto start = std::chrono::steady_clock::now();
+        SDL_SetRenderDrawColor(renderer, 64, 64, 94, 255);
+        SDL_RenderClear(renderer);
+        list.begin(renderer);
+        drawMeters(list, meterCount, frame, width, height);
+        list.submit();
+        SDL_RenderPresent(renderer);
+        samples.push_back(std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count());
+        stats.callsPerFrame = list.submitCalls();
+        stats.rectsPerFrame = list.rectCount();
+    }
+
+    double total = 0.0;
+    for (double sample : samples) {
+        total += sample;
+    }
+    std::sort(samples.begin(), samples.end());
+    stats.meanMs = total / static_cast<double>(samples.size());
+    stats.p50Ms = samples[samples.size() / 2];
+    stats.p99Ms = samples[std::min(samples.size() - 1, samples.size() * 99 / 100)];
+    stats.maxMs = samples.back();
+    return stats;
+}
+
+void printStats(const char* label, const FrameStats& stats) {
+    std::cout << label << ": mean " << stats.meanMs << " ms, p50 " << stats.p50Ms
+              << " ms, p99 " << stats.p99Ms << " ms, max " << stats.maxMs
+              << " ms (" << stats.rectsPerFrame << " rects, "
+              << stats.callsPerFrame << " draw calls per frame)" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int meterCount = 7;
+    int frames = 2000;
+    bool useWindow = false;
+    const int width = 1200;
+    const int height = 800;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--meters") == 0 && i + 1 < argc) {
+            meterCount = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--window") == 0) {
+            useWindow = true;
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--meters N] [--frames N] [--window]" << std::endl;
+            return 1;
+        }
+    }
+
+    SDL_Window* window = nullptr;
+    SDL_Surface* surface = nullptr;
+    SDL_Renderer* renderer = nullptr;
+
+    if (useWindow) {
+        if (SDL_Init(SDL_INIT_VIDEO) < 0) {
+            std::cerr << "SDL_Init failed: " << SDL_GetError() << std::endl;
+            return 1;
+        }
+        window = SDL_CreateWindow("osxview-draw-bench", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED,
+                                  width, height, SDL_WINDOW_HIDDEN);
+        renderer = window ? SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED) : nullptr;
+    } else {
+        surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_ARGB8888);
+        renderer = surface ? SDL_CreateSoftwareRenderer(surface) : nullptr;
+    }
+    if (!renderer) {
+        std::cerr << "Failed to create renderer: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+
+    SDL_RendererInfo info{};
+    SDL_GetRendererInfo(renderer, &info);
+    std::cout << "Renderer: " << (info.name ? info.name : "unknown") << ", " << meterCount
+              << " meters, " << frames << " frames" << std::endl;
+
+    // Warm up both paths once so first-use costs are not measured
+    runFrames(renderer, DrawList::Mode::Immediate, meterCount, 10, width, height);
+    runFrames(renderer, DrawList::Mode::Batched, meterCount, 10, width, height);
+
+    const FrameStats immediate = runFrames(renderer, DrawList::Mode::Immediate, meterCount, frames, width, height);
+    const FrameStats batched = runFrames(renderer, DrawList::Mode::Batched, meterCount, frames, width, height);
+    printStats("immediate", immediate);
+    printStats("batched  ", batched);
+    if (batched.meanMs > 0.0) {
+        std::cout << "speedup: " << immediate.meanMs / batched.meanMs << "x" << std::endl;
+    }
+
+    SDL_DestroyRenderer(renderer);
+    if (surface) {
+        SDL_FreeSurface(surface);
+    }
+    if (window) {
+        SDL_DestroyWindow(window);
+    }
+    SDL_Quit();
+    return 0;
+}
@@ -0,0 +1,266 @@
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Display.h"
+#include "RecordingFormat.h"
+#include "SystemMetrics.h"
+
+// Frame-time benchmark for the full panel rendered offscreen:
+//
+//   osxview-frame-bench [--frames N] [--size WxH] [--replay file.oxv] [--snapshot out.png]
+//
+// Frames are driven by a synthetic metric stream, or by the samples of a
+// recording written with --record (looped if shorter than --frames). No
+// window or video driver is needed, so this runs on headless CI machines.
+
+namespace {
+
+MetricsSnapshot syntheticSnapshot(int frame) {
+    MetricsSnapshot snapshot;
+    const double t = frame * 0.05;
+    for (int c = 0; c < 8; ++c) {
+        const double user = 30.0 + 25.0 * std::sin(t + c * 0.7);
+        const double system = 10.0 + 8.0 * std::cos(t * 1.3 + c);
+        snapshot.cpu.push_back({user, system, 100.0 - user - system, user + system});
+    }
+
+    const uint64_t gib = 1024ull * 1024 * 1024;
+    snapshot.memory.total = 16 * gib;
+    snapshot.memory.used = static_cast<uint64_t>((8.0 + 2.0 * std::sin(t * 0.2)) * gib);
+    snapshot.memory.free = snapshot.memory.total - snapshot.memory.used;
+    snapshot.memory.active = snapshot.memory.used / 2;
+    snapshot.memory.inactive = snapshot.memory.used / 4;
+    snapshot.memory.wired = snapshot.memory.used / 4;
+    snapshot.swap.total = 2 * gib;
+    snapshot.swap.used = gib / 4;
+    snapshot.swap.free = snapshot.swap.total - snapshot.swap.used;
+
+    snapshot.gpu.deviceUtilization = 40.0 + 30.0 * std::sin(t * 0.9);
+    snapshot.gpu.rendererUtilization = 20.0 + 15.0 * std::cos(t * 0.6);
+    snapshot.gpu.tilerUtilization = 10.0 + 5.0 * std::sin(t * 1.7);
+    snapshot.gpu.valid = true;
+
+    const auto wave = [&](double scale, double speed) {
+        return static_cast<uint64_t>(scale * (1.0 + std::sin(t * speed)));
+    };
+    snapshot.network = {wave(4e6, 0.8), wave(1e6, 1.1), wave(3e3, 0.8), wave(1e3, 1.1)};
+    snapshot.disk = {wave(2e7, 0.4), wave(8e6, 0.3), wave(400, 0.4), wave(150, 0.3)};
+
+    snapshot.systemInfo.loadAverage[0] = 2.5;
+    snapshot.systemInfo.loadAverage[1] = 2.1;
+    snapshot.systemInfo.loadAverage[2] = 1.8;
+    snapshot.systemInfo.processCount = 420;
+    snapshot.systemInfo.cpuCount = 8;
+    snapshot.systemInfo.irqCount = 0;
+
+    snapshot.battery.isPresent = true;
+    snapshot.battery.onACPower = (frame / 600) % 2 == 0;
+    snapshot.battery.isCharging = snapshot.battery.onACPower;
+    snapshot.battery.chargePercent = 50.0 + 40.0 * std::sin(t * 0.05);
+
+    for (int f = 0; f < 2; ++f) {
+        FanMetrics fan;
+        fan.rpm = 2000.0 + 800.0 * std::sin(t * 0.3 + f);
+        fan.minRpm = 1200.0;
+        fan.maxRpm = 6000.0;
+        fan.valid = true;
+        snapshot.fans.push_back(fan);
+    }
+    return snapshot;
+}
+
+// Rebuilds per-sample snapshots from the series MetricRecorder writes
+bool loadReplay(const std::string& path, std::vector<MetricsSnapshot>& out) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+    std::vector<uint8_t> data;
+    uint8_t buffer[1 << 16];
+    size_t n;
+    while ((n = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        data.insert(data.end(), buffer, buffer + n);
+    }
+    std::fclose(file);
+
+    RecordingReader reader;
+    if (!reader.open(data.data(), data.size())) {
+        return false;
+    }
+
+    size_t cpuCount = 0;
+    while (reader.findSeries("cpu" + std::to_string(cpuCount) + ".user") >= 0) {
+        ++cpuCount;
+    }
+    size_t fanCount = 0;
+    while (reader.findSeries("fan" + std::to_string(fanCount) + ".rpm") >= 0) {
+        ++fanCount;
+    }
+
+    std::vector<std::vector<double>> columns(reader.series().size());
+    std::vector<int64_t> timestamps;
+    for (size_t block = 0; block < reader.blocks().size(); ++block) {
+        if (!reader.verifyBlock(block) || !reader.decodeTimestamps(block, timestamps)) {
+            continue;
+        }
+        for (size_t s = 0; s < columns.size(); ++s) {
+            std::vector<double> values;
+            reader.decodeColumn(block, s, values);
+            values.resize(timestamps.size(), NAN);
+            columns[s].insert(columns[s].end(), values.begin(), values.end());
+        }
+    }
+
+    const size_t samples = columns.empty() ? 0 : columns[0].size();
+    auto value = [&](const std::string& name, size_t sample) {
+        const int series = reader.findSeries(name);
+        const double v = series >= 0 ? columns[static_cast<size_t>(series)][sample] : NAN;
+        return std::isnan(v) ? 0.0 : v;
+    };
+    auto present = [&](const std::string& name, size_t sample) {
+        const int series = reader.findSeries(name);
+        return series >= 0 && !std::isnan(columns[static_cast<size_t>(series)][sample]);
+    };
+    auto count = [&](const std::string& name, size_t sample) {
+        return static_cast<uint64_t>(std::max(0.0, value(name, sample)));
+    };
+
+    for (size_t i = 0; i < samples; ++i) {
+        MetricsSnapshot snapshot;
+        for (size_t c = 0; c < cpuCount; ++c) {
+            const std::string prefix = "cpu" + std::to_string(c) + ".";
+            const double user = value(prefix + "user", i);
+            const double system = value(prefix + "system", i);
+            snapshot.cpu.push_back({user, system, value(prefix + "idle", i), user + system});
+        }
+        snapshot.memory = {count("mem.total", i), count("mem.used", i), count("mem.free", i),
+                           count("mem.active", i), count("mem.inactive", i), count("mem.wired", i)};
+        snapshot.swap = {count("swap.total", i), count("swap.used", i), count("swap.free", i), 0, 0, 0};
+        snapshot.gpu.valid = present("gpu.device", i);
+        snapshot.gpu.deviceUtilization = value("gpu.device", i);
+        snapshot.gpu.rendererUtilization = value("gpu.renderer", i);
+        snapshot.gpu.tilerUtilization = value("gpu.tiler", i);
+        snapshot.network = {count("net.bytesIn", i), count("net.bytesOut", i),
+                            count("net.packetsIn", i), count("net.packetsOut", i)};
+        snapshot.disk = {count("disk.readBytes", i), count("disk.writeBytes", i),
+                         count("disk.readOps", i), count("disk.writeOps", i)};
+        snapshot.systemInfo.loadAverage[0] = value("load.1", i);
+        snapshot.systemInfo.loadAverage[1] = value("load.5", i);
+        snapshot.systemInfo.loadAverage[2] = value("load.15", i);
+        snapshot.systemInfo.processCount = static_cast<int>(value("proc.count", i));
+        snapshot.systemInfo.cpuCount = static_cast<int>(cpuCount);
+        snapshot.systemInfo.irqCount = 0;
+        snapshot.battery.isPresent = present("battery.charge", i);
+        snapshot.battery.chargePercent = value("battery.charge", i);
+        snapshot.battery.onACPower = value("battery.onAC", i) != 0.0;
+        for (size_t f = 0; f < fanCount; ++f) {
+            const std::string name = "fan" + std::to_string(f) + ".rpm";
+            FanMetrics fan;
+            fan.valid = present(name, i);
+            fan.rpm = value(name, i);
+            snapshot.fans.push_back(fan);
+        }
+        out.push_back(std::move(snapshot));
+    }
+    return !out.empty();
+}
+
+double percentile(const std::vector<double>& sorted, double p) {
+    const size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * static_cast<double>(sorted.size())));
+    return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int frames = 2000;
+    int width = 1200;
+    int height = 800;
+    std::string replayPath;
+    std::string snapshotPath;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+            if (std::sscanf(argv[++i], "%dx%d", &width, &height) != 2 || width <= 0 || height <= 0) {
+                std::cerr << "Invalid --size, expected WxH" << std::endl;
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replayPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--snapshot") == 0 && i + 1 < argc) {
+            snapshotPath = argv[++i];
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--frames N] [--size WxH] [--replay file.oxv] [--snapshot out.png]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<MetricsSnapshot> replay;
+    if (!replayPath.empty() && !loadReplay(replayPath, replay)) {
+        std::cerr << "Failed to read samples from " << replayPath << std::endl;
+        return 1;
+    }
+
+    Display display(width, height);
+    if (!display.initializeOffscreen()) {
+        std::cerr << "Failed to create offscreen renderer: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+
+    SystemMetrics metrics;
+    auto renderFrame = [&](int frame) {
+        metrics.setSnapshot(replay.empty() ? syntheticSnapshot(frame)
+                                           : replay[static_cast<size_t>(frame) % replay.size()]);
+        display.beginFrame();
+        display.draw(metrics);
+        display.endFrame();
+    };
+
+    // Warm up so atlas and chrome creation are not measured
+    for (int frame = 0; frame < 10; ++frame) {
+        renderFrame(frame);
+    }
+
+    std::vector<double> samples;
+    samples.reserve(static_cast<size_t>(frames));
+    for (int frame = 0; frame < frames; ++frame) {
+        const auto start = std::chrono::steady_clock::now();
+        renderFrame(frame);
+        samples.push_back(std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count());
+    }
+
+    double total = 0.0;
+    for (double sample : samples) {
+        total += sample;
+    }
+    std::sort(samples.begin(), samples.end());
+    std::cout << width << "x" << height << ", " << frames << " frames, "
+              << (replay.empty() ? std::string("synthetic metrics")
+                                 : std::to_string(replay.size()) + " replayed samples") << std::endl;
+    std::cout << "frame time: mean " << total / static_cast<double>(samples.size())
+              << " ms, p50 " << percentile(samples, 50.0)
+              << " ms, p90 " << percentile(samples, 90.0)
+              << " ms, p99 " << percentile(samples, 99.0)
+              << " ms, p99.9 " << percentile(samples, 99.9)
+              << " ms, max " << samples.back() << " ms" << std::endl;
+
+    if (!snapshotPath.empty()) {
+        if (!display.saveSnapshot(snapshotPath)) {
+            std::cerr << "Failed to write " << snapshotPath << std::endl;
+            return 1;
+        }
+        std::cout << "Wrote " << snapshotPath << std::endl;
+    }
+    return 0;
+}
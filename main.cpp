@@ -1,52 +1,497 @@
 #include <iostream>
+#include <algorithm>
 #include <chrono>
 #include <thread>
 #include <signal.h>
-#include <limits>
+#include <cerrno>
 #include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iomanip>
+#include <memory>
+#include <string>
+#include <vector>
+#include <sys/time.h>
+#ifdef __APPLE__
+#include <sys/sysctl.h>
+#endif
 #include "SystemMetrics.h"
+#include "AlertEngine.h"
 #include "Display.h"
+#include "MetricPublisher.h"
+#include "MetricRecorder.h"
+#include "MetricSeries.h"
+#include "MeterRegistry.h"
+#include "ClusterAgent.h"
+#include "ClusterReceiver.h"
+#include "Trace.h"
+#include "CpuGovernor.h"
+#include <unistd.h>
 
 volatile sig_atomic_t running = 1;
 
-#ifdef OSXVIEW_PROFILE
-struct PhaseStats {
-    double totalMs = 0.0;
-    double minMs = std::numeric_limits<double>::max();
-    double maxMs = 0.0;
-    std::uint64_t samples = 0;
+void signalHandler(int /* signal */) {
+    running = 0;
+}
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [--record <file>] [--snapshot <file.png|file.ppm>] [--size WxH] [--graph]"
+              << " [--meters cpu,mem:2,...]" << std::endl;
+    std::cout << "       " << program << " --receive <port>                 (cluster grid of agents)" << std::endl;
+    std::cout << "       " << program << " --agent|--agent-udp <host:port>  (report to a receiver)" << std::endl;
+    std::cout << "       " << program << " --daemon <socket>                (headless, publish to local subscribers)" << std::endl;
+    std::cout << "       --rules <file> evaluates alert rules on every sample (see AlertEngine.h)" << std::endl;
+    std::cout << "       --tcp-rtt adds RTT percentiles of established connections to the tcp series" << std::endl;
+    std::cout << "       --trace <file.json> writes a Chrome/Perfetto trace and span latencies on exit" << std::endl;
+    std::cout << "       --cpu-budget <percent> keeps OSXview under that share of one core by sampling less" << std::endl;
+    std::cout << "       --startup-report prints the time to the first frame, phase by phase" << std::endl;
+    std::cout << "Meters: cpu gpu mem swap disk net fan battery irq cgroup sched tcp numa temp ipc self (name:weight sets relative height)" << std::endl;
+    std::cout << "Press 'g' to toggle the scrolling history graphs" << std::endl;
+}
+
+// "host:port" or "[v6addr]:port"
+bool parseEndpoint(const char* text, std::string& host, uint16_t& port) {
+    const std::string endpoint(text);
+    const size_t colon = endpoint.rfind(':');
+    if (colon == std::string::npos || colon == 0) {
+        return false;
+    }
+    host = endpoint.substr(0, colon);
+    if (host.size() > 2 && host.front() == '[' && host.back() == ']') {
+        host = host.substr(1, host.size() - 2);
+    }
+    const int value = std::atoi(endpoint.c_str() + colon + 1);
+    if (value <= 0 || value > 65535) {
+        return false;
+    }
+    port = static_cast<uint16_t>(value);
+    return true;
+}
+
+HostSnapshot hostSnapshotFrom(const SystemMetrics& metrics) {
+    HostSnapshot snapshot;
+    char hostname[256] = {};
+    if (gethostname(hostname, sizeof(hostname) - 1) == 0) {
+        snapshot.name = hostname;
+    }
+    if (snapshot.name.empty()) {
+        snapshot.name = "localhost";
+    }
+    
+    const auto cpus = metrics.getCPUMetrics();
+    if (!cpus.empty()) {
+        snapshot.cpuUser = cpus[0].user;
+        snapshot.cpuSystem = cpus[0].system;
+    }
+    const MemoryMetrics mem = metrics.getMemoryMetrics();
+    const MemoryMetrics swap = metrics.getSwapMetrics();
+    snapshot.memUsed = mem.total > 0 ? static_cast<double>(mem.used) / mem.total * 100.0 : 0.0;
+    snapshot.swapUsed = swap.total > 0 ? static_cast<double>(swap.used) / swap.total * 100.0 : 0.0;
+    const NetworkMetrics net = metrics.getNetworkMetrics();
+    const DiskMetrics disk = metrics.getDiskMetrics();
+    snapshot.netIn = static_cast<double>(net.bytesIn);
+    snapshot.netOut = static_cast<double>(net.bytesOut);
+    snapshot.diskRead = static_cast<double>(disk.readBytes);
+    snapshot.diskWrite = static_cast<double>(disk.writeBytes);
+    return snapshot;
+}
+
+int64_t wallClockMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// Alert rules bound to the flattened sample layout, rebound when CPUs or
+// fans come and go
+struct AlertState {
+    AlertEngine engine;
+    MetricSeriesMapper mapper;
+    std::vector<double> values;
+    bool bound = false;
 };
+
+void evaluateAlerts(AlertState& alerts, const SystemMetrics& metrics, int64_t timestampMs) {
+    if (!alerts.bound || alerts.mapper.layoutChanged(metrics)) {
+        std::vector<std::string> warnings;
+        alerts.engine.bind(alerts.mapper.layoutFor(metrics), warnings);
+        for (const std::string& warning : warnings) {
+            std::cerr << "Alert rule disabled: " << warning << std::endl;
+        }
+        alerts.bound = true;
+    }
+    alerts.mapper.values(metrics, alerts.values);
+    alerts.engine.evaluate(timestampMs, alerts.values);
+    
+    for (const AlertEvent& event : alerts.engine.events()) {
+        const std::time_t seconds = static_cast<std::time_t>(event.timestampMs / 1000);
+        char time[32];
+        std::strftime(time, sizeof(time), "%Y-%m-%d %H:%M:%S", std::localtime(&seconds));
+        std::cout << time << (event.fired ? " ALERT " : " CLEAR ") << alerts.engine.ruleName(event.rule);
+        if (event.fired) {
+            std::cout << ": " << alerts.engine.ruleText(event.rule);
+        }
+        std::cout << std::endl;
+    }
+}
+
+// Milliseconds since the process was exec'd: to the microsecond on macOS,
+// to the clock tick on Linux; negative when unknown
+double processAgeMs() {
+#ifdef __APPLE__
+    int mib[] = {CTL_KERN, KERN_PROC, KERN_PROC_PID, getpid()};
+    kinfo_proc info{};
+    size_t size = sizeof(info);
+    timeval now{};
+    if (sysctl(mib, 4, &info, &size, nullptr, 0) != 0 || size == 0 || gettimeofday(&now, nullptr) != 0) {
+        return -1.0;
+    }
+    const timeval& started = info.kp_proc.p_starttime;
+    return static_cast<double>(now.tv_sec - started.tv_sec) * 1000.0 +
+           static_cast<double>(now.tv_usec - started.tv_usec) / 1000.0;
+#else
+    // Field 22 of /proc/self/stat, after the parenthesized command name
+    char buffer[1024];
+    std::FILE* file = std::fopen("/proc/self/stat", "r");
+    const size_t length = file ? std::fread(buffer, 1, sizeof(buffer) - 1, file) : 0;
+    if (file) {
+        std::fclose(file);
+    }
+    buffer[length] = '\0';
+    const char* field = std::strrchr(buffer, ')');
+    for (int i = 0; i < 20 && field; ++i) {
+        field = std::strchr(field + 1, ' ');
+    }
+    timespec now{};
+    if (!field || clock_gettime(CLOCK_BOOTTIME, &now) != 0) {
+        return -1.0;
+    }
+    const double startedMs = static_cast<double>(std::strtoull(field + 1, nullptr, 10)) * 1000.0 /
+                             static_cast<double>(sysconf(_SC_CLK_TCK));
+    return static_cast<double>(now.tv_sec) * 1000.0 + static_cast<double>(now.tv_nsec) / 1e6 - startedMs;
 #endif
+}
 
-void signalHandler(int /* signal */) {
-    running = 0;
+// Where the time to the first frame goes: exec to main(), then each phase
+// marked until the first frame is on screen. The slow collectors opening in
+// the background are reported once a loop pass finds them all ready.
+class StartupReport {
+public:
+    StartupReport()
+        : preMainMs_(processAgeMs()), start_(std::chrono::steady_clock::now()), last_(start_) {
+    }
+
+    void mark(const char* phase) {
+        const auto now = std::chrono::steady_clock::now();
+        phases_.push_back({phase, std::chrono::duration<double, std::milli>(now - last_).count()});
+        last_ = now;
+    }
+
+    void printFirstFrame() const {
+        const double sinceMain = std::chrono::duration<double, std::milli>(last_ - start_).count();
+        const double total = sinceMain + std::max(0.0, preMainMs_);
+        std::cout << std::fixed << std::setprecision(1) << "Startup:";
+        if (preMainMs_ >= 0.0) {
+            std::cout << " exec-to-main " << preMainMs_ << " ms,";
+        }
+        for (size_t i = 0; i < phases_.size(); ++i) {
+            std::cout << (i > 0 ? ", " : " ") << phases_[i].first << " " << phases_[i].second << " ms";
+        }
+        std::cout << "; first frame after " << total << " ms" << (total > TARGET_MS ? " (over " : " (target ")
+                  << static_cast<int>(TARGET_MS) << " ms)" << std::endl;
+    }
+
+    void printCollectorsReady() const {
+        const double sinceMain = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_).count();
+        std::cout << std::fixed << std::setprecision(1) << "Startup: slow collectors ready by "
+                  << sinceMain + std::max(0.0, preMainMs_) << " ms" << std::endl;
+    }
+
+private:
+    static constexpr double TARGET_MS = 50.0;
+    double preMainMs_;
+    std::chrono::steady_clock::time_point start_;
+    std::chrono::steady_clock::time_point last_;
+    std::vector<std::pair<const char*, double>> phases_;
+};
+
+// Writes the trace-event file and prints per-span latencies
+void finishTrace(const std::string& path) {
+    if (path.empty()) {
+        return;
+    }
+    Trace::setEnabled(false);
+    if (!Trace::writeChromeJson(path)) {
+        std::cerr << "Failed to write trace to " << path << std::endl;
+    }
+    std::cout << std::left << std::setw(24) << "span" << std::right << std::setw(10) << "count"
+              << std::setw(10) << "mean us" << std::setw(10) << "p50 us" << std::setw(10) << "p90 us"
+              << std::setw(10) << "p99 us" << std::setw(10) << "max us" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    for (const TraceSpanStats& span : Trace::spanStats()) {
+        std::cout << std::left << std::setw(24) << span.name << std::right << std::setw(10) << span.count
+                  << std::setw(10) << span.meanUs << std::setw(10) << span.p50Us << std::setw(10) << span.p90Us
+                  << std::setw(10) << span.p99Us << std::setw(10) << span.maxUs << std::endl;
+    }
+}
+
+// Headless mode: samples every collector and streams delta frames to
+// subscribers on a Unix socket. The publisher's poll doubles as the wait
+// between samples, so subscribers are served while the sampler is idle.
+int runDaemon(SystemMetrics& metrics, const std::string& socketPath, AlertState* alerts, CpuGovernor* governor) {
+    MetricPublisher publisher;
+    if (!publisher.listen(socketPath)) {
+        std::cerr << "Failed to listen on " << socketPath << ": " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+    std::cout << "Publishing metrics on " << socketPath << " - Press Ctrl+C to exit" << std::endl;
+    
+    const std::chrono::milliseconds updateInterval(333);
+    MetricSeriesMapper mapper;
+    std::vector<double> values;
+    bool haveSchema = false;
+    auto nextUpdate = std::chrono::steady_clock::now();
+    
+    while (running) {
+        const auto now = std::chrono::steady_clock::now();
+        if (now < nextUpdate) {
+            publisher.poll(static_cast<int>(
+                std::chrono::duration_cast<std::chrono::milliseconds>(nextUpdate - now).count()) + 1);
+            continue;
+        }
+        
+        const uint32_t subsystems = governor ? governor->filter(SUBSYSTEM_ALL) : SUBSYSTEM_ALL;
+        const std::chrono::milliseconds interval = governor ? governor->interval(updateInterval) : updateInterval;
+        metrics.setSubsystems(subsystems);
+        metrics.update();
+        if (governor) {
+            governor->observe(metrics, subsystems, interval);
+        }
+        if (!haveSchema || mapper.layoutChanged(metrics)) {
+            publisher.setSchema(mapper.layoutFor(metrics));
+            haveSchema = true;
+        }
+        mapper.values(metrics, values);
+        const int64_t timestampMs = wallClockMs();
+        publisher.publish(timestampMs, values);
+        if (alerts) {
+            evaluateAlerts(*alerts, metrics, timestampMs);
+        }
+        
+        // Keep a fixed cadence instead of drifting by the sampling cost
+        nextUpdate += interval;
+        if (nextUpdate < now) {
+            nextUpdate = now + interval;
+        }
+    }
+    
+    std::cout << "\nShutting down OSXview daemon (" << publisher.framesSent() << " frames sent, "
+              << publisher.framesCoalesced() << " coalesced)" << std::endl;
+    return 0;
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    StartupReport startup;
+    bool startupReport = false;
+    std::string recordPath;
+    std::string snapshotPath;
+    int width = 355;
+    int height = 236;
+    bool graphMode = false;
+    std::vector<MeterSpec> meterLayout = defaultMeterLayout();
+    int receivePort = 0;
+    std::string agentHost;
+    uint16_t agentPort = 0;
+    ClusterTransport agentTransport = ClusterTransport::TCP;
+    std::string daemonSocket;
+    std::unique_ptr<AlertState> alerts;
+    bool tcpRtt = false;
+    std::string tracePath;
+    std::unique_ptr<CpuGovernor> governor;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--snapshot") == 0 && i + 1 < argc) {
+            snapshotPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+            if (std::sscanf(argv[++i], "%dx%d", &width, &height) != 2 || width <= 0 || height <= 0) {
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--meters") == 0 && i + 1 < argc) {
+            std::string error;
+            if (!parseMeterLayout(argv[++i], meterLayout, error)) {
+                std::cerr << "--meters: " << error << std::endl;
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--receive") == 0 && i + 1 < argc) {
+            receivePort = std::atoi(argv[++i]);
+            if (receivePort <= 0 || receivePort > 65535) {
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if ((std::strcmp(argv[i], "--agent") == 0 || std::strcmp(argv[i], "--agent-udp") == 0) && i + 1 < argc) {
+            agentTransport = argv[i][7] == '-' ? ClusterTransport::UDP : ClusterTransport::TCP;
+            if (!parseEndpoint(argv[++i], agentHost, agentPort)) {
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--daemon") == 0 && i + 1 < argc) {
+            daemonSocket = argv[++i];
+        } else if (std::strcmp(argv[i], "--rules") == 0 && i + 1 < argc) {
+            alerts = std::make_unique<AlertState>();
+            std::string error;
+            if (!alerts->engine.loadFile(argv[++i], error)) {
+                std::cerr << "--rules: " << error << std::endl;
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--tcp-rtt") == 0) {
+            tcpRtt = true;
+        } else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            tracePath = argv[++i];
+#ifndef OSXVIEW_TRACE
+            std::cerr << "--trace: built without OSXVIEW_TRACE, the trace will be empty" << std::endl;
+#endif
+        } else if (std::strcmp(argv[i], "--cpu-budget") == 0 && i + 1 < argc) {
+            const double budget = std::atof(argv[++i]);
+            if (budget <= 0.0) {
+                printUsage(argv[0]);
+                return 1;
+            }
+            governor = std::make_unique<CpuGovernor>(budget);
+        } else if (std::strcmp(argv[i], "--startup-report") == 0) {
+            startupReport = true;
+        } else if (std::strcmp(argv[i], "--graph") == 0) {
+            graphMode = true;
+        } else if (std::strcmp(argv[i], "--help") == 0 || std::strcmp(argv[i], "-h") == 0) {
+            printUsage(argv[0]);
+            return 0;
+        } else if (std::strncmp(argv[i], "-psn_", 5) == 0) {
+            // Finder passes a process serial number when launching the bundle
+            continue;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
     // Set up signal handlers for graceful shutdown
     signal(SIGINT, signalHandler);
     signal(SIGTERM, signalHandler);
     
+    Trace::setEnabled(!tracePath.empty());
+    
     // Initialize system metrics collector
     SystemMetrics metrics;
     if (!metrics.initialize()) {
         std::cerr << "Failed to initialize system metrics" << std::endl;
         return 1;
     }
+    metrics.setTcpRttPercentiles(tcpRtt);
+    startup.mark("metrics");
+    
+    if (!daemonSocket.empty()) {
+        const int status = runDaemon(metrics, daemonSocket, alerts.get(), governor.get());
+        finishTrace(tracePath);
+        return status;
+    }
     
     // Initialize display 580 388 -> 280 120
-    Display display(355, 236);
+    Display display(width, height);
+    display.setGraphMode(graphMode);
+    display.setMeters(meterLayout);
+    metrics.setSubsystems(display.requiredSubsystems());
+    
+    if (!snapshotPath.empty()) {
+        // Render a single frame offscreen and exit. Rates need two samples,
+        // so sample once more after one update interval.
+        if (!display.initializeOffscreen()) {
+            std::cerr << "Failed to initialize offscreen display" << std::endl;
+            return 1;
+        }
+        metrics.update();
+        std::this_thread::sleep_for(std::chrono::milliseconds(333));
+        metrics.update();
+        display.beginFrame();
+        display.draw(metrics);
+        display.endFrame();
+        if (!display.saveSnapshot(snapshotPath)) {
+            std::cerr << "Failed to write snapshot to " << snapshotPath << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+    
+    // The slow collectors open while the window and font come up; their
+    // meters fill in from the samples after
+    if (receivePort == 0) {
+        uint32_t subsystems = recordPath.empty() ? display.requiredSubsystems() : SUBSYSTEM_ALL;
+        if (alerts) {
+            subsystems |= alerts->engine.requiredSubsystems();
+        }
+        metrics.openInBackground(governor ? governor->filter(subsystems) : subsystems);
+    }
+    
     if (!display.initialize()) {
         std::cerr << "Failed to initialize display" << std::endl;
         return 1;
     }
+    startup.mark("display");
+    
+    std::unique_ptr<MetricRecorder> recorder;
+    if (!recordPath.empty()) {
+        recorder = std::make_unique<MetricRecorder>(recordPath);
+        std::cout << "Recording metrics to " << recordPath << std::endl;
+    }
+    
+    std::unique_ptr<ClusterReceiver> receiver;
+    if (receivePort > 0) {
+        receiver = std::make_unique<ClusterReceiver>();
+        if (!receiver->listen(static_cast<uint16_t>(receivePort))) {
+            std::cerr << "Failed to listen on port " << receivePort << std::endl;
+            return 1;
+        }
+        std::cout << "Receiving host snapshots on TCP and UDP port " << receiver->port() << std::endl;
+    }
+    
+    std::unique_ptr<ClusterAgent> agent;
+    if (!agentHost.empty()) {
+        agent = std::make_unique<ClusterAgent>(agentHost, agentPort, agentTransport);
+        std::cout << "Reporting to " << agentHost << ":" << agentPort << std::endl;
+    }
     
     std::cout << "OSXview started - Press Ctrl+C to exit" << std::endl;
     
     // Main loop
     const std::chrono::milliseconds updateInterval(333); // Update every 1/3 second
+    // While nobody can see the window, sample just often enough to keep the
+    // collectors' deltas meaningful and stay out of the laptop's wakeup list
+    const std::chrono::milliseconds backgroundInterval(5000);
     auto lastUpdate = std::chrono::steady_clock::now() - updateInterval;
     bool needsRender = true;
+    bool firstFrame = true;
+    bool collectorsReported = false;
+    bool windowVisible = true;
+    bool windowFocused = true;
+    
+    // A drag-resize delivers dozens of size events per second. They only
+    // mark the layout dirty; it is redone once the events pause for
+    // resizeDebounce, or at least every resizeMaxDelay while dragging.
+    const std::chrono::milliseconds resizeDebounce(40);
+    const std::chrono::milliseconds resizeMaxDelay(100);
+    bool resizePending = false;
+    std::chrono::steady_clock::time_point firstResizeEvent;
+    std::chrono::steady_clock::time_point lastResizeEvent;
+    
+    auto setVisible = [&](bool visible) {
+        if (visible && !windowVisible) {
+            // The window surface may be stale after being hidden
+            display.invalidate();
+            needsRender = true;
+        }
+        windowVisible = visible;
+    };
     
     auto handleEvent = [&](const SDL_Event& event) {
         if (event.type == SDL_QUIT) {
@@ -54,96 +499,173 @@ int main() {
             return;
         }
         
+        if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_g) {
+            display.setGraphMode(!display.graphMode());
+            needsRender = true;
+            return;
+        }
+        
         if (event.type == SDL_WINDOWEVENT) {
             switch (event.window.event) {
                 case SDL_WINDOWEVENT_RESIZED:
                 case SDL_WINDOWEVENT_SIZE_CHANGED:
-                    display.handleResize(event.window.data1, event.window.data2);
-                    needsRender = true;
+                    lastResizeEvent = std::chrono::steady_clock::now();
+                    if (!resizePending) {
+                        firstResizeEvent = lastResizeEvent;
+                        resizePending = true;
+                    }
                     break;
                 case SDL_WINDOWEVENT_EXPOSED:
+                    // The window surface may have lost its contents
+                    setVisible(true);
+                    display.invalidate();
                     needsRender = true;
                     break;
+                case SDL_WINDOWEVENT_MINIMIZED:
+                case SDL_WINDOWEVENT_HIDDEN:
+                    setVisible(false);
+                    break;
+                case SDL_WINDOWEVENT_SHOWN:
+                case SDL_WINDOWEVENT_RESTORED:
+                case SDL_WINDOWEVENT_MAXIMIZED:
+                    setVisible(true);
+                    break;
+                case SDL_WINDOWEVENT_FOCUS_GAINED:
+                    // A monitor is read while other apps have focus, so focus
+                    // does not change the rate; regaining it does mean the
+                    // window was just looked at and may have been covered
+                    if (!windowFocused) {
+                        display.invalidate();
+                        needsRender = true;
+                    }
+                    windowFocused = true;
+                    break;
+                case SDL_WINDOWEVENT_FOCUS_LOST:
+                    windowFocused = false;
+                    break;
                 default:
                     break;
             }
         }
     };
     
-    #ifdef OSXVIEW_PROFILE
-    constexpr std::uint64_t kProfileReportEvery = 120;
-    PhaseStats updateStats;
-    PhaseStats renderStats;
-    auto resetStats = [](PhaseStats& stats) {
-        stats.totalMs = 0.0;
-        stats.minMs = std::numeric_limits<double>::max();
-        stats.maxMs = 0.0;
-        stats.samples = 0;
-    };
-    resetStats(updateStats);
-    resetStats(renderStats);
-    auto recordSample = [&](PhaseStats& stats, double elapsedMs, const char* label) {
-        stats.totalMs += elapsedMs;
-        if (elapsedMs < stats.minMs) {
-            stats.minMs = elapsedMs;
-        }
-        if (elapsedMs > stats.maxMs) {
-            stats.maxMs = elapsedMs;
-        }
-        stats.samples++;
-        if (stats.samples >= kProfileReportEvery) {
-            double avg = stats.totalMs / static_cast<double>(stats.samples);
-            std::cout << "[profile] " << label << ": avg " << avg
-                      << " ms (min " << stats.minMs
-                      << ", max " << stats.maxMs
-                      << ") over " << stats.samples << " samples" << std::endl;
-            resetStats(stats);
-        }
-    };
-    #endif
-
     while (running) {
         auto now = std::chrono::steady_clock::now();
         
+        // Full rate whenever the samples are shown or consumed by a recorder,
+        // a cluster receiver or alert rules
+        const bool fullRate = windowVisible || recorder != nullptr || agent != nullptr || alerts != nullptr;
+        
+        if (receiver) {
+            receiver->poll(0);
+        }
+        std::chrono::milliseconds interval = fullRate ? updateInterval : backgroundInterval;
+        if (governor) {
+            interval = governor->interval(interval);
+        }
+        
         // Update metrics at the specified interval
-        if (now - lastUpdate >= updateInterval) {
-            #ifdef OSXVIEW_PROFILE
-            auto updateStart = std::chrono::steady_clock::now();
-            #endif
+        if (now - lastUpdate >= interval) {
+            TRACE_SCOPE("main.sample");
+            // Collect only what is displayed, unless a recorder wants every series.
+            // The cluster grid shows remote hosts only.
+            uint32_t subsystems = receiver ? 0 : display.requiredSubsystems();
+            if (agent) {
+                subsystems |= SUBSYSTEM_CPU | SUBSYSTEM_SCHED | SUBSYSTEM_MEMORY | SUBSYSTEM_SWAP | SUBSYSTEM_NETWORK |
+                              SUBSYSTEM_DISK;
+            }
+            if (alerts) {
+                subsystems |= alerts->engine.requiredSubsystems();
+            }
+            if (recorder) {
+                subsystems = SUBSYSTEM_ALL;
+            }
+            // The governor needs the self meter and may hold collectors back
+            if (governor) {
+                subsystems = governor->filter(subsystems | SUBSYSTEM_SELF);
+            }
+            metrics.setSubsystems(subsystems);
             metrics.update();
-            #ifdef OSXVIEW_PROFILE
-            auto updateEnd = std::chrono::steady_clock::now();
-            double updateMs = std::chrono::duration<double, std::milli>(updateEnd - updateStart).count();
-            recordSample(updateStats, updateMs, "metrics.update()");
-            #endif
+            if (governor) {
+                governor->observe(metrics, subsystems, interval);
+                display.setGovernorStatus(governor->budget(), governor->status());
+            }
+            if (recorder && !recorder->record(metrics)) {
+                std::cerr << "Recording to " << recorder->path() << " failed, disabling" << std::endl;
+                recorder.reset();
+            }
+            if (agent) {
+                agent->send(hostSnapshotFrom(metrics));
+            }
+            if (alerts) {
+                evaluateAlerts(*alerts, metrics, wallClockMs());
+                display.setAlertedMeters(alerts->engine.activeMeters());
+            }
             lastUpdate = now;
             needsRender = true;
+            if (firstFrame) {
+                startup.mark("sample");
+            }
+        }
+        
+        if (resizePending && (now - lastResizeEvent >= resizeDebounce ||
+                              now - firstResizeEvent >= resizeMaxDelay)) {
+            display.handleResize(0, 0);
+            resizePending = false;
+            needsRender = true;
         }
         
-        if (needsRender) {
-            #ifdef OSXVIEW_PROFILE
-            auto renderStart = std::chrono::steady_clock::now();
-            #endif
+        if (needsRender && windowVisible) {
+            TRACE_SCOPE("main.frame");
             display.beginFrame();
-            display.draw(metrics);
+            if (receiver) {
+                display.drawCluster(receiver->hosts());
+            } else {
+                display.draw(metrics);
+            }
             display.endFrame();
-            #ifdef OSXVIEW_PROFILE
-            auto renderEnd = std::chrono::steady_clock::now();
-            double renderMs = std::chrono::duration<double, std::milli>(renderEnd - renderStart).count();
-            recordSample(renderStats, renderMs, "display frame");
-            #endif
             needsRender = false;
+            if (firstFrame) {
+                firstFrame = false;
+                startup.mark("frame");
+                if (startupReport) {
+                    startup.printFirstFrame();
+                }
+            }
+        }
+        if (startupReport && !collectorsReported && !firstFrame && metrics.pendingSubsystems() == 0) {
+            collectorsReported = true;
+            startup.printCollectorsReady();
         }
         
-        auto nextUpdateTime = lastUpdate + updateInterval;
+        auto nextUpdateTime = lastUpdate + interval;
         auto timeToNextUpdate = nextUpdateTime - std::chrono::steady_clock::now();
         int waitMs = 0;
         if (timeToNextUpdate > std::chrono::milliseconds::zero()) {
             waitMs = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(timeToNextUpdate).count());
         }
-        
+        if (resizePending) {
+            const auto resizeDue = std::min(lastResizeEvent + resizeDebounce, firstResizeEvent + resizeMaxDelay);
+            const auto timeToResize = std::chrono::duration_cast<std::chrono::milliseconds>(
+                resizeDue - std::chrono::steady_clock::now()).count();
+            waitMs = std::max(0, std::min(waitMs, static_cast<int>(timeToResize) + 1));
+        }
         SDL_Event event;
-        if (SDL_WaitEventTimeout(&event, waitMs)) {
+        bool haveEvent = false;
+        if (receiver && !windowVisible) {
+            // Nothing to draw: sleep on the sockets as long as the local
+            // path would sleep on events, then take the window events that
+            // came in meanwhile (a shown window waits for this wakeup)
+            receiver->poll(waitMs);
+            haveEvent = SDL_PollEvent(&event);
+        } else {
+            if (receiver) {
+                // Keep socket buffers drained between frames
+                waitMs = std::min(waitMs, 10);
+            }
+            haveEvent = SDL_WaitEventTimeout(&event, waitMs);
+        }
+        if (haveEvent) {
             handleEvent(event);
             
             // Flush any additional queued events without spinning
@@ -154,6 +676,10 @@ int main() {
     }
     
     std::cout << "\nShutting down OSXview..." << std::endl;
+    if (recorder) {
+        recorder->close();
+    }
+    finishTrace(tracePath);
     
     return 0;
 }
\ No newline at end of file
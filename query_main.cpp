@@ -0,0 +1,698 @@
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fnmatch.h>
+#include <fcntl.h>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <tuple>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+#include "RecordingFormat.h"
+
+// osxview-query: offline statistics over files written with --record.
+//
+//   osxview-query --series 'cpu*.user' --from '2024-05-14 14:00' --to '2024-05-14 15:00'
+//                 --stats min,max,mean,p99 [--step 60] [--format csv|json] host-a.oxv host-b.oxv
+//
+// Files are mmap'd, the block index selects the blocks overlapping the time
+// range, and (file, block) work items are decoded in parallel. Cumulative
+// counters are reported as per-second rates (--raw keeps the stored values);
+// every other series, integer levels included, as stored. Percentiles come
+// from a fixed-precision histogram rather than the samples themselves, so
+// memory does not grow with the time range.
+
+namespace {
+
+struct MappedFile {
+    std::string path;
+    std::string host;
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    RecordingReader reader;
+    std::vector<size_t> selectedSeries;
+};
+
+struct Options {
+    std::vector<std::string> files;
+    std::vector<std::string> seriesPatterns;
+    std::vector<std::string> stats{"count", "min", "max", "mean", "p50", "p90", "p99"};
+    int64_t fromMs = std::numeric_limits<int64_t>::min();
+    int64_t toMs = std::numeric_limits<int64_t>::max();
+    int64_t stepMs = 0;
+    bool json = false;
+    bool raw = false;
+    unsigned threads = 0;
+};
+
+// Log-linear histogram keyed on the double's own bits: sign, exponent and the
+// top 7 mantissa bits, so a bucket spans under 1/128 of its values and the
+// bucket count grows with the range of the values, never with their number.
+class QuantileSketch {
+public:
+    void add(double value) {
+        buckets_[keyFor(value)]++;
+    }
+
+    void merge(const QuantileSketch& other) {
+        for (const auto& [key, count] : other.buckets_) {
+            buckets_[key] += count;
+        }
+    }
+
+    // Nearest rank, answered with the middle of the bucket holding it
+    double quantile(double fraction, uint64_t count) const {
+        std::vector<std::pair<int32_t, uint64_t>> sorted(buckets_.begin(), buckets_.end());
+        std::sort(sorted.begin(), sorted.end());
+        const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(count))));
+        uint64_t seen = 0;
+        for (const auto& [key, bucketCount] : sorted) {
+            seen += bucketCount;
+            if (seen >= rank) {
+                return valueFor(key);
+            }
+        }
+        return sorted.empty() ? NAN : valueFor(sorted.back().first);
+    }
+
+private:
+    static const int MANTISSA_BITS = 7;
+    static const int SHIFT = 52 - MANTISSA_BITS;
+
+    // Magnitudes order like their bit patterns; negatives mirror below zero
+    static int32_t keyFor(double value) {
+        const int32_t magnitude = static_cast<int32_t>(std::bit_cast<uint64_t>(std::fabs(value)) >> SHIFT);
+        return value < 0.0 ? -magnitude - 1 : magnitude;
+    }
+
+    static double valueFor(int32_t key) {
+        const bool negative = key < 0;
+        const uint64_t magnitude = static_cast<uint64_t>(negative ? -(static_cast<int64_t>(key) + 1) : key);
+        if (magnitude == 0) {
+            return 0.0;
+        }
+        const double lower = std::bit_cast<double>(magnitude << SHIFT);
+        const double upper = std::bit_cast<double>((magnitude + 1) << SHIFT);
+        const double middle = lower + (upper - lower) / 2.0;
+        return negative ? -middle : middle;
+    }
+
+    std::unordered_map<int32_t, uint64_t> buckets_;
+};
+
+struct Accumulator {
+    uint64_t count = 0;
+    double sum = 0.0;
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+    QuantileSketch sketch;
+
+    void add(double value, bool quantiles) {
+        count++;
+        sum += value;
+        min = std::min(min, value);
+        max = std::max(max, value);
+        if (quantiles) {
+            sketch.add(value);
+        }
+    }
+
+    void merge(const Accumulator& other) {
+        count += other.count;
+        sum += other.sum;
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+        sketch.merge(other.sketch);
+    }
+
+    // The extremes are exact; bucket midpoints can fall just outside them
+    double quantile(double fraction) const {
+        if (fraction <= 0.0 || fraction >= 1.0) {
+            return fraction <= 0.0 ? min : max;
+        }
+        return std::clamp(sketch.quantile(fraction, count), min, max);
+    }
+};
+
+// Buckets keyed by start time, one map per (file, selected series) slot.
+using BucketMap = std::map<int64_t, Accumulator>;
+
+struct WorkItem {
+    size_t file;
+    size_t block;
+};
+
+// The first and last sample of a counter within one block. A block decodes
+// on its own, so the rate across two neighbouring blocks is added after the
+// workers finish, from the last sample of one and the first of the next.
+struct BlockEdge {
+    size_t file;
+    size_t slot;
+    size_t block;
+    bool hasFirst = false;   // first sample is in range and has no predecessor in the block
+    int64_t firstMs = 0;
+    double first = 0.0;
+    bool hasLast = false;
+    int64_t lastMs = 0;
+    double last = 0.0;
+};
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [options] <recording>...\n"
+              << "  --series <pattern>   series name or glob (repeatable, default: all)\n"
+              << "  --from <time>        start time (epoch s/ms, 'YYYY-MM-DD[ HH:MM[:SS]]' or -1h/-30m/-2d)\n"
+              << "  --to <time>          end time (same formats, exclusive)\n"
+              << "  --stats <list>       comma list of count,min,max,mean,pNN (default count,min,max,mean,p50,p90,p99)\n"
+              << "  --step <seconds>     downsample into buckets of this width\n"
+              << "  --format csv|json    output format (default csv)\n"
+              << "  --threads <n>        decoder threads (default: hardware concurrency)\n"
+              << "  --raw                report cumulative counters as stored instead of per-second rates\n"
+              << "                       (other series, levels and per-interval values, are always as stored)\n"
+              << "  --list               list series and time range of each file\n";
+}
+
+bool parseTime(const std::string& text, int64_t& outMs) {
+    if (text.empty()) {
+        return false;
+    }
+
+    const int64_t nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    if (text == "now") {
+        outMs = nowMs;
+        return true;
+    }
+
+    if (text[0] == '-' && text.size() > 2) {
+        char* end = nullptr;
+        const double amount = std::strtod(text.c_str() + 1, &end);
+        int64_t unitMs = 0;
+        switch (end ? *end : '\0') {
+            case 's': unitMs = 1000; break;
+            case 'm': unitMs = 60 * 1000; break;
+            case 'h': unitMs = 3600 * 1000; break;
+            case 'd': unitMs = 24 * 3600 * 1000; break;
+            default: return false;
+        }
+        outMs = nowMs - static_cast<int64_t>(amount * static_cast<double>(unitMs));
+        return true;
+    }
+
+    if (std::all_of(text.begin(), text.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+        const int64_t value = std::strtoll(text.c_str(), nullptr, 10);
+        // Values below 1e11 are taken as seconds (1e11 s is the year 5138)
+        outMs = value < 100000000000LL ? value * 1000 : value;
+        return true;
+    }
+
+    const char* formats[] = {"%Y-%m-%d %H:%M:%S", "%Y-%m-%dT%H:%M:%S", "%Y-%m-%d %H:%M",
+                             "%Y-%m-%dT%H:%M", "%Y-%m-%d"};
+    for (const char* format : formats) {
+        std::tm tm{};
+        const char* end = strptime(text.c_str(), format, &tm);
+        if (end && *end == '\0') {
+            tm.tm_isdst = -1;
+            const std::time_t seconds = std::mktime(&tm);
+            if (seconds == static_cast<std::time_t>(-1)) {
+                return false;
+            }
+            outMs = static_cast<int64_t>(seconds) * 1000;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<std::string> splitList(const std::string& text) {
+    std::vector<std::string> parts;
+    size_t start = 0;
+    while (start <= text.size()) {
+        size_t comma = text.find(',', start);
+        if (comma == std::string::npos) {
+            comma = text.size();
+        }
+        if (comma > start) {
+            parts.push_back(text.substr(start, comma - start));
+        }
+        start = comma + 1;
+    }
+    return parts;
+}
+
+bool parsePercentile(const std::string& stat, double& outFraction) {
+    if (stat.size() < 2 || stat[0] != 'p') {
+        return false;
+    }
+    char* end = nullptr;
+    const double value = std::strtod(stat.c_str() + 1, &end);
+    if (!end || *end != '\0' || value < 0.0 || value > 100.0) {
+        return false;
+    }
+    outFraction = value / 100.0;
+    return true;
+}
+
+bool mapFile(MappedFile& file) {
+    const int fd = ::open(file.path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+    void* mapping = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+    madvise(mapping, static_cast<size_t>(st.st_size), MADV_WILLNEED);
+    file.data = static_cast<const uint8_t*>(mapping);
+    file.size = static_cast<size_t>(st.st_size);
+    return true;
+}
+
+void unmapFile(MappedFile& file) {
+    if (file.data) {
+        munmap(const_cast<uint8_t*>(file.data), file.size);
+        file.data = nullptr;
+    }
+}
+
+std::string hostFromPath(const std::string& path) {
+    size_t slash = path.find_last_of('/');
+    std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+    size_t dot = name.find('.');
+    return dot == std::string::npos || dot == 0 ? name : name.substr(0, dot);
+}
+
+int64_t bucketStart(const Options& options, int64_t timestampMs) {
+    if (options.stepMs <= 0) {
+        return 0;
+    }
+    return timestampMs - ((timestampMs % options.stepMs) + options.stepMs) % options.stepMs;
+}
+
+// Only cumulative counters become rates; levels, per-interval deltas and
+// rates already are what they show (a rate of mem.used means nothing)
+bool reportsRate(const Options& options, const SeriesInfo& info) {
+    return !options.raw && info.kind == SeriesKind::Counter;
+}
+
+std::string formatTimestamp(int64_t ms) {
+    const std::time_t seconds = static_cast<std::time_t>(ms / 1000);
+    std::tm tm{};
+    localtime_r(&seconds, &tm);
+    char buffer[32];
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &tm);
+    return buffer;
+}
+
+std::string formatNumber(double value) {
+    if (!std::isfinite(value)) {
+        return "";
+    }
+    char buffer[64];
+    std::snprintf(buffer, sizeof(buffer), "%.6g", value);
+    return buffer;
+}
+
+std::string jsonEscape(const std::string& text) {
+    std::string out;
+    out.reserve(text.size());
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out.push_back('\\');
+        }
+        out.push_back(c);
+    }
+    return out;
+}
+
+// Decodes one (file, block) work item into the worker's private buckets and
+// returns the encoded bytes of the columns it decoded.
+uint64_t decodeItem(const Options& options, std::vector<MappedFile>& files, const WorkItem& item,
+                    bool quantiles, std::vector<std::vector<BucketMap>>& buckets, std::vector<BlockEdge>& edges,
+                    std::vector<int64_t>& timestamps, std::vector<double>& column) {
+    MappedFile& file = files[item.file];
+    if (!file.reader.decodeTimestamps(item.block, timestamps)) {
+        return 0;
+    }
+    uint64_t decodedBytes = file.reader.columnBytes(item.block, 0);
+
+    // Timestamps are monotonic within a block, so the range is one slice
+    const auto first = std::lower_bound(timestamps.begin(), timestamps.end(), options.fromMs);
+    const auto last = std::lower_bound(first, timestamps.end(), options.toMs);
+    const size_t begin = static_cast<size_t>(first - timestamps.begin());
+    const size_t end = static_cast<size_t>(last - timestamps.begin());
+    if (begin >= end) {
+        return decodedBytes;
+    }
+
+    for (size_t slot = 0; slot < file.selectedSeries.size(); ++slot) {
+        const size_t series = file.selectedSeries[slot];
+        if (!file.reader.decodeColumn(item.block, series, column)) {
+            continue;
+        }
+        decodedBytes += file.reader.columnBytes(item.block, series + 1);
+
+        BucketMap& seriesBuckets = buckets[item.file][slot];
+        Accumulator* current = nullptr;
+        int64_t currentBucket = 0;
+        auto add = [&](int64_t timestampMs, double value) {
+            const int64_t bucket = bucketStart(options, timestampMs);
+            if (!current || bucket != currentBucket) {
+                current = &seriesBuckets[bucket];
+                currentBucket = bucket;
+            }
+            current->add(value, quantiles);
+        };
+
+        if (!reportsRate(options, file.reader.series()[series])) {
+            for (size_t i = begin; i < end; ++i) {
+                if (!std::isnan(column[i])) {
+                    add(timestamps[i], column[i]);
+                }
+            }
+            continue;
+        }
+
+        // Counters: the change per second since the previous sample, which
+        // may lie before the range
+        BlockEdge edge{item.file, slot, item.block};
+        size_t previous = SIZE_MAX;
+        for (size_t i = 0; i < end; ++i) {
+            if (std::isnan(column[i])) {
+                continue;
+            }
+            if (i >= begin) {
+                if (previous == SIZE_MAX) {
+                    edge.hasFirst = true;
+                    edge.firstMs = timestamps[i];
+                    edge.first = column[i];
+                } else if (timestamps[i] > timestamps[previous]) {
+                    add(timestamps[i], (column[i] - column[previous]) * 1000.0 /
+                                       static_cast<double>(timestamps[i] - timestamps[previous]));
+                }
+            }
+            previous = i;
+        }
+        if (previous != SIZE_MAX && end == timestamps.size()) {
+            edge.hasLast = true;
+            edge.lastMs = timestamps[previous];
+            edge.last = column[previous];
+        }
+        if (edge.hasFirst || edge.hasLast) {
+            edges.push_back(edge);
+        }
+    }
+    return decodedBytes;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    bool listOnly = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto next = [&]() -> const char* { return i + 1 < argc ? argv[++i] : nullptr; };
+
+        if (arg == "--series") {
+            const char* value = next();
+            if (!value) { printUsage(argv[0]); return 1; }
+            for (const auto& pattern : splitList(value)) {
+                options.seriesPatterns.push_back(pattern);
+            }
+        } else if (arg == "--from" || arg == "--to") {
+            const char* value = next();
+            int64_t ms = 0;
+            if (!value || !parseTime(value, ms)) {
+                std::cerr << "Invalid time for " << arg << std::endl;
+                return 1;
+            }
+            (arg == "--from" ? options.fromMs : options.toMs) = ms;
+        } else if (arg == "--stats") {
+            const char* value = next();
+            if (!value) { printUsage(argv[0]); return 1; }
+            options.stats = splitList(value);
+        } else if (arg == "--step") {
+            const char* value = next();
+            if (!value || std::atof(value) <= 0.0) { printUsage(argv[0]); return 1; }
+            options.stepMs = static_cast<int64_t>(std::atof(value) * 1000.0);
+        } else if (arg == "--format") {
+            const char* value = next();
+            if (!value || (std::strcmp(value, "csv") != 0 && std::strcmp(value, "json") != 0)) {
+                printUsage(argv[0]);
+                return 1;
+            }
+            options.json = std::strcmp(value, "json") == 0;
+        } else if (arg == "--threads") {
+            const char* value = next();
+            if (!value) { printUsage(argv[0]); return 1; }
+            options.threads = static_cast<unsigned>(std::max(1, std::atoi(value)));
+        } else if (arg == "--raw") {
+            options.raw = true;
+        } else if (arg == "--list") {
+            listOnly = true;
+        } else if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            return 0;
+        } else if (!arg.empty() && arg[0] == '-') {
+            printUsage(argv[0]);
+            return 1;
+        } else {
+            options.files.push_back(arg);
+        }
+    }
+
+    if (options.files.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    bool quantiles = false;
+    for (const auto& stat : options.stats) {
+        double fraction = 0.0;
+        if (parsePercentile(stat, fraction)) {
+            quantiles = true;
+        } else if (stat != "count" && stat != "min" && stat != "max" && stat != "mean" && stat != "sum") {
+            std::cerr << "Unknown statistic: " << stat << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<MappedFile> files(options.files.size());
+    for (size_t f = 0; f < files.size(); ++f) {
+        MappedFile& file = files[f];
+        file.path = options.files[f];
+        file.host = hostFromPath(file.path);
+        if (!mapFile(file) || !file.reader.open(file.data, file.size)) {
+            std::cerr << "Failed to open recording " << file.path << std::endl;
+            return 1;
+        }
+
+        const auto& series = file.reader.series();
+        for (size_t s = 0; s < series.size(); ++s) {
+            bool selected = options.seriesPatterns.empty();
+            for (const auto& pattern : options.seriesPatterns) {
+                if (fnmatch(pattern.c_str(), series[s].name.c_str(), 0) == 0) {
+                    selected = true;
+                    break;
+                }
+            }
+            if (selected) {
+                file.selectedSeries.push_back(s);
+            }
+        }
+    }
+
+    if (listOnly) {
+        for (auto& file : files) {
+            const auto& blocks = file.reader.blocks();
+            std::cout << file.path << ": " << file.reader.series().size() << " series, "
+                      << blocks.size() << " blocks" << (file.reader.hasIndex() ? "" : " (no index, scanned)");
+            if (!blocks.empty()) {
+                std::cout << ", " << formatTimestamp(blocks.front().firstTimestamp)
+                          << " .. " << formatTimestamp(blocks.back().lastTimestamp);
+            }
+            std::cout << "\n";
+            for (size_t s : file.selectedSeries) {
+                const auto& info = file.reader.series()[s];
+                const char* kind = info.kind == SeriesKind::Counter ? " (counter)"
+                                   : info.kind == SeriesKind::Fixed ? " (gauge, 0.01)"
+                                   : info.kind == SeriesKind::Integer ? " (integer)" : " (gauge)";
+                std::cout << "  " << info.name << kind << "\n";
+            }
+            unmapFile(file);
+        }
+        return 0;
+    }
+
+    // The index is sorted by time, so a binary search finds the first block
+    // that can overlap the range and the scan stops at the first one past it.
+    std::vector<WorkItem> items;
+    for (size_t f = 0; f < files.size(); ++f) {
+        const auto& blocks = files[f].reader.blocks();
+        auto it = std::lower_bound(blocks.begin(), blocks.end(), options.fromMs,
+                                   [](const BlockIndexEntry& entry, int64_t from) {
+                                       return entry.lastTimestamp < from;
+                                   });
+        for (; it != blocks.end() && it->firstTimestamp < options.toMs; ++it) {
+            items.push_back({f, static_cast<size_t>(it - blocks.begin())});
+        }
+    }
+
+    unsigned threadCount = options.threads ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    threadCount = static_cast<unsigned>(std::min<size_t>(threadCount, std::max<size_t>(1, items.size())));
+
+    using WorkerBuckets = std::vector<std::vector<BucketMap>>;
+    std::vector<WorkerBuckets> workerBuckets(threadCount);
+    for (auto& buckets : workerBuckets) {
+        buckets.resize(files.size());
+        for (size_t f = 0; f < files.size(); ++f) {
+            buckets[f].resize(files[f].selectedSeries.size());
+        }
+    }
+
+    const auto scanStart = std::chrono::steady_clock::now();
+    std::atomic<size_t> nextItem{0};
+    std::atomic<uint64_t> bytesScanned{0};
+    std::vector<std::vector<BlockEdge>> workerEdges(threadCount);
+    auto worker = [&](unsigned index) {
+        std::vector<int64_t> timestamps;
+        std::vector<double> column;
+        uint64_t scanned = 0;
+        for (size_t i = nextItem.fetch_add(1); i < items.size(); i = nextItem.fetch_add(1)) {
+            scanned += decodeItem(options, files, items[i], quantiles, workerBuckets[index], workerEdges[index],
+                                  timestamps, column);
+        }
+        bytesScanned += scanned;
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 1; t < threadCount; ++t) {
+        threads.emplace_back(worker, t);
+    }
+    worker(0);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    const double scanSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - scanStart).count();
+
+    // Merge every worker into worker 0
+    WorkerBuckets& merged = workerBuckets[0];
+    for (unsigned t = 1; t < threadCount; ++t) {
+        for (size_t f = 0; f < files.size(); ++f) {
+            for (size_t slot = 0; slot < merged[f].size(); ++slot) {
+                for (auto& kv : workerBuckets[t][f][slot]) {
+                    merged[f][slot][kv.first].merge(kv.second);
+                }
+            }
+        }
+    }
+
+    // Counter rates across the block boundaries the workers could not see
+    std::vector<BlockEdge> edges;
+    for (auto& list : workerEdges) {
+        edges.insert(edges.end(), list.begin(), list.end());
+    }
+    std::sort(edges.begin(), edges.end(), [](const BlockEdge& a, const BlockEdge& b) {
+        return std::tie(a.file, a.slot, a.block) < std::tie(b.file, b.slot, b.block);
+    });
+    for (size_t e = 1; e < edges.size(); ++e) {
+        const BlockEdge& before = edges[e - 1];
+        const BlockEdge& after = edges[e];
+        if (before.file == after.file && before.slot == after.slot && before.block + 1 == after.block &&
+            before.hasLast && after.hasFirst && after.firstMs > before.lastMs) {
+            const double rate = (after.first - before.last) * 1000.0 / static_cast<double>(after.firstMs - before.lastMs);
+            merged[after.file][after.slot][bucketStart(options, after.firstMs)].add(rate, quantiles);
+        }
+    }
+
+    auto statValue = [](const Accumulator& acc, const std::string& stat) -> double {
+        double fraction = 0.0;
+        if (stat == "count") return static_cast<double>(acc.count);
+        if (acc.count == 0) return NAN;
+        if (stat == "min") return acc.min;
+        if (stat == "max") return acc.max;
+        if (stat == "sum") return acc.sum;
+        if (stat == "mean") return acc.sum / static_cast<double>(acc.count);
+        if (parsePercentile(stat, fraction)) return acc.quantile(fraction);
+        return NAN;
+    };
+
+    if (options.json) {
+        std::cout << "[";
+    } else {
+        std::cout << "host,series" << (options.stepMs > 0 ? ",time" : "");
+        for (const auto& stat : options.stats) {
+            std::cout << "," << stat;
+        }
+        std::cout << "\n";
+    }
+
+    bool firstRow = true;
+    for (size_t f = 0; f < files.size(); ++f) {
+        for (size_t slot = 0; slot < merged[f].size(); ++slot) {
+            const SeriesInfo& info = files[f].reader.series()[files[f].selectedSeries[slot]];
+            const std::string name = reportsRate(options, info) ? "rate(" + info.name + ")" : info.name;
+            for (auto& kv : merged[f][slot]) {
+                if (options.json) {
+                    std::cout << (firstRow ? "\n" : ",\n")
+                              << "  {\"host\": \"" << jsonEscape(files[f].host)
+                              << "\", \"series\": \"" << jsonEscape(name) << "\"";
+                    if (options.stepMs > 0) {
+                        std::cout << ", \"time\": " << kv.first;
+                    }
+                    for (const auto& stat : options.stats) {
+                        const std::string value = formatNumber(statValue(kv.second, stat));
+                        std::cout << ", \"" << jsonEscape(stat) << "\": " << (value.empty() ? "null" : value);
+                    }
+                    std::cout << "}";
+                } else {
+                    std::cout << files[f].host << "," << name;
+                    if (options.stepMs > 0) {
+                        std::cout << "," << formatTimestamp(kv.first);
+                    }
+                    for (const auto& stat : options.stats) {
+                        std::cout << "," << formatNumber(statValue(kv.second, stat));
+                    }
+                    std::cout << "\n";
+                }
+                firstRow = false;
+            }
+        }
+    }
+    if (options.json) {
+        std::cout << (firstRow ? "]\n" : "\n]\n");
+    }
+
+    const double scannedMB = static_cast<double>(bytesScanned.load()) / (1024.0 * 1024.0);
+    std::cerr << "Decoded " << items.size() << " blocks (" << formatNumber(scannedMB) << " MB of selected columns) in "
+              << formatNumber(scanSeconds * 1000.0) << " ms on " << threadCount << " threads";
+    if (scanSeconds > 0.0) {
+        std::cerr << ", " << formatNumber(scannedMB / scanSeconds) << " MB/s";
+    }
+    std::cerr << std::endl;
+
+    for (auto& file : files) {
+        unmapFile(file);
+    }
+    return 0;
+}
@@ -0,0 +1,132 @@
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "MetricStream.h"
+
+// Reference subscriber for `OSXview --daemon`:
+//
+//   osxview-subscribe <socket> [--series name,name...] [--count N] [--slow MS]
+//
+// Prints one line per delta frame with the number of fields it carried and
+// the current value of each requested series. --slow sleeps between reads
+// to show the daemon coalescing samples for a lagging reader.
+
+namespace {
+
+std::vector<std::string> splitList(const std::string& text) {
+    std::vector<std::string> items;
+    size_t start = 0;
+    while (start <= text.size()) {
+        const size_t comma = text.find(',', start);
+        const size_t end = comma == std::string::npos ? text.size() : comma;
+        if (end > start) {
+            items.push_back(text.substr(start, end - start));
+        }
+        start = end + 1;
+    }
+    return items;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string path;
+    std::vector<std::string> names;
+    long count = -1;
+    int slowMs = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--series") == 0 && i + 1 < argc) {
+            names = splitList(argv[++i]);
+        } else if (std::strcmp(argv[i], "--count") == 0 && i + 1 < argc) {
+            count = std::atol(argv[++i]);
+        } else if (std::strcmp(argv[i], "--slow") == 0 && i + 1 < argc) {
+            slowMs = std::max(0, std::atoi(argv[++i]));
+        } else if (argv[i][0] != '-' && path.empty()) {
+            path = argv[i];
+        } else {
+            path.clear();
+            break;
+        }
+    }
+    if (path.empty()) {
+        std::cerr << "Usage: " << argv[0] << " <socket> [--series name,name...] [--count N] [--slow MS]" << std::endl;
+        return 1;
+    }
+
+    sockaddr_un address{};
+    if (path.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Socket path too long" << std::endl;
+        return 1;
+    }
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        std::cerr << "Failed to connect to " << path << ": " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+
+    MetricStreamDecoder decoder;
+    size_t schemaSize = 0;
+    std::vector<int> columns;
+    uint64_t bytes = 0;
+    uint8_t buffer[1 << 16];
+    for (long frames = 0; count < 0 || frames < count;) {
+        const ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n <= 0) {
+            break;
+        }
+        bytes += static_cast<uint64_t>(n);
+        if (!decoder.feed(buffer, static_cast<size_t>(n))) {
+            std::cerr << "Malformed stream" << std::endl;
+            return 1;
+        }
+        if (!decoder.takeUpdate()) {
+            continue;
+        }
+
+        if (decoder.series().size() != schemaSize) {
+            schemaSize = decoder.series().size();
+            columns.clear();
+            for (const std::string& name : names) {
+                int column = -1;
+                for (size_t s = 0; s < schemaSize; ++s) {
+                    if (decoder.series()[s].name == name) {
+                        column = static_cast<int>(s);
+                    }
+                }
+                columns.push_back(column);
+            }
+            std::printf("schema: %zu series\n", schemaSize);
+        }
+
+        std::printf("#%llu %zu changed, %llu skipped, %llu bytes",
+                    static_cast<unsigned long long>(decoder.sequence()), decoder.lastChangeCount(),
+                    static_cast<unsigned long long>(decoder.gaps()), static_cast<unsigned long long>(bytes));
+        for (size_t i = 0; i < names.size(); ++i) {
+            const double value = columns[i] >= 0 ? decoder.values()[static_cast<size_t>(columns[i])] : NAN;
+            std::printf("  %s=%g", names[i].c_str(), value);
+        }
+        std::printf("\n");
+        std::fflush(stdout);
+        ++frames;
+
+        if (slowMs > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(slowMs));
+        }
+    }
+    close(fd);
+    return 0;
+}